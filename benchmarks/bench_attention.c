@@ -0,0 +1,95 @@
+// Attention core softmax(Q K^T / sqrt(d)) V at growing sequence lengths: the
+// materialized version (full seq x seq score matrix, one GEMM per step) against
+// the tiled flash_attention_f32, which only keeps one score tile per thread.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_attention benchmarks/bench_attention.c src/*.c -lm -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "../include/attention.h"
+#include "../include/gemm.h"
+#include "../include/utils.h"
+
+#define HEAD_DIM 64
+#define MATERIALIZED_LIMIT 8192  // Past this the score matrix alone needs > 256 MB
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// The attention computation this benchmark is measured against
+static int materialized_attention(int seq, const float *Q, const float *K, const float *V, float *O) {
+    float* scores = malloc((size_t)seq * seq * sizeof(float));
+    if(scores == NULL) return 0;
+
+    gemm_f32(GEMM_NO_TRANS, GEMM_TRANS, seq, seq, HEAD_DIM,
+             1.0f / sqrtf((float)HEAD_DIM), Q, HEAD_DIM, K, HEAD_DIM, 0.0f, scores, seq);
+    for(int i = 0; i < seq; i++) {
+        softmax_float(scores + (size_t)i * seq, scores + (size_t)i * seq, seq);
+    }
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, seq, HEAD_DIM, seq,
+             1.0f, scores, seq, V, HEAD_DIM, 0.0f, O, HEAD_DIM);
+
+    free(scores);
+    return 1;
+}
+
+int main() {
+    int lengths[] = {128, 1024, 4096, 16384};
+    int num_lengths = sizeof(lengths) / sizeof(lengths[0]);
+    int max_seq = lengths[num_lengths - 1];
+
+    float* Q = malloc((size_t)max_seq * HEAD_DIM * sizeof(float));
+    float* K = malloc((size_t)max_seq * HEAD_DIM * sizeof(float));
+    float* V = malloc((size_t)max_seq * HEAD_DIM * sizeof(float));
+    float* O = malloc((size_t)max_seq * HEAD_DIM * sizeof(float));
+    for(size_t i = 0; i < (size_t)max_seq * HEAD_DIM; i++) {
+        Q[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+        K[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+        V[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+
+    printf("attention, head_dim %d, %d thread(s)\n", HEAD_DIM, gemm_get_num_threads());
+    printf("  %8s %16s %16s %14s %14s\n", "seq", "materialized ms", "flash ms", "scores MB", "flash tile KB");
+
+    for(int l = 0; l < num_lengths; l++) {
+        int seq = lengths[l];
+        int iterations = seq <= 1024 ? 20 : 2;
+        double materialized_ms = -1.0;
+
+        if(seq <= MATERIALIZED_LIMIT) {
+            double start = now_seconds();
+            for(int it = 0; it < iterations; it++) {
+                materialized_attention(seq, Q, K, V, O);
+            }
+            materialized_ms = (now_seconds() - start) * 1e3 / iterations;
+        }
+
+        double start = now_seconds();
+        for(int it = 0; it < iterations; it++) {
+            flash_attention_f32(seq, seq, HEAD_DIM, 1.0f / sqrtf((float)HEAD_DIM),
+                                Q, HEAD_DIM, K, HEAD_DIM, V, HEAD_DIM, O, HEAD_DIM, 0);
+        }
+        double flash_ms = (now_seconds() - start) * 1e3 / iterations;
+
+        if(materialized_ms >= 0.0) {
+            printf("  %8d %16.3f", seq, materialized_ms);
+        } else {
+            printf("  %8d %16s", seq, "skipped");
+        }
+        printf(" %16.3f %14.1f %14.1f\n", flash_ms, (double)seq * seq * sizeof(float) / (1 << 20),
+               ATTENTION_Q_BLOCK * ATTENTION_KV_BLOCK * sizeof(float) / 1024.0);
+    }
+
+    free(Q);
+    free(K);
+    free(V);
+    free(O);
+    return 0;
+}
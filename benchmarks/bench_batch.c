@@ -0,0 +1,76 @@
+// Throughput of a minibatch of short sequences through attention and the feed
+// forward block: one call per sequence against one batched call whose linear
+// layers see the whole [batch, seq, dim] tensor as a single GEMM.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_batch benchmarks/bench_batch.c src/*.c -lm -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/self_attention_layer.h"
+#include "../include/tensor.h"
+
+#define BATCH 32
+#define SEQ 16
+#define NUM_HEADS 8
+#define FF_DIM 2048
+#define ITERATIONS 10
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main() {
+    SelfAttentionLayer* attention = create_multi_head_attention_layer(EMBEDDING_DIM, NUM_HEADS, SEQ);
+    FeedForwardBlock* ff = create_feed_forward_block(EMBEDDING_DIM, FF_DIM, SEQ);
+    BatchTensor* input = create_batch_tensor(BATCH, SEQ, EMBEDDING_DIM);
+    BatchTensor* hidden = create_batch_tensor(BATCH, SEQ, EMBEDDING_DIM);
+    BatchTensor* output = create_batch_tensor(BATCH, SEQ, EMBEDDING_DIM);
+    if(attention == NULL || ff == NULL || input == NULL || hidden == NULL || output == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    for(int b = 0; b < BATCH; b++) {
+        batch_tensor_set_length(input, b, SEQ);
+    }
+    for(size_t i = 0; i < (size_t)BATCH * SEQ * EMBEDDING_DIM; i++) {
+        input->data[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+
+    // Warm up both paths so workspaces are sized before timing
+    self_attention_forward_batch(attention, input, hidden);
+    feed_forward_block_forward_batch(ff, hidden, output);
+
+    double start = now_seconds();
+    for(int it = 0; it < ITERATIONS; it++) {
+        for(int b = 0; b < BATCH; b++) {
+            self_attention_forward(attention, batch_tensor_row(input, b, 0), batch_tensor_row(hidden, b, 0), SEQ);
+            feed_forward_block_forward(ff, batch_tensor_row(hidden, b, 0), batch_tensor_row(output, b, 0), SEQ, NULL);
+        }
+    }
+    double per_sequence_ms = (now_seconds() - start) * 1e3 / ITERATIONS;
+
+    start = now_seconds();
+    for(int it = 0; it < ITERATIONS; it++) {
+        self_attention_forward_batch(attention, input, hidden);
+        feed_forward_block_forward_batch(ff, hidden, output);
+    }
+    double batched_ms = (now_seconds() - start) * 1e3 / ITERATIONS;
+
+    double tokens = (double)BATCH * SEQ;
+    printf("attention + feed forward, batch %d x seq %d, dim %d, %d heads\n", BATCH, SEQ, EMBEDDING_DIM, NUM_HEADS);
+    printf("  per sequence: %10.3f ms/batch (%8.0f tokens/s)\n", per_sequence_ms, tokens / per_sequence_ms * 1e3);
+    printf("  batched:      %10.3f ms/batch (%8.0f tokens/s)\n", batched_ms, tokens / batched_ms * 1e3);
+    printf("  speedup: %.2fx\n", per_sequence_ms / batched_ms);
+
+    free_batch_tensor(input);
+    free_batch_tensor(hidden);
+    free_batch_tensor(output);
+    free_feed_forward_block(ff);
+    free_self_attention_layer(attention);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Byte-pair-encoding throughput: learn merges from a synthetic corpus of
+// words built from common English syllables, then encode it and report MB/s.
+// The priority-queue encoder is compared with applying every merge in turn.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_bpe benchmarks/bench_bpe.c src/*.c -lm -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/bpe.h"
+
+#define NUM_SENTENCES 50000
+#define WORDS_PER_SENTENCE 16
+#define VOCAB_SIZE 4096
+#define ITERATIONS 5
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Apply every merge, in rank order, to one word (what a naive encoder does)
+static int naive_encode_word(const BPETokenizer* tokenizer, const char* word, int length, uint32_t* ids) {
+    for (int i = 0; i < length; i++) ids[i] = (unsigned char)word[i];
+    for (int r = 0; r < tokenizer->num_merges && length > 1; r++) {
+        int out = 0;
+        for (int i = 0; i < length; i++) {
+            if (i + 1 < length && ids[i] == tokenizer->merges[r].left && ids[i + 1] == tokenizer->merges[r].right) {
+                ids[out++] = BPE_BYTE_TOKENS + r;
+                i++;
+            } else {
+                ids[out++] = ids[i];
+            }
+        }
+        length = out;
+    }
+    return length;
+}
+
+int main() {
+    const char* syllables[] = {
+        "the", "an", "ing", "er", "re", "on", "at", "en", "nd", "ti", "es", "or", "te", "of", "ed",
+        "is", "it", "al", "ar", "st", "to", "nt", "ng", "se", "ha", "as", "ou", "io", "le", "ve",
+        "co", "me", "de", "hi", "ri", "ro", "ic", "ne", "ea", "ra", "ce", "li", "ch", "ll", "be"
+    };
+    const int num_syllables = sizeof(syllables) / sizeof(syllables[0]);
+
+    char** sentences = (char**)malloc((NUM_SENTENCES + 1) * sizeof(char*));
+    char* text = (char*)malloc((size_t)NUM_SENTENCES * WORDS_PER_SENTENCE * 16);
+    if (sentences == NULL || text == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+
+    srand(42);
+    char* p = text;
+    for (int i = 0; i < NUM_SENTENCES; i++) {
+        sentences[i] = p;
+        for (int w = 0; w < WORDS_PER_SENTENCE; w++) {
+            int parts = 1 + rand() % 4;
+            for (int s = 0; s < parts; s++) {
+                int sy = (rand() % num_syllables) * (rand() % num_syllables) / num_syllables;
+                p += sprintf(p, "%s", syllables[sy]);
+            }
+            *p++ = (w + 1 < WORDS_PER_SENTENCE) ? ' ' : '.';
+        }
+        *p++ = '\0';
+    }
+    sentences[NUM_SENTENCES] = NULL;
+    size_t text_bytes = (size_t)(p - text);
+    double megabytes = text_bytes / 1e6;
+
+    double start = now_seconds();
+    BPETokenizer* tokenizer = bpe_train(sentences, VOCAB_SIZE);
+    double train_ms = (now_seconds() - start) * 1e3;
+    if (tokenizer == NULL) {
+        printf("Training failed\n");
+        return 1;
+    }
+
+    uint32_t* ids = (uint32_t*)malloc(text_bytes * sizeof(uint32_t));
+    long num_ids = 0;
+    start = now_seconds();
+    for (int it = 0; it < ITERATIONS; it++) {
+        num_ids = 0;
+        for (int i = 0; i < NUM_SENTENCES; i++) {
+            num_ids += bpe_encode(tokenizer, sentences[i], ids + num_ids, (long)text_bytes - num_ids);
+        }
+    }
+    double encode_s = (now_seconds() - start) / ITERATIONS;
+
+    // The naive encoder is slow: time it on a slice of the corpus
+    const int naive_sentences = NUM_SENTENCES / 50;
+    size_t naive_bytes = 0;
+    start = now_seconds();
+    for (int i = 0; i < naive_sentences; i++) {
+        const char* cursor = sentences[i];
+        char word[128];
+        int length = 0;
+        for (;; cursor++) {
+            if (*cursor == ' ' || *cursor == '.' || *cursor == '\0') {
+                if (length > 0) naive_encode_word(tokenizer, word, length, ids);
+                length = 0;
+                if (*cursor == '\0') break;
+            } else {
+                word[length++] = *cursor;
+            }
+        }
+        naive_bytes += strlen(sentences[i]) + 1;
+    }
+    double naive_s = now_seconds() - start;
+
+    printf("BPE, %d merges learned from %.1f MB in %.0f ms\n", tokenizer->num_merges, megabytes, train_ms);
+    printf("  encode:       %8.1f MB/s (%ld tokens, %.2f bytes/token)\n",
+           megabytes / encode_s, num_ids, (double)text_bytes / num_ids);
+    printf("  naive encode: %8.1f MB/s\n", naive_bytes / 1e6 / naive_s);
+
+    free(ids);
+    free_bpe_tokenizer(tokenizer);
+    free(sentences);
+    free(text);
+    return 0;
+}
@@ -0,0 +1,143 @@
+// One epoch of attention + feed forward over sentences of mixed length, in
+// batches built three ways: shuffled and padded to MAX_LEN (the fixed shape
+// the training loop used), shuffled and padded to the batch's longest
+// sentence, and drawn by the length-bucketed TokenBatchSampler (include/dataset.h),
+// which groups similar lengths so little padding is left.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_bucketing benchmarks/bench_bucketing.c src/*.c -lm -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/self_attention_layer.h"
+#include "../include/tensor.h"
+#include "../include/dataset.h"
+
+#define NUM_SENTENCES 512
+#define MAX_LEN 128
+#define BATCH 16
+#define NUM_HEADS 8
+#define FF_DIM 1024
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Fill a batch with random token rows, padded to max_seq
+static void fill_batch(BatchTensor* input, const TokenDataset* dataset, const size_t* sentences, int count, int max_seq) {
+    batch_tensor_reshape(input, count, max_seq);
+    for(int b = 0; b < count; b++) {
+        size_t length = token_dataset_sentence_length(dataset, sentences[b]);
+        batch_tensor_set_length(input, b, (int)(length < MAX_LEN ? length : MAX_LEN));
+        for(int i = 0; i < input->lengths[b] * input->dim; i++) {
+            batch_tensor_row(input, b, 0)[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+        }
+    }
+    batch_tensor_clear_padding(input);
+}
+
+// Run one batch through attention and the feed forward block
+static void forward_batch(SelfAttentionLayer* attention, FeedForwardBlock* ff,
+                          BatchTensor* input, BatchTensor* hidden, BatchTensor* output) {
+    batch_tensor_reshape(hidden, input->batch, input->max_seq);
+    batch_tensor_reshape(output, input->batch, input->max_seq);
+    self_attention_forward_batch(attention, input, hidden);
+    feed_forward_block_forward_batch(ff, hidden, output);
+}
+
+int main() {
+    // Sentence lengths: mostly short, with a long tail up to MAX_LEN
+    TokenizedCorpus* corpus = createTokenizedCorpus();
+    char sentence[MAX_LEN * 5 + 1];
+    srand(7);
+    for(int s = 0; s < NUM_SENTENCES; s++) {
+        double u = ((double)rand() + 1.0) / ((double)RAND_MAX + 1.0);
+        size_t length = 4 + (size_t)(-20.0 * log(u));
+        if(length > MAX_LEN) length = MAX_LEN;
+        for(size_t i = 0; i < length; i++) memcpy(sentence + i * 5, "word ", 5);
+        tokenizeText(corpus, sentence, length * 5, TOKENIZE_ADD_WORDS);
+    }
+    TokenDataset* dataset = token_dataset_from_corpus(corpus, (uint32_t)global_token);
+    TokenBatchSampler* sampler = create_token_batch_sampler(dataset, BATCH, MAX_LEN, 1);
+
+    SelfAttentionLayer* attention = create_multi_head_attention_layer(EMBEDDING_DIM, NUM_HEADS, MAX_LEN);
+    FeedForwardBlock* ff = create_feed_forward_block(EMBEDDING_DIM, FF_DIM, MAX_LEN);
+    BatchTensor* input = create_batch_tensor(BATCH, MAX_LEN, EMBEDDING_DIM);
+    BatchTensor* hidden = create_batch_tensor(BATCH, MAX_LEN, EMBEDDING_DIM);
+    BatchTensor* output = create_batch_tensor(BATCH, MAX_LEN, EMBEDDING_DIM);
+    if(dataset == NULL || sampler == NULL || attention == NULL || ff == NULL ||
+       input == NULL || hidden == NULL || output == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+
+    // Shuffled batches, as a sampler without bucketing would draw them
+    size_t shuffled[NUM_SENTENCES];
+    for(int s = 0; s < NUM_SENTENCES; s++) shuffled[s] = (size_t)s;
+    for(int s = NUM_SENTENCES - 1; s > 0; s--) {
+        int j = rand() % (s + 1);
+        size_t tmp = shuffled[s];
+        shuffled[s] = shuffled[j];
+        shuffled[j] = tmp;
+    }
+
+    // Warm up so workspaces are sized before timing
+    fill_batch(input, dataset, shuffled, BATCH, MAX_LEN);
+    forward_batch(attention, ff, input, hidden, output);
+
+    const char* names[3] = { "shuffled, padded to MAX_LEN", "shuffled, padded to batch", "length-bucketed sampler" };
+    double times[3];
+    long rows[3] = { 0, 0, 0 };
+    long tokens = (long)dataset->num_ids;
+
+    for(int mode = 0; mode < 3; mode++) {
+        double elapsed = 0;
+        for(size_t b = 0; b < (size_t)(NUM_SENTENCES + BATCH - 1) / BATCH; b++) {
+            const size_t* sentences = shuffled + b * BATCH;
+            size_t count = NUM_SENTENCES - b * BATCH < BATCH ? NUM_SENTENCES - b * BATCH : BATCH;
+            size_t longest = 0;
+
+            if(mode == 2) {
+                count = token_batch_sampler_batch(sampler, b, &sentences, &longest);
+            } else {
+                for(size_t i = 0; i < count; i++) {
+                    size_t length = token_dataset_sentence_length(dataset, sentences[i]);
+                    if(length > longest) longest = length;
+                }
+                if(mode == 0) longest = MAX_LEN;
+            }
+
+            fill_batch(input, dataset, sentences, (int)count, (int)longest);
+            double start = now_seconds();
+            forward_batch(attention, ff, input, hidden, output);
+            elapsed += now_seconds() - start;
+            rows[mode] += (long)count * (long)longest;
+        }
+        times[mode] = elapsed;
+    }
+
+    printf("%d sentences, %ld tokens (mean length %.1f), batch %d, dim %d, %d heads\n",
+           NUM_SENTENCES, tokens, (double)tokens / NUM_SENTENCES, BATCH, EMBEDDING_DIM, NUM_HEADS);
+    for(int mode = 0; mode < 3; mode++) {
+        printf("  %-28s %8ld rows (%5.1f%% padding) %9.1f ms (%8.0f tokens/s)\n", names[mode], rows[mode],
+               100.0 * (rows[mode] - tokens) / rows[mode], times[mode] * 1e3, tokens / times[mode]);
+    }
+
+    free_batch_tensor(input);
+    free_batch_tensor(hidden);
+    free_batch_tensor(output);
+    free_feed_forward_block(ff);
+    free_self_attention_layer(attention);
+    free_token_batch_sampler(sampler);
+    free_token_dataset(dataset);
+    freeTokenizedCorpus(corpus);
+    freeVocabulary();
+    freeEmbeddingTable();
+    return 0;
+}
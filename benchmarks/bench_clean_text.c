@@ -0,0 +1,115 @@
+// Text cleaning over test_data.txt repeated to 256 MB: the per-byte
+// tolower/isalnum cleaner with one malloc'd output per call (Cleaned_Text
+// before it used the table) against cleanTextBuffer in ASCII and UTF-8 mode.
+// Each cleaner runs on whole 64 KB pieces, then in place on ~100-byte sentences.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_clean_text benchmarks/bench_clean_text.c src/Data_Loading_Cleaning.c -fopenmp
+// and run it from the repository root so that test_data.txt is found.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "../include/Data_Loading_Cleaning.h"
+
+#define CORPUS_BYTES (256u << 20)
+#define PIECE_BYTES (64u << 10)
+#define SENTENCE_BYTES 100
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Baseline: the original Cleaned_Text loop
+static char* baseline_clean(const char* raw_text, size_t len) {
+    char* cleaned_text = malloc(len + 1);
+    size_t j = 0;
+    int last_was_space = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = tolower(raw_text[i]);
+        if (isalnum(c)) {
+            cleaned_text[j++] = c;
+            last_was_space = 0;
+        } else if (c == ' ' && !last_was_space) {
+            cleaned_text[j++] = ' ';
+            last_was_space = 1;
+        }
+    }
+    cleaned_text[j] = '\0';
+    return cleaned_text;
+}
+
+int main() {
+    char* sample = readFileToString("test_data.txt");
+    if (sample == NULL) {
+        printf("Run from the repository root (test_data.txt not found)\n");
+        return 1;
+    }
+    size_t sample_length = strlen(sample);
+
+    char* text = (char*)malloc(CORPUS_BYTES + 1);
+    char* work = (char*)malloc(CORPUS_BYTES + 1);
+    char* output = (char*)malloc(PIECE_BYTES + 1);
+    if (text == NULL || work == NULL || output == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t pos = 0; pos < CORPUS_BYTES; pos += sample_length) {
+        size_t n = (CORPUS_BYTES - pos < sample_length) ? CORPUS_BYTES - pos : sample_length;
+        memcpy(text + pos, sample, n);
+    }
+    text[CORPUS_BYTES] = '\0';
+    double gigabytes = CORPUS_BYTES / 1e9;
+
+    // Whole 64 KB pieces
+    unsigned long checksum_baseline = 0, checksum_ascii = 0;
+    double start = now_seconds();
+    for (size_t pos = 0; pos < CORPUS_BYTES; pos += PIECE_BYTES) {
+        char* cleaned = baseline_clean(text + pos, PIECE_BYTES);
+        checksum_baseline += strlen(cleaned);
+        free(cleaned);
+    }
+    double baseline_s = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t pos = 0; pos < CORPUS_BYTES; pos += PIECE_BYTES) {
+        checksum_ascii += cleanTextBuffer(text + pos, PIECE_BYTES, output, CLEAN_TEXT_ASCII);
+    }
+    double ascii_s = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t pos = 0; pos < CORPUS_BYTES; pos += PIECE_BYTES) {
+        cleanTextBuffer(text + pos, PIECE_BYTES, output, CLEAN_TEXT_UTF8);
+    }
+    double utf8_s = now_seconds() - start;
+
+    // Short sentences cleaned in place, as examples/main.c does
+    memcpy(work, text, CORPUS_BYTES);
+    start = now_seconds();
+    for (size_t pos = 0; pos + SENTENCE_BYTES <= CORPUS_BYTES; pos += SENTENCE_BYTES) {
+        cleanTextBuffer(work + pos, SENTENCE_BYTES - 1, work + pos, CLEAN_TEXT_ASCII);
+    }
+    double sentences_s = now_seconds() - start;
+
+    if (checksum_baseline != checksum_ascii) {
+        printf("Cleaned lengths differ\n");
+        return 1;
+    }
+
+    printf("cleaning %.0f MB of test_data.txt\n", CORPUS_BYTES / 1e6);
+    printf("  tolower/isalnum + malloc: %8.1f ms (%5.2f GB/s)\n", baseline_s * 1e3, gigabytes / baseline_s);
+    printf("  table + SIMD, ASCII:      %8.1f ms (%5.2f GB/s)\n", ascii_s * 1e3, gigabytes / ascii_s);
+    printf("  table + SIMD, UTF-8:      %8.1f ms (%5.2f GB/s)\n", utf8_s * 1e3, gigabytes / utf8_s);
+    printf("  in place, %d-byte pieces: %7.1f ms (%5.2f GB/s)\n", SENTENCE_BYTES, sentences_s * 1e3, gigabytes / sentences_s);
+
+    free(sample);
+    free(text);
+    free(work);
+    free(output);
+    return 0;
+}
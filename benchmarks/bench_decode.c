@@ -0,0 +1,62 @@
+// Autoregressive decoding through one multi-head attention layer: recomputing
+// attention over the whole prefix for every new token against a KV-cached
+// decode step that projects only the new token.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_decode benchmarks/bench_decode.c src/*.c -lm -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/self_attention_layer.h"
+
+#define NUM_HEADS 8
+#define NUM_TOKENS 256
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main() {
+    SelfAttentionLayer* layer = create_multi_head_attention_layer(EMBEDDING_DIM, NUM_HEADS, NUM_TOKENS);
+    KVCache* cache = create_kv_cache_for_layer(layer, NUM_TOKENS);
+    float* tokens = malloc((size_t)NUM_TOKENS * EMBEDDING_DIM * sizeof(float));
+    float* output = malloc((size_t)NUM_TOKENS * EMBEDDING_DIM * sizeof(float));
+    if(layer == NULL || cache == NULL || tokens == NULL || output == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    for(size_t i = 0; i < (size_t)NUM_TOKENS * EMBEDDING_DIM; i++) {
+        tokens[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+
+    // Without a cache, token t re-projects and re-attends all t + 1 positions
+    double start = now_seconds();
+    for(int t = 0; t < NUM_TOKENS; t++) {
+        self_attention_forward(layer, tokens, output, t + 1);
+    }
+    double recompute_ms = (now_seconds() - start) * 1e3;
+
+    double last_step_ms = 0.0;
+    start = now_seconds();
+    for(int t = 0; t < NUM_TOKENS; t++) {
+        double step = now_seconds();
+        self_attention_decode_step(layer, cache, tokens + (size_t)t * EMBEDDING_DIM, output);
+        last_step_ms = (now_seconds() - step) * 1e3;
+    }
+    double cached_ms = (now_seconds() - start) * 1e3;
+
+    printf("decode %d tokens, dim %d, %d heads\n", NUM_TOKENS, EMBEDDING_DIM, NUM_HEADS);
+    printf("  recompute prefix: %10.3f ms total\n", recompute_ms);
+    printf("  kv cache:         %10.3f ms total, %.3f ms for the last step\n", cached_ms, last_step_ms);
+    printf("  speedup: %.1fx\n", recompute_ms / cached_ms);
+
+    free(tokens);
+    free(output);
+    free_kv_cache(cache);
+    free_self_attention_layer(layer);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Per-call latency of feed_forward(): the original allocate / randomize /
+// naive-loop version against the persistent FeedForwardBlock.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_feed_forward benchmarks/bench_feed_forward.c src/*.c -lm -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "../include/self_attention_layer.h"
+
+#define FF_DIM 2048
+#define ITERATIONS 20
+
+static float input[MAX_SEQ_LENGTH][EMBEDDING_DIM];
+static float output[MAX_SEQ_LENGTH][EMBEDDING_DIM];
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// The feed_forward() implementation this benchmark is measured against
+static void legacy_feed_forward(float in[MAX_SEQ_LENGTH][EMBEDDING_DIM], float out[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length) {
+    float (*W1)[FF_DIM] = malloc(sizeof(float[EMBEDDING_DIM][FF_DIM]));
+    float (*W2)[EMBEDDING_DIM] = malloc(sizeof(float[FF_DIM][EMBEDDING_DIM]));
+    float (*intermediate)[FF_DIM] = malloc(sizeof(float[MAX_SEQ_LENGTH][FF_DIM]));
+
+    for(int i = 0; i < EMBEDDING_DIM; i++) {
+        for(int j = 0; j < FF_DIM; j++) {
+            W1[i][j] = ((float) rand() / (float)(RAND_MAX)) - 0.5;
+        }
+    }
+    for(int i = 0; i < FF_DIM; i++) {
+        for(int j = 0; j < EMBEDDING_DIM; j++) {
+            W2[i][j] = ((float) rand() / (float)(RAND_MAX)) - 0.5;
+        }
+    }
+    for(int i = 0; i < seq_length; i++) {
+        for(int j = 0; j < FF_DIM; j++) {
+            intermediate[i][j] = 0;
+            for(int k = 0; k < EMBEDDING_DIM; k++) {
+                intermediate[i][j] += in[i][k] * W1[k][j];
+            }
+            intermediate[i][j] = fmax(0, intermediate[i][j]);
+        }
+    }
+    for(int i = 0; i < seq_length; i++) {
+        for(int j = 0; j < EMBEDDING_DIM; j++) {
+            out[i][j] = 0;
+            for(int k = 0; k < FF_DIM; k++) {
+                out[i][j] += intermediate[i][k] * W2[k][j];
+            }
+        }
+    }
+
+    free(W1);
+    free(W2);
+    free(intermediate);
+}
+
+int main() {
+    srand(42);
+    for(int i = 0; i < MAX_SEQ_LENGTH; i++) {
+        for(int j = 0; j < EMBEDDING_DIM; j++) {
+            input[i][j] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+        }
+    }
+
+    int legacy_iterations = 3;
+    double start = now_seconds();
+    for(int i = 0; i < legacy_iterations; i++) {
+        legacy_feed_forward(input, output, MAX_SEQ_LENGTH);
+    }
+    double legacy_ms = (now_seconds() - start) * 1e3 / legacy_iterations;
+
+    // First call creates the persistent block; it is not part of the timing
+    feed_forward(input, output, MAX_SEQ_LENGTH);
+
+    start = now_seconds();
+    for(int i = 0; i < ITERATIONS; i++) {
+        feed_forward(input, output, MAX_SEQ_LENGTH);
+    }
+    double persistent_ms = (now_seconds() - start) * 1e3 / ITERATIONS;
+
+    printf("feed_forward, seq_length %d, %d -> %d -> %d\n", MAX_SEQ_LENGTH, EMBEDDING_DIM, FF_DIM, EMBEDDING_DIM);
+    printf("  before (alloc + rand + loops): %10.3f ms/call\n", legacy_ms);
+    printf("  after  (persistent block):     %10.3f ms/call\n", persistent_ms);
+    printf("  speedup: %.1fx\n", legacy_ms / persistent_ms);
+    return 0;
+}
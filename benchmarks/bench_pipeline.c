@@ -0,0 +1,95 @@
+// Text preprocessing over test_data.txt repeated to 64 MB, from raw bytes to
+// token ids. The multi-pass path examples/main.c used before: SplitSentences,
+// Cleaned_Text per sentence, extractUniqueWords, then strtok and getTokenId
+// per word. The fused path is one tokenizeText call. Both build the same
+// vocabulary and the same ids, which is checked.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_pipeline benchmarks/bench_pipeline.c src/*.c -lm -fopenmp
+// and run it from the repository root so that test_data.txt is found.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/Data_Loading_Cleaning.h"
+#include "../include/tokenizer.h"
+
+#define CORPUS_BYTES (64u << 20)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main() {
+    char* sample = readFileToString("test_data.txt");
+    if (sample == NULL) {
+        printf("Run from the repository root (test_data.txt not found)\n");
+        return 1;
+    }
+    size_t sample_length = strlen(sample);
+
+    // Whole copies of the sample, so no sentence is cut at the end
+    size_t size = CORPUS_BYTES / sample_length * sample_length;
+    char* text = (char*)malloc(size + 1);
+    if (text == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t pos = 0; pos < size; pos += sample_length) memcpy(text + pos, sample, sample_length);
+    text[size] = '\0';
+    double megabytes = size / 1e6;
+
+    // Multi-pass path (SplitSentences leaves its input alone, so text is reused)
+    srand(1);
+    double start = now_seconds();
+    char** sentences = SplitSentences(text);
+    for (int i = 0; sentences[i] != NULL; i++) {
+        char* cleaned = Cleaned_Text(sentences[i]);
+        free(sentences[i]);
+        sentences[i] = cleaned;
+    }
+    extractUniqueWords(sentences);
+    unsigned long multi_pass_ids = 0, multi_pass_sum = 0;
+    for (int i = 0; sentences[i] != NULL; i++) {
+        for (char* word = strtok(sentences[i], " "); word != NULL; word = strtok(NULL, " ")) {
+            multi_pass_sum += getTokenId(word);
+            multi_pass_ids++;
+        }
+    }
+    double multi_pass_s = now_seconds() - start;
+    unsigned int multi_pass_words = vocabulary->count;
+    for (int i = 0; sentences[i] != NULL; i++) free(sentences[i]);
+    free(sentences);
+
+    // Fused path
+    freeVocabulary();
+    freeEmbeddingTable();
+    srand(1);
+    start = now_seconds();
+    TokenizedCorpus* corpus = createTokenizedCorpus();
+    tokenizeText(corpus, text, size, TOKENIZE_ADD_WORDS);
+    double fused_s = now_seconds() - start;
+
+    unsigned long fused_sum = 0;
+    for (size_t i = 0; i < corpus->num_ids; i++) fused_sum += corpus->ids[i];
+    if (corpus->num_ids != multi_pass_ids || fused_sum != multi_pass_sum || vocabulary->count != multi_pass_words) {
+        printf("The two paths disagree\n");
+        return 1;
+    }
+
+    printf("%zu sentences, %zu tokens, %u words in %.0f MB\n",
+           corpus->num_sentences, corpus->num_ids, vocabulary->count, megabytes);
+    printf("  split + clean + extract + lookup: %8.1f ms (%6.1f MB/s)\n", multi_pass_s * 1e3, megabytes / multi_pass_s);
+    printf("  tokenizeText (one pass):          %8.1f ms (%6.1f MB/s)\n", fused_s * 1e3, megabytes / fused_s);
+
+    freeTokenizedCorpus(corpus);
+    freeVocabulary();
+    freeEmbeddingTable();
+    free(text);
+    free(sample);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Sentence splitting over a synthetic 256 MB corpus: strtok with one malloc'd
+// copy per sentence (SplitSentences before it returned spans, without its
+// 99-sentence limit) against SplitSentenceSpans, which scans for delimiters
+// with SIMD compares and returns (offset, length) spans without copying.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_sentence_split benchmarks/bench_sentence_split.c src/Data_Loading_Cleaning.c -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/Data_Loading_Cleaning.h"
+
+#define CORPUS_BYTES (256u << 20)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main() {
+    // Words of 1-10 letters, sentences of 5-30 words
+    char* text = (char*)malloc(CORPUS_BYTES + 1);
+    if (text == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    srand(42);
+    size_t pos = 0;
+    while (pos + 400 < CORPUS_BYTES) {
+        int words = 5 + rand() % 26;
+        for (int w = 0; w < words; w++) {
+            int length = 1 + rand() % 10;
+            for (int c = 0; c < length; c++) text[pos++] = (char)('a' + rand() % 26);
+            text[pos++] = ' ';
+        }
+        text[pos++] = ".!?"[rand() % 3];
+    }
+    text[pos] = '\0';
+    double megabytes = pos / 1e6;
+
+    char* copy = strdup(text);
+    double start = now_seconds();
+    size_t copied = 0, capacity = 1 << 20;
+    char** sentences = (char**)malloc(capacity * sizeof(char*));
+    for (char* token = strtok(copy, ".!?"); token != NULL; token = strtok(NULL, ".!?")) {
+        if (copied == capacity) {
+            capacity *= 2;
+            sentences = (char**)realloc(sentences, capacity * sizeof(char*));
+        }
+        sentences[copied++] = strdup(token);
+    }
+    double strtok_s = now_seconds() - start;
+
+    start = now_seconds();
+    size_t count = 0;
+    SentenceSpan* spans = SplitSentenceSpans(text, pos, &count, 1);
+    double spans_s = now_seconds() - start;
+
+    start = now_seconds();
+    size_t parallel_count = 0;
+    SentenceSpan* parallel_spans = SplitSentenceSpans(text, pos, &parallel_count, 0);
+    double parallel_s = now_seconds() - start;
+
+    if (count != copied || parallel_count != copied ||
+        memcmp(spans, parallel_spans, count * sizeof(SentenceSpan)) != 0) {
+        printf("Sentence counts differ: %zu %zu %zu\n", copied, count, parallel_count);
+        return 1;
+    }
+
+    printf("%zu sentences in %.0f MB\n", count, megabytes);
+    printf("  strtok + copies:       %8.1f ms (%7.1f MB/s)\n", strtok_s * 1e3, megabytes / strtok_s);
+    printf("  spans, 1 thread:       %8.1f ms (%7.1f MB/s)\n", spans_s * 1e3, megabytes / spans_s);
+    printf("  spans, all threads:    %8.1f ms (%7.1f MB/s)\n", parallel_s * 1e3, megabytes / parallel_s);
+
+    for (size_t i = 0; i < copied; i++) free(sentences[i]);
+    free(sentences);
+    free(spans);
+    free(parallel_spans);
+    free(copy);
+    free(text);
+    return 0;
+}
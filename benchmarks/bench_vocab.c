@@ -0,0 +1,157 @@
+// Vocabulary build and lookup over a synthetic million-word corpus with a
+// Zipf-like word distribution: the chained table the tokenizer used so far
+// (100,000 buckets, one malloc'd node and strdup'd word per entry) against the
+// open-addressing Vocab index with its string arena.
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_vocab benchmarks/bench_vocab.c src/vocab.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+
+#include "../include/vocab.h"
+
+#define CORPUS_WORDS 1000000
+#define DISTINCT_WORDS 200000
+#define CHAINED_TABLE_SIZE 100000
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Baseline: the chained layout of the original tokenizer hash table
+typedef struct chained_node {
+    char* word;
+    unsigned int token_id;
+    struct chained_node* next;
+    float embedding[2];
+} chained_node;
+
+static chained_node* chained_table[CHAINED_TABLE_SIZE];
+static unsigned int chained_next_id = 1;
+
+static unsigned int chained_hash(const char* word) {
+    unsigned long h = 5381;
+    for (; *word; word++) h = ((h << 5) + h) + tolower((unsigned char)*word);
+    return h % CHAINED_TABLE_SIZE;
+}
+
+static unsigned int chained_find(const char* word) {
+    for (chained_node* n = chained_table[chained_hash(word)]; n != NULL; n = n->next) {
+        if (strcmp(n->word, word) == 0) return n->token_id;
+    }
+    return 0;
+}
+
+static void chained_insert(const char* word) {
+    unsigned int index = chained_hash(word);
+    chained_node* n = (chained_node*)malloc(sizeof(chained_node));
+    n->word = strdup(word);
+    n->token_id = chained_next_id++;
+    n->next = chained_table[index];
+    chained_table[index] = n;
+}
+
+static void chained_free(void) {
+    for (int i = 0; i < CHAINED_TABLE_SIZE; i++) {
+        while (chained_table[i] != NULL) {
+            chained_node* next = chained_table[i]->next;
+            free(chained_table[i]->word);
+            free(chained_table[i]);
+            chained_table[i] = next;
+        }
+    }
+}
+
+int main() {
+    // Distinct words of 3-12 lowercase letters, one NUL-terminated string each
+    char* words = (char*)malloc((size_t)DISTINCT_WORDS * 16);
+    unsigned char* lengths = (unsigned char*)malloc(DISTINCT_WORDS);
+    int* corpus = (int*)malloc(CORPUS_WORDS * sizeof(int));
+    double* cdf = (double*)malloc(DISTINCT_WORDS * sizeof(double));
+    if (words == NULL || lengths == NULL || corpus == NULL || cdf == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+
+    srand(42);
+    for (int w = 0; w < DISTINCT_WORDS; w++) {
+        lengths[w] = (unsigned char)(3 + rand() % 10);
+        for (int c = 0; c < lengths[w]; c++) words[w * 16 + c] = (char)('a' + rand() % 26);
+        words[w * 16 + lengths[w]] = '\0';
+    }
+
+    // Zipf(1) sampling: a few words are very common, most are rare
+    double total = 0.0;
+    for (int w = 0; w < DISTINCT_WORDS; w++) {
+        total += 1.0 / (w + 1);
+        cdf[w] = total;
+    }
+    for (int i = 0; i < CORPUS_WORDS; i++) {
+        double u = ((double)rand() / RAND_MAX) * total;
+        int lo = 0, hi = DISTINCT_WORDS - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1; else hi = mid;
+        }
+        corpus[i] = lo;
+    }
+
+    // Build as extractUniqueWords did: presence check, insert, then id lookup
+    double start = now_seconds();
+    unsigned long chained_checksum = 0;
+    for (int i = 0; i < CORPUS_WORDS; i++) {
+        const char* word = words + (size_t)corpus[i] * 16;
+        if (chained_find(word) == 0) chained_insert(word);
+        chained_checksum += chained_find(word);
+    }
+    double chained_build_ms = (now_seconds() - start) * 1e3;
+
+    start = now_seconds();
+    for (int i = 0; i < CORPUS_WORDS; i++) {
+        chained_checksum += chained_find(words + (size_t)corpus[i] * 16);
+    }
+    double chained_lookup_ms = (now_seconds() - start) * 1e3;
+
+    start = now_seconds();
+    Vocab* vocab = create_vocab(0);
+    unsigned long vocab_checksum = 0;
+    for (int i = 0; i < CORPUS_WORDS; i++) {
+        vocab_checksum += vocab_lookup_or_insert(vocab, words + (size_t)corpus[i] * 16, lengths[corpus[i]], NULL);
+    }
+    double vocab_build_ms = (now_seconds() - start) * 1e3;
+
+    start = now_seconds();
+    for (int i = 0; i < CORPUS_WORDS; i++) {
+        vocab_checksum += vocab_find(vocab, words + (size_t)corpus[i] * 16, lengths[corpus[i]]);
+    }
+    double vocab_lookup_ms = (now_seconds() - start) * 1e3;
+
+    // Both tables hand out ids in first-seen order, so the sums must agree
+    if (chained_checksum != vocab_checksum) {
+        printf("Token ids differ between the two tables\n");
+        return 1;
+    }
+
+    printf("vocabulary of %u words from a %d word corpus\n", vocab->count, CORPUS_WORDS);
+    printf("  chained build:  %8.2f ms   lookup: %8.2f ms (%6.1f ns/word)\n",
+           chained_build_ms, chained_lookup_ms, chained_lookup_ms * 1e6 / CORPUS_WORDS);
+    printf("  vocab build:    %8.2f ms   lookup: %8.2f ms (%6.1f ns/word)\n",
+           vocab_build_ms, vocab_lookup_ms, vocab_lookup_ms * 1e6 / CORPUS_WORDS);
+    printf("  speedup: build %.2fx, lookup %.2fx\n",
+           chained_build_ms / vocab_build_ms, chained_lookup_ms / vocab_lookup_ms);
+
+    chained_free();
+    free_vocab(vocab);
+    free(words);
+    free(lengths);
+    free(corpus);
+    free(cdf);
+    return 0;
+}
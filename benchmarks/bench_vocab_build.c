@@ -0,0 +1,80 @@
+// Vocabulary construction over a synthetic corpus of short sentences:
+// extractUniqueWords on one thread against extractUniqueWordsParallel, whose
+// shards are counted concurrently and merged in order (the resulting token ids
+// are identical, which is checked).
+//
+// Build from the repository root:
+//   gcc -O2 -o bench_vocab_build benchmarks/bench_vocab_build.c src/*.c -lm -fopenmp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <omp.h>
+
+#include "../include/tokenizer.h"
+
+#define NUM_SENTENCES 400000
+#define WORDS_PER_SENTENCE 12
+#define DISTINCT_WORDS 100000
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main() {
+    char** sentences = (char**)malloc((NUM_SENTENCES + 1) * sizeof(char*));
+    char* text = (char*)malloc((size_t)NUM_SENTENCES * WORDS_PER_SENTENCE * 9);
+    if (sentences == NULL || text == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+
+    // Words "w<n>" with n skewed towards small values, space separated
+    srand(42);
+    char* p = text;
+    for (int i = 0; i < NUM_SENTENCES; i++) {
+        sentences[i] = p;
+        for (int w = 0; w < WORDS_PER_SENTENCE; w++) {
+            int n = (rand() % DISTINCT_WORDS) % (1 + rand() % DISTINCT_WORDS);
+            p += sprintf(p, w + 1 < WORDS_PER_SENTENCE ? "w%d " : "w%d", n);
+        }
+        *p++ = '\0';
+    }
+    sentences[NUM_SENTENCES] = NULL;
+    double megabytes = (double)(p - text) / 1e6;
+
+    double start = now_seconds();
+    extractUniqueWords(sentences);
+    double serial_ms = (now_seconds() - start) * 1e3;
+    unsigned int serial_count = vocabulary->count;
+    unsigned int probe_id = getTokenId("w12345");
+
+    printf("vocabulary of %u words from %.1f MB (%d words)\n", serial_count, megabytes,
+           NUM_SENTENCES * WORDS_PER_SENTENCE);
+    printf("  serial:              %8.2f ms (%7.1f MB/s)\n", serial_ms, megabytes / serial_ms * 1e3);
+
+    for (int threads = 1; threads <= omp_get_max_threads(); threads *= 2) {
+        freeVocabulary();
+        freeEmbeddingTable();
+        start = now_seconds();
+        extractUniqueWordsParallel(sentences, threads);
+        double parallel_ms = (now_seconds() - start) * 1e3;
+
+        if (vocabulary->count != serial_count || getTokenId("w12345") != probe_id) {
+            printf("Token ids differ from the serial build\n");
+            return 1;
+        }
+        printf("  parallel, %2d threads: %8.2f ms (%7.1f MB/s)\n", threads, parallel_ms,
+               megabytes / parallel_ms * 1e3);
+    }
+
+    freeVocabulary();
+    freeEmbeddingTable();
+    free(sentences);
+    free(text);
+    return 0;
+}
@@ -8,6 +8,7 @@
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
 #define MAX_SENTENCE_LENGTH 512
+#define TRAINING_BATCH_SIZE 8
 #define MATRIX_SIZE 2
 #define EMBEDDING_DIM 2
 #define LEARNING_RATE 0.01
@@ -18,6 +19,8 @@
 
 #include "../include/tokenizer.h"
 
+#include "../include/dataset.h"
+
 #include "../include/Data_Preprocessing.h"
 
 #include "../include/transformer_block.h"
@@ -33,72 +36,79 @@ int main(){
 
 /////////////////////////////   LEVEL1: TRAINING DATA PREPARATION //////////////////////////
 
-    // LOAD OUR RAW TEXT DATA
-    char *raw_text = readFileToString("test_data.txt");  // READ THE FILE CONTENT
-
-    if(!raw_text){
-        printf("Error: Failed to load text data\n");
-        return 1;
-    }
-
-    printf("\n==============================\n");
-    printf("       RAW TEXT DATA            \n");
-    printf("===============================\n");
-
-    for(int i = 0; i < 500; i++){
-        putchar(raw_text[i]);
+    // REUSE THE VOCABULARY SNAPSHOT OF A PREVIOUS RUN (DELETE IT TO REBUILD FROM THE CORPUS)
+    const char* tokenizer_snapshot = "Model_Trained_Weights/tokenizer.snapshot";
+    int snapshot_loaded = loadTokenizerSnapshot(tokenizer_snapshot);
+    if (snapshot_loaded) {
+        printf("LOADED %d WORDS FROM %s\n", global_token - 1, tokenizer_snapshot);
     }
 
-    // SPLIT TO SENTENCES
-    printf("\n==============================\n");
-    printf("    EXTRACTING SENTENCES        \n");
-    printf("===============================\n");
-
-    char **sentences = SplitSentences(raw_text);
-
-    if(!sentences){
-        printf("Error: Failed to split sentences\n");
-        free(raw_text);
-        return 1;
-    }
+    // MAP THE PRE-TOKENIZED DATASET WHEN IT MATCHES THE VOCABULARY (SEE tools/pretokenize.c)
+    const char* dataset_path = "Model_Trained_Weights/train.dataset";
+    TokenDataset *dataset = snapshot_loaded ? load_token_dataset(dataset_path, (uint32_t)global_token) : NULL;
+    if (dataset) {
+        printf("MAPPED %zu PRE-TOKENIZED SENTENCES FROM %s\n", dataset->num_sentences, dataset_path);
+    } else {
+        // STREAM THE RAW TEXT DATA ONE SENTENCE AT A TIME (THE FILE IS NEVER HELD IN MEMORY AS A WHOLE)
+        CorpusReader *corpus = openCorpusReader("test_data.txt", 0);
+        TokenizedCorpus *tokens = createTokenizedCorpus();
+
+        if(!corpus || !tokens){
+            printf("Error: Failed to load text data\n");
+            closeCorpusReader(corpus);
+            freeTokenizedCorpus(tokens);
+            return 1;
+        }
 
-    // PRINTING THE SENTENCES FOR CHECK
-    printf("\n==============================\n");
-    printf("    EXTRACTED SENTENCES        \n");
-    printf("===============================\n");
+        // SPLIT, CLEAN AND TOKENIZE IN ONE PASS: EACH SENTENCE GOES STRAIGHT TO TOKEN IDS
+        printf("\n==============================\n");
+        printf("    EXTRACTED SENTENCES        \n");
+        printf("===============================\n");
 
-    for(int i = 0; i < 5; i++ ){
-        printf("[%d] %s\n", i + 1, sentences[i]);
-    }
-
-    // DATA CLEANING
-    printf("\n==============================\n");
-    printf("      CLEANED SENTENCES        \n");
-    printf("===============================\n");
+        int tokenize_flags = snapshot_loaded ? 0 : TOKENIZE_ADD_WORDS;
+        int tokenize_ok = 1;
+        char *next_sentence;
+        size_t next_length;
 
+        while(tokenize_ok && (next_sentence = nextCorpusSentence(corpus, &next_length)) != NULL){
+            if(tokens->num_sentences < 5){
+                printf("[%zu] %s\n", tokens->num_sentences + 1, next_sentence); // PRINTING THE SENTENCES FOR CHECK
+            }
+            tokenize_ok = tokenizeText(tokens, next_sentence, next_length, tokenize_flags);
+        }
+        int corpus_failed = !tokenize_ok || corpus->error || !corpus->eof;
+        closeCorpusReader(corpus);
 
-    for (int i = 0; i< 5; i++){
-        char *cleaned_sentence = Cleaned_Text(sentences[i]);
-        if(!cleaned_sentence){
-            printf("Error: Failed to clean sentence %d\n", i);
-            continue;
+        if(corpus_failed){
+            printf("Error: Failed to tokenize the text data\n");
+            freeTokenizedCorpus(tokens);
+            return 1;
         }
-        free(sentences[i]); // FREE THE OLD SENTENCE MEMORY
-        sentences[i] = cleaned_sentence; // ASSIGN CLEANED SENTENCE BACK
-        printf("  [%d] %s\n", i + 1, sentences[i]);
 
-    }
+        // WORD MAPPING DICTIONARY
+        printf("PREPARED THE WORD MAPPINGS \n");
 
-    // WORD MAPPING DICTIONARY
-    printf("PREPARED THE WORD MAPPINGS \n");
+        sleep( 2 );
 
-    sleep( 2 );
+        printf("HERE ARE SOME OF THE WORD MAPPINGS: \n\n\n\n\n\n");
 
-    printf("GENERATING WORD MAPPINGS FOR EVERY WORD ");
+        // CACHE THE VOCABULARY AND THE TOKEN IDS FOR THE NEXT RUN
+        if (!snapshot_loaded && saveTokenizerSnapshot(tokenizer_snapshot)) {
+            printf("SAVED THE VOCABULARY TO %s\n", tokenizer_snapshot);
+        }
 
-    printf("HERE ARE SOME OF THE WORD MAPPINGS: \n\n\n\n\n\n");
+        // PACK THE TOKEN IDS (ONE BUFFER PLUS SENTENCE OFFSETS) THE SAME WAY THE MAPPED DATASET IS
+        dataset = token_dataset_from_corpus(tokens, (uint32_t)global_token);
+        freeTokenizedCorpus(tokens);
 
-    extractUniqueWords(sentences); // EXTRACT UNIQUE WORDS FROM THE SENTENCES
+        if(!dataset){
+            printf("Error: Failed to pack the token ids\n");
+            return 1;
+        }
+        if (write_token_dataset(dataset_path, dataset)) {
+            printf("SAVED THE TOKENIZED DATASET TO %s\n", dataset_path);
+        }
+    }
 
     Print_Tokens_And_Ids();
 
@@ -107,49 +117,8 @@ int main(){
     // PREPARE BATCHES OF SAMPLES FOR TRAINING
     printf( " PREPARING TRAINING DATA... \n");
 
-    int num_sentences = 0;
-
-    while(sentences[num_sentences] != NULL){
-        num_sentences++;
-    }
-
-    int** training_data = malloc(num_sentences * sizeof(int*));
-    int training_data_count = 0;
-
-    for(int i = 0; i < num_sentences; i++){
-        char* sentence = sentences[i];
-
-        // 1) CONVERT SENTENCE INTO AN ARRAY OF STRINGS
-        char* words[MAX_SENTENCE_LENGTH];
-        int word_count = 0;
-        char* word = strtok(sentence , " ");
-
-        while(word != NULL && word_count < MAX_SENTENCE_LENGTH){
-            words[word_count++] = word;
-            word = strtok(NULL, " ");
-
-        }
-
-        // 2) CONVERT SENTENCE INTO AN ARRAY OF INTEGERS
-        int* token_array = malloc(MAX_SENTENCE_LENGTH*sizeof(int));
-
-
-        for(int j = 0; j < word_count; j++){
-            token_array[j] = getTokenId(words[j]);
-           // token_array[ j ] = 10;
-        }
-
-        // 3) TRIM OR PAD THE ARRAY TO EXACTLY 512 ELEMENTS
-        if(word_count > MAX_SENTENCE_LENGTH){
-            word_count = MAX_SENTENCE_LENGTH;
-        }else if(word_count < MAX_SENTENCE_LENGTH){
-            for(int j = word_count; j < MAX_SENTENCE_LENGTH; j++){
-                token_array[ j ] = 0;
-            }
-        }
-        // APPEND THE ARRAY TO TRAINING DATA
-        training_data[training_data_count++] = token_array;
-    }
+    // EVERY SAMPLE IS A VIEW INTO THE PACKED DATASET: NOTHING IS PADDED OR COPIED PER SENTENCE
+    int training_data_count = (int)dataset->num_sentences;
 
     printf("TRAINING DATA PREPARED. TOTAL SAMPLES: %d\n", training_data_count);
 
@@ -157,9 +126,10 @@ int main(){
     printf("SAMPLE OF TRAINING DATA (FIRST 10 TOKENS OF FIRST 5 SAMPLES: \n");
 
     for(int i = 0; i < 5 && i < training_data_count; i++){
+        TokenSequence sample = token_dataset_sequence(dataset, i);
         printf("SAMPLE %d: ", i + 1);
-        for(int j = 0; j < 10; j++) {
-            printf("%d", training_data[i][j]);
+        for(size_t j = 0; j < 10; j++) {
+            printf("%u", j < sample.length ? token_sequence_id(&sample, j) : 0);
         }
 
 
@@ -197,20 +167,40 @@ printf("NUM SAMPLES: %d \n", training_data_count);
 
 
 ////////////////////////// LOAD THE SELF ATTENTION BLOCK /////////////////////////////////
-initialize_matrices_from_files();
+// PREFER THE BINARY CHECKPOINT, BUILT BY tools/convert_weights.c, MAPPED RATHER THAN READ;
+// FALL BACK TO THE ONE-VALUE-PER-FILE TEXT WEIGHTS WHEN IT IS NOT THERE.
+// TRAINING UPDATES THE MATRICES IN PLACE, SO THE MAPPING IS COPY-ON-WRITE
+Checkpoint *checkpoint = checkpoint_map("Model_Trained_Weights/model.ckpt",
+                                        CHECKPOINT_MAP_WRITABLE | CHECKPOINT_MAP_POPULATE);
+
+if(checkpoint == NULL || !bind_attention_matrices_to_checkpoint(checkpoint)){
+    initialize_matrices_from_files();
+}
 
 ///////////////////////// SEMI FINAL LAYER NODES//////////////////////////////////
 double semi_final_layer_weights[ 512 * 65] = {0.0};
 const char* path = "Model_Trained_Weights/Semi_Final_Weights/";
-read_weights(path, semi_final_layer_weights, 512 * 64 );
+if(checkpoint == NULL || !read_weights_from_checkpoint(checkpoint, "semi_final.weights", semi_final_layer_weights, 512 * 64)){
+    read_weights(path, semi_final_layer_weights, 512 * 64 );
+}
 
 
 ///////////////////////// FINAL LAYER NODES//////////////////////////////////
 double final_layer_weights[65 * 2] = {0.0};
 
 const char* path_2 = "Model_Trained_Weights/Final_Weights/";
-read_weights( path_2 , final_layer_weights , 64 * 2);
+if(checkpoint == NULL || !read_weights_from_checkpoint(checkpoint, "final.weights", final_layer_weights, 64 * 2)){
+    read_weights( path_2 , final_layer_weights , 64 * 2);
+}
+
 
+// VISIT THE SAMPLES IN BATCHES OF SIMILAR LENGTH, RESHUFFLED EVERY EPOCH
+TokenBatchSampler *sampler = create_token_batch_sampler(dataset, TRAINING_BATCH_SIZE, MAX_SENTENCE_LENGTH, 1);
+
+if(sampler == NULL){
+    printf("Error: Failed to create the batch sampler\n");
+    return 1;
+}
 
 // EVERY EPOCH
 for (int epoch = 0; epoch < epochs; epoch++) {
@@ -219,47 +209,42 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
     double total_loss = 0;
 
-    // CURRENTLY, KEEPING A BATCH SIZE OF 1. HENCE PROCESSING EVERY SAMPLE ONE BY ONE
-
-    for (int sample_index = 0; sample_index < num_samples; sample_index++) {
+    // THE WEIGHTS ARE STILL UPDATED AFTER EVERY SAMPLE; THE SAMPLER ONLY ORDERS THE SAMPLES SO THAT
+    // SIMILAR LENGTHS RUN TOGETHER, AND EVERY STEP BELOW WORKS ON THE SAMPLE'S REAL LENGTH, NOT ON 512 ROWS
 
-        printf("Sample %d: ", sample_index + 1);
-
-        float* sentence = (float*)malloc(MAX_SENTENCE_LENGTH * sizeof(float));
-
-        if (sentence == NULL) {
+    for (int step = 0; step < num_samples; step++) {
 
-            printf("Memory allocation failed.\n");
+        int sample_index = (int)sampler->order[step];
 
-            continue;
-
-        }
-
-        for (int sentence_index = 0; sentence_index < MAX_SENTENCE_LENGTH; sentence_index++) {
+        printf("Sample %d: ", sample_index + 1);
 
-            sentence[sentence_index] = training_data[sample_index][sentence_index];
+        // VIEW OF THE SAMPLE'S TOKENS, TRIMMED TO 512 (THE REST OF THE ROW IS PADDING)
+        TokenSequence sentence = token_dataset_sequence(dataset, sample_index);
 
-        }
+        size_t sentence_length = sentence.length < MAX_SENTENCE_LENGTH ? sentence.length : MAX_SENTENCE_LENGTH;
 
         printf("Current sample's first 10 elements: ");
 
-        for (int sentence_index = 0; sentence_index < 10; sentence_index++) {
+        for (size_t sentence_index = 0; sentence_index < 10; sentence_index++) {
 
-            printf(" %f, ", sentence[sentence_index]);
+            printf(" %u, ", sentence_index < sentence_length ? token_sequence_id(&sentence, sentence_index) : 0);
 
         }
 
         printf("\n");
 
+        // THE LAST NON-PADDING TOKEN IS THE TARGET; THE TOKENS BEFORE IT ARE THE INPUT
         int y_actual = 0;
 
-        for (int k = MAX_SENTENCE_LENGTH - 1; k >= 0; k--) {
+        size_t input_length = 0;
 
-            if (sentence[k] != 0) {
+        for (size_t k = sentence_length; k > 0; k--) {
 
-                y_actual = sentence[k];
+            if (token_sequence_id(&sentence, k - 1) != 0) {
 
-                sentence[k] = 0;
+                y_actual = (int)token_sequence_id(&sentence, k - 1);
+
+                input_length = k - 1;
 
                 break;
 
@@ -270,38 +255,23 @@ for (int epoch = 0; epoch < epochs; epoch++) {
         printf("y_actual token: %d \n" , y_actual);
 
         printf("max sentence length: %d \n", MAX_SENTENCE_LENGTH);
-        float embedding_matrix[MAX_SENTENCE_LENGTH][2] = {0}; // 512 x 2 MATRIX
-
-        for (int i = 0; i < MAX_SENTENCE_LENGTH; i++) {
-
-            if (sentence[i] != 0) {
-
-                unsigned int token_id = (unsigned int)sentence[i];
-
-                double curr_vector_embedding[ 2 ];
-
-                getEmbeddingByTokenId( token_id , curr_vector_embedding );
 
-                embedding_matrix[i][0] = ( float ) curr_vector_embedding[0];
+        // ONLY THE FIRST length ROWS OF EVERY MATRIX BELOW ARE COMPUTED; THE PADDING ROWS WOULD ALL BE ZERO
+        int length = (int)input_length;
 
-                embedding_matrix[i][1] = ( float ) curr_vector_embedding[1];
+        int print_rows = length < 10 ? length : 10;
 
+        printf("sequence length: %d \n", length);
+        float embedding_matrix[MAX_SENTENCE_LENGTH][2]; // 512 x 2 MATRIX
 
-            } else {
-
-                embedding_matrix[i][0] = 0.0f;
-
-                embedding_matrix[i][1] = 0.0f;
-
-            }
-
-        }
+        // GATHER THE EMBEDDING OF EVERY POSITION IN ONE CALL, STRAIGHT FROM THE PACKED IDS
+        token_sequence_gather_embeddings( &sentence , input_length , input_length , &embedding_matrix[0][0] );
 
         sleep(2);
 
         printf("Embedding Matrix:\n");
 
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < print_rows; i++) {
 
             printf(" [%f, %f] \n", embedding_matrix[i][0], embedding_matrix[i][1]);
 
@@ -315,13 +285,13 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         printf(" Scaling down the matrix values: \n\n");
 
-        scale_matrix( embedding_matrix );
+        scale_matrix_rows( embedding_matrix , length );
 
         printf(" After scaling: \n");
 
         printf("Embedding Matrix:\n");
 
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < print_rows; i++) {
 
             printf(" [%f, %f] \n", embedding_matrix[i][0], embedding_matrix[i][1]);
 
@@ -338,11 +308,11 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         printf("Adding positional encoding values to the matrix \n");
 
-        Add_Positional_Encoding(embedding_matrix, MAX_SENTENCE_LENGTH);
+        Add_Positional_Encoding(embedding_matrix, length);
 
         printf("Matrix Post Positional Encoding:\n");
 
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < print_rows; i++) {
 
             printf(" [%f, %f] \n", embedding_matrix[i][0], embedding_matrix[i][1]);
 
@@ -392,14 +362,17 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         // MULTIPLY THESE MATRICES WITH THE EMBEDDING MATRIX
 
-        double final_k_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE] = {0};
-        double final_q_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE] = {0};
-        double final_v_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE] = {0};
+        double final_k_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE];
+        double final_q_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE];
+        double final_v_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE];
 
 
         // MULTIPLY EMBEDDING MATRIX WITH K, Q, V MATRICES
-        for (int i = 0; i < MAX_SENTENCE_LENGTH; i++) {
+        for (int i = 0; i < length; i++) {
             for (int j = 0; j < MATRIX_SIZE; j++) {
+                final_k_matrix[i][j] = 0;
+                final_q_matrix[i][j] = 0;
+                final_v_matrix[i][j] = 0;
                 for (int k = 0; k < MATRIX_SIZE; k++) {
                     final_k_matrix[i][j] += embedding_matrix[i][k] * k_matrix[k][j];
                     final_q_matrix[i][j] += embedding_matrix[i][k] * q_matrix[k][j];
@@ -410,30 +383,30 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         // PRINT FINAL MATRICES
         printf("Final K Matrix:\n");
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < print_rows; i++) {
             printf("[%lf, %lf]\n", final_k_matrix[i][0], final_k_matrix[i][1]);
         }
 
         printf("Final Q Matrix:\n");
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < print_rows; i++) {
             printf("[%lf, %lf]\n", final_q_matrix[i][0], final_q_matrix[i][1]);
         }
 
         printf("Final V Matrix:\n");
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < print_rows; i++) {
             printf("[%lf, %lf]\n", final_v_matrix[i][0], final_v_matrix[i][1]);
         }
 
 
         // COMPUTE SELF-ATTENTION MATRIX SCORES
-        double self_attention_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE ] = { 0 };
-        compute_self_attention(embedding_matrix, final_k_matrix, final_q_matrix, final_v_matrix, MAX_SENTENCE_LENGTH, self_attention_matrix);
+        double self_attention_matrix[ MAX_SENTENCE_LENGTH ][ MATRIX_SIZE ];
+        compute_self_attention(embedding_matrix, final_k_matrix, final_q_matrix, final_v_matrix, length, self_attention_matrix);
 
         // PRINT THE SELF-ATTENTION MATRIX
 
         printf(" \n\nSelf-Attention Matrix: \n");
 
-        for( int i = 0; i < 10; i++ ) {
+        for( int i = 0; i < print_rows; i++ ) {
 
             for( int j = 0; j < MATRIX_SIZE; j++ ) {
 
@@ -447,12 +420,12 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         // ADD THE 'self_attention_matrix' AND THE 'embedding_matrix'
 
-        double context_matrix[ MAX_SENTENCE_LENGTH ][ 2 ] = { 0 };
+        double context_matrix[ MAX_SENTENCE_LENGTH ][ 2 ];
 
-        add_matrices( embedding_matrix , self_attention_matrix , context_matrix, MAX_SENTENCE_LENGTH, MATRIX_SIZE );
+        add_matrices( embedding_matrix , self_attention_matrix , context_matrix, length, MATRIX_SIZE );
 
         printf("\n\nContext Matrix (embedding_matrix + self_attention_matrix:\n");
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < print_rows; i++) {
             for (int j = 0; j < MATRIX_SIZE; j++) {
                 printf("%f ", context_matrix[i][j]);
             }
@@ -467,7 +440,7 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         // INCREMENT THE ABSOLUTE VALUE OF THE COLUMN 1 BY 1
 
-        for( int i = 0; i < MAX_SENTENCE_LENGTH; i++ ) {
+        for( int i = 0; i < length; i++ ) {
 
             if( context_matrix[ i ][ 1 ] < 0 ) {
                 context_matrix[ i ][ 1 ] += -100;
@@ -491,9 +464,10 @@ for (int epoch = 0; epoch < epochs; epoch++) {
         printf("semi_final_layer_weights[%d] = %f\n", 512, semi_final_layer_weights[511]);
 
 
-        double semi_final_layer_nodes[ 512 * 65] = {0.0};
+        // A PADDING ROW WOULD GIVE leaky_relu( 0 ) = 0, SO ONLY THE REAL ROWS ARE COMPUTED (AND SUMMED BELOW)
+        double semi_final_layer_nodes[ MAX_SENTENCE_LENGTH ];
 
-        for( int row = 0; row < 512; row++ ) {
+        for( int row = 0; row < length; row++ ) {
 
             for( int node = 0; node < 65; node++ ) {
 
@@ -509,7 +483,7 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         printf("\n\n Semi Final Layer Node Values: \n");
 
-        for( int i = 0; i < 10; i++ ) {
+        for( int i = 0; i < print_rows; i++ ) {
 
             printf("%lf \n" , semi_final_layer_nodes[ i ]);
         }
@@ -547,9 +521,11 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         // VALUE FOR NODE 1
 
+        int node_rows = length < 130 ? length : 130;
+
         double total_value_node_1 = 0;
 
-        for( int i = 0; i < 130; i++ ) {
+        for( int i = 0; i < node_rows; i++ ) {
 
             total_value_node_1 += semi_final_layer_nodes[ i ] * final_layer_weights[ i ];
         }
@@ -561,7 +537,7 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
         double total_value_node_2 = 0;
 
-        for( int i = 0; i < 130; i++ ) {
+        for( int i = 0; i < node_rows; i++ ) {
 
             total_value_node_2 += semi_final_layer_nodes[ i ] * final_layer_weights[ i + 512 ];
         }
@@ -607,24 +583,19 @@ for (int epoch = 0; epoch < epochs; epoch++) {
 
 
         printf("UPDATED WEIGHTS FOR THE LAST LAYER \n\n\n");
-
-        free(sentence);
     }
 
+    token_batch_sampler_next_epoch(sampler);
+
     printf("********************************************** Epoch %d  total loss: %f ******************************************************************* \n\n" , epoch , total_loss);
 
 }
 
     // Cleanup
-    for(int i = 0; i < training_data_count; i++){
-        free(training_data[i]);
-    }
-    free(training_data);
-    free(raw_text);
-    for(int i = 0; i < num_sentences; i++){
-        free(sentences[i]);
-    }
-    free(sentences);
+    free_token_batch_sampler(sampler);
+    free_token_dataset(dataset);
+    unbind_attention_matrices();
+    free_checkpoint(checkpoint);
 
     return 0;
 }
\ No newline at end of file
@@ -17,19 +17,149 @@
  */
 char* readFileToString(const char *filename);
 
+// BYTES READ FROM THE CORPUS AT A TIME BY A CorpusReader
+#define CORPUS_CHUNK_SIZE (1 << 20)
+
+/**
+ * @brief Streams the sentences of a corpus file one at a time.
+ *
+ * The file is read sequentially in fixed-size chunks; a sentence cut by the
+ * end of a chunk is carried over to the front of the buffer before the next
+ * read. Memory use is therefore bounded by the chunk size (or the longest
+ * sentence), whatever the size of the corpus.
+ */
+typedef struct {
+    FILE* file;
+    char* buffer;           // Current chunk, preceded by the carried-over partial sentence
+    size_t capacity;        // Buffer size, excluding one byte for a terminating NUL
+    size_t start;           // First byte of the next sentence
+    size_t scanned;         // Bytes before this offset hold no sentence delimiter
+    size_t end;             // One past the last byte read
+    int eof;
+    int error;              // Set when a read fails
+    unsigned long long bytes_read;
+} CorpusReader;
+
+/**
+ * @brief Opens a corpus file for streaming.
+ *
+ * @param filename The name of the file to read.
+ * @param chunk_size Bytes per read, or 0 for CORPUS_CHUNK_SIZE.
+ * @return The reader, or NULL if the file cannot be opened.
+ */
+CorpusReader* openCorpusReader(const char *filename, size_t chunk_size);
+
+/**
+ * @brief Returns the next sentence of the corpus.
+ *
+ * Sentences are split on the same punctuation as SplitSentences and empty
+ * sentences are skipped, so the sequence is the one SplitSentences would
+ * return for the whole file. The sentence is NUL-terminated and may be
+ * modified in place, but it lives in the reader's buffer and is only valid
+ * until the next call.
+ *
+ * @param length Set to the sentence length in bytes (may be NULL).
+ * @return The sentence, or NULL at the end of the file or on a read error.
+ */
+char* nextCorpusSentence(CorpusReader* reader, size_t* length);
+
+/**
+ * @brief Closes the file and frees the reader.
+ */
+void closeCorpusReader(CorpusReader* reader);
+
 /* Text processing functions */
 
+/**
+ * @brief A sentence as a byte range of the text it was found in.
+ */
+typedef struct {
+    size_t offset;
+    size_t length;
+} SentenceSpan;
+
+/**
+ * @brief Finds the next non-empty sentence of text at or after *cursor.
+ *
+ * Sentences end at '.', '!' or '?' (or at the end of the text) and runs of
+ * delimiters produce no empty sentences, as in SplitSentences. The delimiter
+ * search is vectorized. Nothing is copied or modified and no state is kept
+ * outside *cursor, so any number of iterations may run concurrently.
+ *
+ * @param size Length of text in bytes.
+ * @param cursor Position to search from; advanced past the sentence and its delimiter.
+ * @param span Receives the sentence.
+ * @return 1 if a sentence was found, 0 at the end of the text.
+ */
+int nextSentenceSpan(const char *text, size_t size, size_t *cursor, SentenceSpan *span);
+
+/**
+ * @brief Returns the first position at or after position where a sentence may start.
+ *
+ * Iterating with nextSentenceSpan from the aligned start of a byte range
+ * [begin, end), and keeping the spans whose offset is below end, visits every
+ * sentence that starts in the range exactly once, so disjoint ranges can be
+ * split independently.
+ */
+size_t alignSentenceStart(const char *text, size_t size, size_t position);
+
+/**
+ * @brief Splits text into sentence spans, without copying and without a limit.
+ *
+ * @param count Receives the number of spans.
+ * @param num_threads Threads splitting disjoint byte ranges (0 = OpenMP default).
+ * @return A malloc'd array of spans in text order, or NULL on error.
+ */
+SentenceSpan* SplitSentenceSpans(const char *text, size_t size, size_t *count, int num_threads);
+
 /**
  * @brief Splits raw text into an array of sentences.
  *
  * This function tokenizes the input text into sentences. The returned
- * array is NULL-terminated (i.e. the final pointer in the array will be NULL).
+ * array is NULL-terminated (i.e. the final pointer in the array will be NULL),
+ * and each sentence is a separately allocated copy; raw_text is not modified.
+ * Use SplitSentenceSpans to avoid the copies.
  *
  * @param raw_text The input text to be split.
  * @return An array of C-strings (each sentence), or NULL on error.
  */
 char** SplitSentences(char *raw_text);
 
+/**
+ * What the cleaner writes for each byte: its lowercase form for letters and
+ * digits, ' ' for a space, 0 for everything else (dropped). Bytes >= 0x80 are
+ * dropped, as isalnum does in the C locale.
+ */
+extern const unsigned char text_clean_table[256];
+
+// MODES OF THE TEXT CLEANER
+#define CLEAN_TEXT_ASCII 0   // Bytes >= 0x80 are dropped, as by Cleaned_Text
+#define CLEAN_TEXT_UTF8 1    // Well-formed UTF-8 letters are kept (Latin-1, Greek and Cyrillic lowercased)
+
+/**
+ * @brief Cleans length bytes of text into output, which may be text itself.
+ *
+ * Letters are lowercased, digits kept, runs of spaces collapse to one space,
+ * and everything else is dropped, exactly as Cleaned_Text does, but without
+ * locale lookups: bytes are classified through a 256-entry table, and blocks
+ * of plain ASCII letters, digits and single spaces are lowercased 16 or 32
+ * bytes at a time. In CLEAN_TEXT_UTF8 mode, well-formed multi-byte sequences
+ * are kept unless they fall in the Latin-1, general punctuation/symbol or CJK
+ * punctuation blocks, and invalid bytes are dropped.
+ *
+ * @param output Receives the cleaned text and a NUL; needs length + 1 bytes.
+ * @param mode CLEAN_TEXT_ASCII or CLEAN_TEXT_UTF8.
+ * @return The length of the cleaned text.
+ */
+size_t cleanTextBuffer(const char *text, size_t length, char *output, int mode);
+
+/**
+ * @brief Cleans a NUL-terminated string in place (see cleanTextBuffer).
+ *
+ * @return The new length of the string.
+ */
+size_t cleanTextInPlace(char *text, int mode);
+
 /**
  * @brief Cleans the raw text by removing unwanted characters.
  *
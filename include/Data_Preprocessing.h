@@ -15,4 +15,6 @@ void Add_Positional_Encoding(float embedding_matrix[][MATRIX_SIZE], int max_sent
 
 void scale_matrix(float matrix[EMBEDDING_SIZE][MATRIX_SIZE]);
 
+void scale_matrix_rows(float matrix[][MATRIX_SIZE], int rows);
+
 #endif /* DATA_PREPROCESSING_H */
\ No newline at end of file
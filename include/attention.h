@@ -0,0 +1,34 @@
+#ifndef ATTENTION_H
+#define ATTENTION_H
+
+#include <stdlib.h>
+
+// TILE SIZES OF flash_attention_f32: A BLOCK OF QUERIES IS SCORED AGAINST
+// ONE BLOCK OF KEYS AT A TIME, SO ONLY A Q_BLOCK x KV_BLOCK TILE IS LIVE
+#define ATTENTION_Q_BLOCK  128
+#define ATTENTION_KV_BLOCK 256
+
+/**
+ * @brief Scaled dot-product attention that never materializes the score matrix.
+ *
+ * Computes O = softmax(scale * Q * K^T) * V for row-major Q (seq_q x head_dim),
+ * K and V (seq_k x head_dim) and O (seq_q x head_dim). ldq, ldk, ldv and ldo
+ * are row strides in elements, so Q, K and V may be column slices of a
+ * fused projection buffer.
+ *
+ * Keys and values are consumed in tiles of ATTENTION_KV_BLOCK rows while a
+ * running row maximum and row sum (online softmax) rescale the partial
+ * output, so memory use is O(Q_BLOCK x KV_BLOCK) per thread regardless of
+ * sequence length. Query blocks are split across the OpenMP worker team.
+ *
+ * @param causal When non-zero, query i only attends to keys
+ *               j <= i + (seq_k - seq_q), i.e. queries are aligned with the
+ *               last seq_q keys (as when decoding after a cached prefix).
+ */
+void flash_attention_f32(int seq_q, int seq_k, int head_dim, float scale,
+                         const float *Q, int ldq,
+                         const float *K, int ldk,
+                         const float *V, int ldv,
+                         float *O, int ldo, int causal);
+
+#endif // ATTENTION_H
@@ -0,0 +1,109 @@
+#ifndef BPE_H
+#define BPE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "checkpoint.h"
+
+// TOKENS 0..255 ARE RAW BYTES; MERGE r CREATES TOKEN BPE_BYTE_TOKENS + r
+#define BPE_BYTE_TOKENS 256
+
+/**
+ * @brief One learned merge: the adjacent tokens (left, right) become one token.
+ */
+typedef struct {
+    uint32_t left;
+    uint32_t right;
+} BPEMerge;
+
+/**
+ * @brief Byte-level byte-pair-encoding tokenizer.
+ *
+ * Text is split into words with the vocabulary delimiters (see nextWord) and
+ * every word is encoded independently, starting from its bytes and applying
+ * merges in the order they were learned. The vocabulary is therefore bounded
+ * by BPE_BYTE_TOKENS + num_merges, and any input (including words never seen
+ * in training) encodes without an unknown token.
+ */
+typedef struct {
+    int num_merges;
+    int vocab_size;            // BPE_BYTE_TOKENS + num_merges
+    BPEMerge* merges;          // merges[r] creates token BPE_BYTE_TOKENS + r
+    uint64_t* merge_keys;      // Open-addressing index (left, right) -> rank, 0 = empty
+    int32_t* merge_ranks;
+    uint32_t merge_capacity;   // Power of two
+    uint32_t* token_offsets;   // Bytes of token t: token_bytes[token_offsets[t] .. token_offsets[t + 1])
+    char* token_bytes;
+} BPETokenizer;
+
+/**
+ * @brief Learns merges from a corpus until the vocabulary reaches vocab_size tokens.
+ *
+ * Word frequencies are counted first, then the most frequent adjacent pair
+ * (ties broken by the smaller token ids) is merged repeatedly, with pair
+ * counts updated only in the words that contain the merged pair. Training
+ * stops early when no pair occurs at least twice.
+ *
+ * @param sentences A NULL-terminated array of sentence strings.
+ * @param vocab_size Target vocabulary size (at least BPE_BYTE_TOKENS).
+ * @return The tokenizer, or NULL on error.
+ */
+BPETokenizer* bpe_train(char** sentences, int vocab_size);
+
+/**
+ * @brief Creates a tokenizer from a list of merges (e.g. read from a checkpoint).
+ *
+ * @return The tokenizer, or NULL if a merge refers to a token that does not exist yet.
+ */
+BPETokenizer* create_bpe_tokenizer(const BPEMerge* merges, int num_merges);
+
+/**
+ * @brief Frees the tokenizer.
+ */
+void free_bpe_tokenizer(BPETokenizer* tokenizer);
+
+/**
+ * @brief Encodes one word of length bytes.
+ *
+ * Adjacent symbols of the word are kept in a linked list and candidate merges
+ * in a priority queue ordered by merge rank, so a word of n bytes encodes in
+ * O(n log n) instead of one pass per merge.
+ *
+ * @param ids Receives the token ids; needs room for length entries.
+ * @return The number of ids written.
+ */
+int bpe_encode_word(const BPETokenizer* tokenizer, const char* word, size_t length, uint32_t* ids);
+
+/**
+ * @brief Encodes every word of a NUL-terminated text.
+ *
+ * @param ids Receives the token ids.
+ * @param max_ids Capacity of ids (strlen(text) is always enough).
+ * @return The number of ids written, or -1 if ids is too small.
+ */
+long bpe_encode(const BPETokenizer* tokenizer, const char* text, uint32_t* ids, long max_ids);
+
+/**
+ * @brief Returns the bytes of a token (not NUL-terminated).
+ *
+ * @param length Set to the number of bytes.
+ * @return The bytes, or NULL if the id is out of range.
+ */
+const char* bpe_token_bytes(const BPETokenizer* tokenizer, uint32_t token_id, size_t* length);
+
+/**
+ * @brief Describes the merges as a U32 [num_merges][2] checkpoint tensor named name.
+ *
+ * @return 1 on success, 0 otherwise.
+ */
+int bpe_checkpoint_tensor(const BPETokenizer* tokenizer, const char* name, CheckpointTensor* tensor);
+
+/**
+ * @brief Creates a tokenizer from the merges tensor written by bpe_checkpoint_tensor.
+ *
+ * @return The tokenizer, or NULL if the tensor is missing or invalid.
+ */
+BPETokenizer* create_bpe_tokenizer_from_checkpoint(const Checkpoint* checkpoint, const char* name);
+
+#endif // BPE_H
@@ -0,0 +1,184 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Binary checkpoint format (version 1, little-endian)
+ *
+ *   offset 0                 CheckpointHeader (64 bytes)
+ *   header.table_offset      num_tensors x CheckpointEntry (128 bytes each)
+ *   header.data_offset       tensor data; every tensor starts on a multiple of
+ *                            header.alignment bytes from the start of the file
+ *
+ * header.checksum is the FNV-1a 64 hash of every byte from table_offset to
+ * the end of the file; each entry also carries the hash of its own bytes.
+ * The whole file is either read with one sequential read (checkpoint_load)
+ * or memory-mapped (checkpoint_map), and tensors are returned as views into
+ * that image. Mapped images are shared through the page cache, so several
+ * processes serving the same model keep a single resident copy.
+ */
+
+#define CHECKPOINT_MAGIC      "TFSCKPT"   // 7 characters + NUL = 8 bytes
+#define CHECKPOINT_VERSION    1
+#define CHECKPOINT_BYTE_ORDER 0x01020304u
+#define CHECKPOINT_ALIGNMENT  64
+#define CHECKPOINT_NAME_LEN   64
+#define CHECKPOINT_MAX_DIMS   4
+
+// OPTIONS FOR checkpoint_map (BITWISE OR)
+#define CHECKPOINT_MAP_DEFAULT    0
+#define CHECKPOINT_MAP_POPULATE   (1 << 0)   // Prefault every page at map time (MAP_POPULATE)
+#define CHECKPOINT_MAP_WILLNEED   (1 << 1)   // Start readahead of the whole file (MADV_WILLNEED)
+#define CHECKPOINT_MAP_SEQUENTIAL (1 << 2)   // Aggressive readahead, pages dropped after use (MADV_SEQUENTIAL)
+#define CHECKPOINT_MAP_HUGEPAGES  (1 << 3)   // Ask for transparent huge pages (MADV_HUGEPAGE), best effort
+#define CHECKPOINT_MAP_WRITABLE   (1 << 4)   // Copy-on-write views; untouched pages stay shared
+#define CHECKPOINT_MAP_VERIFY     (1 << 5)   // Check the file checksum (reads every page)
+
+typedef enum {
+    CHECKPOINT_F32 = 0,
+    CHECKPOINT_F64 = 1,
+    CHECKPOINT_I32 = 2,
+    CHECKPOINT_U16 = 3,
+    CHECKPOINT_U32 = 4,
+    CHECKPOINT_U8  = 5,
+    CHECKPOINT_U64 = 6,
+    CHECKPOINT_DTYPE_COUNT
+} CheckpointDType;
+
+// On-disk file header
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;     // CHECKPOINT_BYTE_ORDER as written by the producer
+    uint32_t num_tensors;
+    uint32_t alignment;
+    uint64_t table_offset;
+    uint64_t data_offset;
+    uint64_t file_size;
+    uint64_t checksum;
+    uint64_t reserved;
+} CheckpointHeader;
+
+// On-disk tensor table entry
+typedef struct {
+    char name[CHECKPOINT_NAME_LEN];     // NUL-terminated tensor name
+    uint32_t dtype;                     // CheckpointDType
+    uint32_t ndim;
+    uint64_t shape[CHECKPOINT_MAX_DIMS];
+    uint64_t offset;                    // From the start of the file
+    uint64_t nbytes;
+    uint64_t checksum;                  // FNV-1a 64 of the tensor bytes
+} CheckpointEntry;
+
+/**
+ * @brief A tensor to save, or a view of a loaded tensor.
+ */
+typedef struct {
+    char name[CHECKPOINT_NAME_LEN];
+    CheckpointDType dtype;
+    int ndim;
+    long shape[CHECKPOINT_MAX_DIMS];
+    size_t nbytes;
+    void* data;                          // Caller's buffer when saving, view into the checkpoint when loaded
+} CheckpointTensor;
+
+/**
+ * @brief A loaded checkpoint: the file contents plus a decoded tensor table.
+ */
+typedef struct {
+    int version;
+    int num_tensors;
+    CheckpointTensor* tensors;
+    void* blob;          // The whole file, 64-byte aligned
+    size_t blob_size;
+    int mapped;          // 1 when blob is a memory mapping (see checkpoint_map)
+} Checkpoint;
+
+/**
+ * @brief Returns the size in bytes of one element of dtype, or 0 if unknown.
+ */
+size_t checkpoint_dtype_size(CheckpointDType dtype);
+
+/**
+ * @brief Fills a tensor descriptor for saving; shape has ndim entries.
+ *
+ * @return 1 on success, 0 if the name is too long or the shape is invalid.
+ */
+int checkpoint_tensor_init(CheckpointTensor* tensor, const char* name, CheckpointDType dtype,
+                           int ndim, const long* shape, void* data);
+
+/**
+ * @brief Writes tensors to path in the binary checkpoint format.
+ *
+ * The file is written as <path>.tmp and renamed over path, so existing
+ * mappings of path stay valid and a failed save leaves it untouched.
+ *
+ * @return 1 on success, 0 on failure (a message is printed to stderr).
+ */
+int checkpoint_save(const char* path, const CheckpointTensor* tensors, int num_tensors);
+
+/**
+ * @brief Reads a checkpoint with one sequential read and verifies it.
+ *
+ * @return The checkpoint, or NULL if the file is missing, truncated,
+ *         from an unsupported version, has a malformed tensor entry or
+ *         fails a checksum.
+ */
+Checkpoint* checkpoint_load(const char* path);
+
+/**
+ * @brief Maps a checkpoint into memory without copying it.
+ *
+ * Tensor views point straight into the mapping and are aligned to
+ * CHECKPOINT_ALIGNMENT. Views are read-only unless CHECKPOINT_MAP_WRITABLE
+ * is given. The header and tensor table are always validated (the table and
+ * data offsets must lie inside the file, and every tensor must lie in the data
+ * region, be aligned and hold exactly its shape times its dtype size); the file
+ * and per-tensor checksums are checked only with CHECKPOINT_MAP_VERIFY.
+ *
+ * @param flags CHECKPOINT_MAP_* options.
+ * @return The checkpoint, or NULL if the file is missing or invalid.
+ */
+Checkpoint* checkpoint_map(const char* path, int flags);
+
+/**
+ * @brief Returns the view of a named tensor if it has the given dtype and element count.
+ *
+ * @return The tensor data, or NULL if it is missing or does not match.
+ */
+void* checkpoint_view(const Checkpoint* checkpoint, const char* name, CheckpointDType dtype, long count);
+
+/**
+ * @brief Frees a checkpoint returned by checkpoint_load or checkpoint_map.
+ */
+void free_checkpoint(Checkpoint* checkpoint);
+
+/**
+ * @brief Looks a tensor up by name.
+ *
+ * @return The tensor, or NULL if the checkpoint has no tensor of that name.
+ */
+const CheckpointTensor* checkpoint_find(const Checkpoint* checkpoint, const char* name);
+
+/**
+ * @brief Copies a named tensor into dst, converting F32/F64 as needed.
+ *
+ * @return The number of elements copied (at most count), or -1 if the
+ *         tensor is missing or not a floating-point tensor.
+ */
+long checkpoint_read_f64(const Checkpoint* checkpoint, const char* name, double* dst, long count);
+
+/**
+ * @brief Same as checkpoint_read_f64 for a float destination.
+ */
+long checkpoint_read_f32(const Checkpoint* checkpoint, const char* name, float* dst, long count);
+
+/**
+ * @brief FNV-1a 64-bit hash, continuing from hash (start with CHECKPOINT_FNV_SEED).
+ */
+#define CHECKPOINT_FNV_SEED 0xcbf29ce484222325ULL
+uint64_t checkpoint_hash(uint64_t hash, const void* data, size_t size);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,176 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "checkpoint.h"
+#include "tokenizer.h"
+
+// BUMPED WHENEVER THE LAYOUT OF THE DATASET TENSORS CHANGES
+#define TOKEN_DATASET_VERSION 1
+
+/**
+ * @brief A pre-tokenized corpus, memory-mapped from a dataset file.
+ *
+ * The file is a checkpoint (see checkpoint.h) with three tensors:
+ * dataset.meta (U32 [2]: TOKEN_DATASET_VERSION, vocabulary size),
+ * dataset.ids (the token stream, U16 when every id fits, U32 otherwise) and
+ * dataset.offsets (U64 [num_sentences + 1]: sentence s is
+ * ids[offsets[s] .. offsets[s + 1])). Nothing is copied on load, so jobs
+ * start at once and processes reading the same file share its page cache.
+ * token_dataset_from_corpus packs a corpus tokenized in memory the same way.
+ */
+typedef struct {
+    Checkpoint* checkpoint;           // Set when the dataset is mapped from a file
+    void* storage;                    // Set when it is packed in memory (offsets, then ids)
+    CheckpointDType id_type;          // CHECKPOINT_U16 or CHECKPOINT_U32
+    const void* ids;
+    const uint64_t* sentence_offsets;
+    size_t num_ids;
+    size_t num_sentences;
+    uint32_t vocab_size;              // Number of token ids, padding id 0 included
+} TokenDataset;
+
+/**
+ * @brief A view of one sentence of a TokenDataset (nothing is copied).
+ */
+typedef struct {
+    CheckpointDType id_type;          // CHECKPOINT_U16 or CHECKPOINT_U32
+    const void* ids;
+    size_t length;
+} TokenSequence;
+
+/**
+ * @brief Draws batches of sentences of similar length from a TokenDataset.
+ *
+ * Each epoch the sentences are sorted by length (clamped to max_length) with
+ * ties in random order, cut into batches of batch_size consecutive
+ * sentences, and the batches are laid out in random order. A batch is then
+ * padded only to its own longest sentence instead of to max_length, so the
+ * work of a batch follows the real number of tokens in it.
+ */
+typedef struct {
+    const TokenDataset* dataset;
+    size_t batch_size;
+    size_t max_length;
+    size_t* order;                    // Sentence indices of the epoch, batch after batch
+    size_t* batch_starts;             // Batch b is order[batch_starts[b] .. batch_starts[b + 1])
+    size_t* sorted;                   // Sentence indices sorted by clamped length (scratch)
+    size_t* batch_ids;                // Batch visiting order (scratch)
+    size_t* bucket_starts;            // Counting-sort scratch (max_length + 2 entries)
+    size_t num_sentences;
+    size_t num_batches;
+    uint64_t random_state;
+} TokenBatchSampler;
+
+/**
+ * @brief Packs a tokenized corpus into one buffer (sentence offsets followed
+ *        by the ids, as U16 when vocab_size is at most 65536).
+ *
+ * The corpus is not referenced afterwards and can be freed.
+ *
+ * @return The dataset, or NULL if allocation fails.
+ */
+TokenDataset* token_dataset_from_corpus(const TokenizedCorpus* corpus, uint32_t vocab_size);
+
+/**
+ * @brief Writes a tokenized corpus as a dataset file.
+ *
+ * @param vocab_size Number of token ids (global_token); ids are stored as
+ *        U16 when it is at most 65536.
+ * @return 1 on success, 0 otherwise.
+ */
+int save_token_dataset(const char* path, const TokenizedCorpus* corpus, uint32_t vocab_size);
+
+/**
+ * @brief Writes a dataset (packed or mapped) as a dataset file.
+ *
+ * @return 1 on success, 0 otherwise.
+ */
+int write_token_dataset(const char* path, const TokenDataset* dataset);
+
+/**
+ * @brief Memory-maps a dataset file written by save_token_dataset.
+ *
+ * @param expected_vocab_size Vocabulary size the ids must come from (e.g.
+ *        global_token after loading the matching tokenizer snapshot), or 0
+ *        to accept any.
+ * @return The dataset, or NULL if the file is missing, invalid or was
+ *         tokenized with a vocabulary of a different size.
+ */
+TokenDataset* load_token_dataset(const char* path, uint32_t expected_vocab_size);
+
+/**
+ * @brief Unmaps (or frees the storage of) and frees a dataset.
+ */
+void free_token_dataset(TokenDataset* dataset);
+
+/**
+ * @brief Returns the number of tokens of a sentence.
+ */
+size_t token_dataset_sentence_length(const TokenDataset* dataset, size_t sentence);
+
+/**
+ * @brief Copies a sentence into a row of row_length ints, truncating it or
+ *        padding it with token 0.
+ *
+ * @return The number of tokens copied (before padding).
+ */
+size_t token_dataset_copy_sentence(const TokenDataset* dataset, size_t sentence, int* row, size_t row_length);
+
+/**
+ * @brief Returns a view of a sentence (of length 0 if it is out of range).
+ */
+TokenSequence token_dataset_sequence(const TokenDataset* dataset, size_t sentence);
+
+/**
+ * @brief Returns token i of a sequence (i < sequence->length).
+ */
+uint32_t token_sequence_id(const TokenSequence* sequence, size_t i);
+
+/**
+ * @brief Writes the embeddings of the first count tokens of a sequence as
+ *        rows of TOKEN_EMBEDDING_DIM floats, then zero rows up to rows.
+ *
+ * Same result as gatherEmbeddings on the zero-padded ids, read straight
+ * from the packed ids. count is clamped to the sequence length and to rows.
+ */
+void token_sequence_gather_embeddings(const TokenSequence* sequence, size_t count, size_t rows, float* output);
+
+/**
+ * @brief Creates a sampler over every sentence of a dataset and draws the
+ *        batches of its first epoch.
+ *
+ * @param batch_size Sentences per batch (the last batch may be smaller).
+ * @param max_length Sequence length of the model: longer sentences are
+ *        truncated to it and bucketed with it.
+ * @param seed Seed of the shuffling (the same seed gives the same epochs).
+ * @return The sampler, or NULL if an argument is invalid or allocation fails.
+ */
+TokenBatchSampler* create_token_batch_sampler(const TokenDataset* dataset, size_t batch_size, size_t max_length,
+                                              uint64_t seed);
+
+/**
+ * @brief Frees a sampler (not its dataset).
+ */
+void free_token_batch_sampler(TokenBatchSampler* sampler);
+
+/**
+ * @brief Draws the batches of the next epoch.
+ *
+ * Walking order[0 .. num_sentences) visits every sentence once, batch by batch.
+ */
+void token_batch_sampler_next_epoch(TokenBatchSampler* sampler);
+
+/**
+ * @brief Returns batch i (0 <= i < num_batches) of the current epoch.
+ *
+ * @param sentences Set to the sentence indices of the batch.
+ * @param longest Set to the clamped length of its longest sentence (may be NULL).
+ * @return The number of sentences in the batch (0 if i is out of range).
+ */
+size_t token_batch_sampler_batch(const TokenBatchSampler* sampler, size_t i, const size_t** sentences,
+                                 size_t* longest);
+
+#endif // DATASET_H
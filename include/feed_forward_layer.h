@@ -3,6 +3,8 @@
 
 #include <stdlib.h>
 
+#include "checkpoint.h"
+
 // Structure to hold the feed forward layer parameters
 typedef struct {
     int input_size;
@@ -12,18 +14,39 @@ typedef struct {
     double* weights2;  // Second layer weights
     double* bias1;     // First layer bias
     double* bias2;     // Second layer bias
+    int owns_weights;  // 0 when the parameters are views into a mapped checkpoint
+    int workspace_rows;  // Samples the workspace holds (grown by batched calls)
+    double* hidden;      // Workspace: hidden activations (workspace_rows x hidden_size)
 } FeedForwardLayer;
 
 // Function to read weights from files
 void read_weights(const char* path, double* weights, int num_weights);
 
+// Function to read weights from a tensor of a binary checkpoint (1 on success, 0 if missing)
+int read_weights_from_checkpoint(const Checkpoint* checkpoint, const char* name, double* weights, int num_weights);
+
 // Create a new feed forward layer
 FeedForwardLayer* create_feed_forward_layer(int input_size, int hidden_size, int output_size);
 
+// Create a feed forward layer whose parameters are views of the F64 tensors
+// <prefix>.weights1, <prefix>.weights2, <prefix>.bias1 and <prefix>.bias2 (no copy).
+// The checkpoint must outlive the layer. Returns NULL if a tensor is missing or has the wrong size.
+FeedForwardLayer* create_feed_forward_layer_from_checkpoint(const Checkpoint* checkpoint, const char* prefix,
+                                                            int input_size, int hidden_size, int output_size);
+
+// Describe the layer parameters as checkpoint tensors named <prefix>.weights1 etc., for checkpoint_save.
+// Fills 4 entries of tensors and returns 4 (0 on error).
+int feed_forward_layer_checkpoint_tensors(const FeedForwardLayer* layer, const char* prefix, CheckpointTensor* tensors);
+
 // Free the feed forward layer
 void free_feed_forward_layer(FeedForwardLayer* layer);
 
 // Forward pass through the feed forward layer
 double* feed_forward_forward(FeedForwardLayer* layer, const double* input);
 
+// Forward pass for batch inputs stored back to back (batch x input_size) into
+// outputs (batch x output_size). scratch must hold batch x hidden_size doubles, or be
+// NULL to use the layer's own workspace (grown on first use). Returns 1 on success, 0 on failure.
+int feed_forward_forward_batch(FeedForwardLayer* layer, const double* inputs, double* outputs, int batch, double* scratch);
+
 #endif /* FEED_FORWARD_LAYER_H */
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <stdlib.h>
+
+// OPERAND FLAGS FOR gemm_f32
+#define GEMM_NO_TRANS 0
+#define GEMM_TRANS    1
+
+/**
+ * @brief Single precision general matrix multiply on row-major matrices.
+ *
+ * Computes C = alpha * op(A) * op(B) + beta * C, where op(X) is X or X^T
+ * depending on the matching trans flag. op(A) is M x K, op(B) is K x N and
+ * C is M x N. lda, ldb and ldc are the row strides (in elements) of the
+ * matrices as they are stored in memory. When beta is 0, C is not read.
+ *
+ * The operands are packed into cache-sized panels and multiplied with a
+ * register-blocked micro-kernel, so callers should route every large
+ * product through here instead of writing their own triple loops. Products
+ * above a size threshold are split across the OpenMP worker team; small
+ * ones (and calls made from inside a parallel region) stay on the caller.
+ */
+void gemm_f32(int trans_a, int trans_b, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const float *B, int ldb,
+              float beta, float *C, int ldc);
+
+/**
+ * @brief Sets how many worker threads gemm_f32 may use for large products.
+ *
+ * @param num_threads Thread count, or 0 to use every thread OpenMP offers
+ *                    (OMP_NUM_THREADS or the number of cores).
+ */
+void gemm_set_num_threads(int num_threads);
+
+/**
+ * @brief Returns how many worker threads gemm_f32 uses for large products.
+ */
+int gemm_get_num_threads(void);
+
+#endif // GEMM_H
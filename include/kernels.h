@@ -0,0 +1,87 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdlib.h>
+
+/* Instruction sets a kernel table can be built for */
+typedef enum {
+    KERNEL_ISA_SCALAR = 0,
+    KERNEL_ISA_SSE4,
+    KERNEL_ISA_AVX2,
+    KERNEL_ISA_AVX512,
+    KERNEL_ISA_NEON,
+    KERNEL_ISA_COUNT
+} KernelIsa;
+
+/**
+ * @brief Table of float primitives implemented for one instruction set.
+ *
+ * One table is selected the first time kernels() is called, based on what
+ * the CPU reports (CPUID on x86, compile target on ARM). Every hot loop in
+ * the project calls through this table rather than hand-rolling its own
+ * loop, so a single binary uses the widest vectors the machine supports.
+ */
+typedef struct {
+    KernelIsa isa;
+    const char* name;
+
+    /** Register block of gemm_ukernel: rows of A x columns of B */
+    int gemm_mr;
+    int gemm_nr;
+
+    /** Returns sum(a[i] * b[i]) */
+    float (*dot)(const float *a, const float *b, int n);
+
+    /** y[i] += alpha * x[i] */
+    void (*axpy)(int n, float alpha, const float *x, float *y);
+
+    /** x[i] *= alpha */
+    void (*scale)(int n, float alpha, float *x);
+
+    /** Returns max(x[i]) */
+    float (*row_max)(const float *x, int n);
+
+    /** y[i] = exp(x[i] - shift); x and y may alias */
+    void (*vexp)(const float *x, float shift, float *y, int n);
+
+    /** Returns sum(x[i]) */
+    float (*row_sum)(const float *x, int n);
+
+    /**
+     * C[0..mr)[0..nr) = alpha * (a * b) + beta * C over kc packed steps.
+     * a holds gemm_mr floats per step and b holds gemm_nr floats per step
+     * (64-byte aligned). C is only read when beta != 0.
+     */
+    void (*gemm_ukernel)(int kc, const float *a, const float *b, float *C, int ldc,
+                         int mr, int nr, float alpha, float beta);
+} KernelTable;
+
+/**
+ * @brief Returns the active kernel table.
+ *
+ * On first use the best table the CPU supports is chosen, unless the
+ * TRANSFORMER_ISA environment variable names another one
+ * ("scalar", "sse4", "avx2", "avx512" or "neon").
+ */
+const KernelTable* kernels(void);
+
+/**
+ * @brief Forces a specific instruction set, e.g. to A/B test code paths.
+ *
+ * @return 1 if the table was switched, 0 if the CPU (or build) cannot run it.
+ */
+int kernels_force_isa(KernelIsa isa);
+
+/**
+ * @brief Checks whether a kernel table for the given ISA can run here.
+ */
+int kernels_isa_supported(KernelIsa isa);
+
+/**
+ * @brief Maps a name such as "avx2" to its KernelIsa.
+ *
+ * @return The matching ISA, or KERNEL_ISA_COUNT if the name is unknown.
+ */
+KernelIsa kernels_isa_from_name(const char* name);
+
+#endif // KERNELS_H
@@ -0,0 +1,64 @@
+#ifndef KV_CACHE_H
+#define KV_CACHE_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Key/value cache of one attention layer for incremental decoding.
+ *
+ * Keys and values are stored head-major in one preallocated block each:
+ * head h occupies rows [h * capacity, (h + 1) * capacity) of K and V, one
+ * head_dim-wide row per cached position, so attention over a head reads a
+ * single contiguous slab. Positions are written as a ring: once capacity
+ * tokens are cached, each new token overwrites the oldest one and attention
+ * runs over the most recent capacity tokens (a sliding window).
+ */
+typedef struct {
+    int num_heads;
+    int head_dim;
+    int capacity;   // Maximum number of cached positions per head
+    int length;     // Number of valid positions (<= capacity)
+    int next;       // Ring slot the next token is written to
+    long position;  // Total tokens appended since the last reset
+    float* K;       // Cached keys (num_heads x capacity x head_dim)
+    float* V;       // Cached values (num_heads x capacity x head_dim)
+} KVCache;
+
+/**
+ * @brief Allocates an empty cache for num_heads heads of head_dim floats.
+ *
+ * @return The cache, or NULL if an argument is invalid or allocation fails.
+ */
+KVCache* create_kv_cache(int num_heads, int head_dim, int capacity);
+
+/**
+ * @brief Frees the cache and its key/value storage.
+ */
+void free_kv_cache(KVCache* cache);
+
+/**
+ * @brief Forgets every cached position so a new sequence can start.
+ */
+void kv_cache_reset(KVCache* cache);
+
+/**
+ * @brief Appends one token's keys and values.
+ *
+ * key and value hold num_heads * head_dim floats laid out token-major
+ * (head h at offset h * head_dim), as produced by the QKV projection.
+ *
+ * @return The ring slot the token was written to.
+ */
+int kv_cache_append(KVCache* cache, const float* key, const float* value);
+
+/**
+ * @brief Returns the cached keys of one head (capacity x head_dim, row stride head_dim).
+ */
+float* kv_cache_keys(const KVCache* cache, int head);
+
+/**
+ * @brief Returns the cached values of one head (capacity x head_dim, row stride head_dim).
+ */
+float* kv_cache_values(const KVCache* cache, int head);
+
+#endif // KV_CACHE_H
@@ -5,11 +5,50 @@
 #include <stdlib.h>
 #include <math.h>
 #include "utils.h"
+#include "kv_cache.h"
+#include "tensor.h"
 
 #define VOCAB_SIZE 1000
 #define EMBEDDING_DIM 512
 #define MAX_SEQ_LENGTH 128
 
+// Structure to hold a (multi-head) self-attention layer: its trainable weights
+// plus a workspace sized for max_seq_length, so forward passes never allocate.
+// The workspace grows linearly with max_seq_length: attention scores are
+// computed tile by tile (see attention.h) and never stored as a full matrix.
+// The query, key and value weights are stored side by side as one
+// embedding_dim x (3 * embedding_dim) matrix [W_Q | W_K | W_V], so a single
+// GEMM produces Q, K and V. Q, K and V are views into the QKV workspace and
+// have a row stride of 3 * embedding_dim; head h owns columns
+// h * head_dim .. (h + 1) * head_dim - 1 of each.
+typedef struct {
+    int embedding_dim;
+    int num_heads;
+    int head_dim;    // embedding_dim / num_heads
+    int max_seq_length;
+    long workspace_rows;  // Rows the workspace holds (max_seq_length, more after batched calls)
+    float* W_QKV;    // Fused query/key/value weights (embedding_dim x 3 * embedding_dim)
+    float* W_O;      // Output projection (embedding_dim x embedding_dim), NULL for a single head
+    float* QKV;      // Workspace: fused projections (workspace_rows x 3 * embedding_dim)
+    float* Q;        // View into QKV: queries (columns 0 .. embedding_dim - 1)
+    float* K;        // View into QKV: keys
+    float* V;        // View into QKV: values
+    float* heads;    // Workspace: head-major Q, K, V (3 x sequences x num_heads x seq x head_dim)
+    float* context;  // Workspace: concatenated head outputs (workspace_rows x embedding_dim)
+} SelfAttentionLayer;
+
+// Structure to hold the position-wise feed forward block used by feed_forward():
+// two float linear layers with a ReLU in between, plus a layer-owned workspace
+typedef struct {
+    int embedding_dim;
+    int ff_dim;
+    int max_seq_length;
+    long workspace_rows;   // Rows the workspace holds (max_seq_length, more after batched calls)
+    float* W1;             // First layer weights (embedding_dim x ff_dim)
+    float* W2;             // Second layer weights (ff_dim x embedding_dim)
+    float* intermediate;   // Workspace: hidden activations (workspace_rows x ff_dim)
+} FeedForwardBlock;
+
 // FUNCTION PROTOTYPES
 
 // Initialize the token embedding matrix.
@@ -27,13 +66,67 @@ void concatenate_embeddings(float token_embedding[EMBEDDING_DIM], float position
 // Initialize a weight matrix with random values.
 void initialize_weight_matrix(float weight[EMBEDDING_DIM][EMBEDDING_DIM]);
 
+// Create a single-head self-attention layer with randomly initialized weights.
+SelfAttentionLayer* create_self_attention_layer(int embedding_dim, int max_seq_length);
+
+// Create a multi-head attention layer; num_heads must divide embedding_dim.
+// With more than one head the concatenated head outputs go through an output projection W_O.
+SelfAttentionLayer* create_multi_head_attention_layer(int embedding_dim, int num_heads, int max_seq_length);
+
+// Copy separate embedding_dim x embedding_dim query, key and value weights into the fused matrix.
+void self_attention_set_weights(SelfAttentionLayer* layer, const float* W_Q, const float* W_K, const float* W_V);
+
+// Free the self-attention layer.
+void free_self_attention_layer(SelfAttentionLayer* layer);
+
+// Forward pass: input and output are seq_length x embedding_dim, row-major.
+// Heads are processed in parallel across the OpenMP worker team.
+void self_attention_forward(SelfAttentionLayer* layer, const float* input, float* output, int seq_length);
+
+// Create a key/value cache that fits this layer's heads, holding up to capacity positions.
+KVCache* create_kv_cache_for_layer(const SelfAttentionLayer* layer, int capacity);
+
+// Causal forward pass over a prompt that also fills the cache; output is seq_length x embedding_dim.
+// Each prompt token attends to the cached prefix and to the prompt tokens up to itself.
+void self_attention_prefill(SelfAttentionLayer* layer, KVCache* cache, const float* input, float* output, int seq_length);
+
+// Decode one token: project only this token, append its key/value to the cache and attend over the cache.
+// token and output hold embedding_dim floats. Cost is linear in the number of cached positions.
+void self_attention_decode_step(SelfAttentionLayer* layer, KVCache* cache, const float* token, float* output);
+
+// Batched forward pass over a [batch, max_seq, embedding_dim] tensor; each sequence attends
+// only to its first lengths[b] rows and the padding rows of the output are zeroed.
+void self_attention_forward_batch(SelfAttentionLayer* layer, const BatchTensor* input, BatchTensor* output);
+
 // Compute self-attention using trainable weight matrices for queries (Q), keys (K), and values (V).
+// Uses a shared default layer created on first call; not safe to call from several threads at once.
 void self_attention(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length);
 
+// Create a feed forward block with randomly initialized weights.
+FeedForwardBlock* create_feed_forward_block(int embedding_dim, int ff_dim, int max_seq_length);
+
+// Free the feed forward block.
+void free_feed_forward_block(FeedForwardBlock* block);
+
+// Forward pass: input and output are seq_length x embedding_dim, row-major.
+// scratch must hold seq_length x ff_dim floats, or be NULL to use the block's own workspace
+// (grown on first use if seq_length exceeds it).
+void feed_forward_block_forward(FeedForwardBlock* block, const float* input, float* output, int seq_length, float* scratch);
+
+// Batched forward pass over a [batch, max_seq, embedding_dim] tensor; padding rows of the output are zeroed.
+void feed_forward_block_forward_batch(FeedForwardBlock* block, const BatchTensor* input, BatchTensor* output);
+
 // A feed forward layer composed of two linear transformations with a ReLU activation in between.
+// Uses a shared default block created on first call; not safe to call from several threads at once.
 void feed_forward(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length);
 
 // Apply layer normalization over the input.
 void layer_normalization(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length);
 
+// Apply layer normalization to each of rows rows of dim values.
+void layer_normalization_rows(const float* input, float* output, int rows, int dim);
+
+// Apply layer normalization to every real token of a batch; padding rows of the output are zeroed.
+void layer_normalization_batch(const BatchTensor* input, BatchTensor* output);
+
 #endif // TRANSFORMER_ATTENTION_H
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef TENSOR_H
+#define TENSOR_H
+
+#include <stdlib.h>
+
+/**
+ * @brief A minibatch of float sequences laid out as [batch, max_seq, dim].
+ *
+ * Sequence b occupies rows [b * max_seq, (b + 1) * max_seq) of one contiguous
+ * row-major block, so the whole batch can go through a linear layer as a
+ * single (batch * max_seq) x dim matrix. Sequences are right-padded: row i of
+ * sequence b is a real token when i < lengths[b] and padding otherwise.
+ */
+typedef struct {
+    int batch;
+    int max_seq;
+    int dim;
+    int* lengths;   // Valid length of each sequence (0 .. max_seq)
+    float* data;    // batch x max_seq x dim values
+    size_t capacity;        // Number of floats data can hold
+    int batch_capacity;     // Number of entries lengths can hold
+} BatchTensor;
+
+/**
+ * @brief Allocates a zero-filled tensor whose sequences all have length 0.
+ *
+ * @return The tensor, or NULL if an argument is invalid or allocation fails.
+ */
+BatchTensor* create_batch_tensor(int batch, int max_seq, int dim);
+
+/**
+ * @brief Frees the tensor and its storage.
+ */
+void free_batch_tensor(BatchTensor* tensor);
+
+/**
+ * @brief Changes the batch size and sequence length of a tensor, reusing its
+ *        storage when it is large enough (a batch of short sequences then
+ *        goes through the layers as a short [batch, max_seq, dim] block).
+ *
+ * Every length is reset to 0 and the values are left undefined.
+ *
+ * @return 1 on success, 0 if an argument is invalid or allocation fails
+ *         (the tensor is unchanged).
+ */
+int batch_tensor_reshape(BatchTensor* tensor, int batch, int max_seq);
+
+/**
+ * @brief Returns a pointer to row i of sequence b.
+ */
+float* batch_tensor_row(const BatchTensor* tensor, int b, int i);
+
+/**
+ * @brief Sets the valid length of sequence b (clamped to [0, max_seq]).
+ */
+void batch_tensor_set_length(BatchTensor* tensor, int b, int length);
+
+/**
+ * @brief Copies the per-sequence lengths of src into dst (same batch size).
+ */
+void batch_tensor_copy_lengths(BatchTensor* dst, const BatchTensor* src);
+
+/**
+ * @brief Zeroes every padding row, so padded positions hold defined values.
+ */
+void batch_tensor_clear_padding(BatchTensor* tensor);
+
+/**
+ * @brief Writes the padding mask: mask[b * max_seq + i] is 1 for tokens, 0 for padding.
+ */
+void batch_tensor_fill_mask(const BatchTensor* tensor, unsigned char* mask);
+
+/**
+ * @brief Returns the number of real (non-padding) tokens in the batch.
+ */
+long batch_tensor_num_tokens(const BatchTensor* tensor);
+
+#endif // TENSOR_H
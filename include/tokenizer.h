@@ -6,35 +6,56 @@
 #include <string.h>
 #include <ctype.h>
 
-/* Define hash table size */
-#define TABLE_SIZE 100000
+#include "checkpoint.h"
+#include "vocab.h"
+
+/* Number of words the vocabulary is first sized for (it grows as needed) */
+#define TOKENIZER_INITIAL_WORDS 4096
+
+/* Number of values in one word embedding */
+#define TOKEN_EMBEDDING_DIM 2
+
+/* Flags of tokenizeText */
+#define TOKENIZE_ADD_WORDS 1   // Insert new words (with a random embedding) instead of mapping them to 0
 
 /**
- * @brief Structure representing a word token in the hash table.
- *
- * This structure stores a dynamically allocated word string,
- * a unique token ID, and a pointer for chaining nodes
- * (to handle hash collisions).
+ * Token IDs of a corpus, sentence after sentence in one contiguous buffer.
+ * Sentence s is ids[sentence_starts[s] .. sentence_starts[s + 1]).
  */
-typedef struct word_token_node {
-    char *word;                         /**< Dynamically allocated string for the word */
-    unsigned int token_id;              /**< Unique token ID assigned to this word */
-    struct word_token_node *next;       /**< Pointer to the next node in case of hash collisions */
-    float embedding[2];                 /**< 2-element word embedding vector */
-} word_token_node;
+typedef struct {
+    uint32_t* ids;
+    size_t num_ids;
+    size_t ids_capacity;
+    size_t* sentence_starts;     // num_sentences + 1 entries
+    size_t num_sentences;
+    size_t sentences_capacity;
+} TokenizedCorpus;
 
 /* Global variables */
 
-/** Global hash table to store unique word tokens. */
-extern word_token_node* hashTable[TABLE_SIZE];
+/**
+ * Global vocabulary: an open-addressing index of unique words with token
+ * IDs from 1 (see vocab.h). Created on the first insertion.
+ */
+extern Vocab* vocabulary;
 
-/** Global token counter used to generate unique token IDs. */
+/** Global token counter: the token ID the next new word will receive. */
 extern int global_token;
 
-/* Hash table functions */
+/**
+ * Dense embedding table indexed by token ID: row t holds the
+ * TOKEN_EMBEDDING_DIM values of token t, contiguously. Row 0 is the
+ * padding token and stays zero. It has a row for every word in vocabulary.
+ */
+extern float* embedding_table;
+
+/** Number of rows allocated (or mapped) in embedding_table. */
+extern int embedding_table_capacity;
+
+/* Vocabulary functions */
 
 /**
- * @brief Computes a hash value for a given word using the DJB2 algorithm.
+ * @brief Computes the vocabulary hash of a word.
  *
  * @param word The input word string.
  * @return An unsigned int hash value.
@@ -42,7 +63,20 @@ extern int global_token;
 unsigned int hash(const char* word);
 
 /**
- * @brief Inserts a word into the global hash table.
+ * @brief Looks up a word, adding it to the vocabulary if it is new.
+ *
+ * The word is hashed and probed once. A new word gets the next token ID and
+ * a zero row in embedding_table, which the caller may fill in place.
+ *
+ * @param word The word (need not be NUL-terminated).
+ * @param length Length of the word in bytes.
+ * @param inserted Set to 1 if the word was added, 0 otherwise (may be NULL).
+ * @return The token ID, or 0 if the vocabulary could not grow.
+ */
+unsigned int lookupOrInsertWord(const char* word, size_t length, int* inserted);
+
+/**
+ * @brief Inserts a word into the global vocabulary.
  *
  * If the word is not already present, this function stores the word
  * along with a unique token ID.
@@ -52,7 +86,7 @@ unsigned int hash(const char* word);
 void insertWord(const char* word);
 
 /**
- * @brief Checks if a word is already present in the global hash table.
+ * @brief Checks if a word is already present in the global vocabulary.
  *
  * @param word The word to check.
  * @return 1 if the word is found, 0 otherwise.
@@ -63,12 +97,42 @@ int isWordPresent(const char* word);
  * @brief Extracts unique words from an array of sentences.
  *
  * This function processes the given sentences and inserts each unique
- * word into the global hash table.
+ * word into the global vocabulary, with a random embedding.
  *
  * @param sentences A NULL-terminated array of sentence strings.
  */
 void extractUniqueWords(char** sentences);
 
+/**
+ * @brief Extracts unique words from an array of sentences on several threads.
+ *
+ * The sentences are split into shards that are counted concurrently into
+ * thread-local vocabularies and then merged in order, so token IDs, counts
+ * and embeddings are the same as extractUniqueWords gives, for any thread count.
+ *
+ * @param sentences A NULL-terminated array of sentence strings.
+ * @param num_threads Number of threads, or 0 for every thread OpenMP offers.
+ * @return 1 on success, 0 if memory ran out.
+ */
+int extractUniqueWordsParallel(char** sentences, int num_threads);
+
+/**
+ * @brief Finds the next word of a NUL-terminated string.
+ *
+ * Reentrant replacement for strtok with the vocabulary delimiters: the
+ * string is not modified and any number of threads may scan at once.
+ *
+ * @param cursor Scan position; advanced past the word.
+ * @param word Set to the start of the word.
+ * @return The word length, or 0 when the string has no more words.
+ */
+size_t nextWord(const char** cursor, const char** word);
+
+/**
+ * @brief Returns how many times extractUniqueWords has seen a token ID.
+ */
+unsigned long getTokenCount(unsigned int token_id);
+
 /**
  * @brief Retrieves the token ID for a given word.
  *
@@ -78,7 +142,7 @@ void extractUniqueWords(char** sentences);
 unsigned int getTokenId(const char* word);
 
 /**
- * @brief Prints all unique words stored in the hash table along with their token IDs.
+ * @brief Prints all unique words in the vocabulary along with their token IDs.
  */
 void Print_Tokens_And_Ids(void);
 
@@ -107,18 +171,121 @@ float** Word_Embedding_Generation(int token_id);
  * @brief Retrieves the word embedding for a given token ID.
  *
  * @param token_id The token ID.
- * @return A pointer to a float array representing the embedding.
+ * @return A pointer to the token's row of embedding_table, or NULL if the
+ *         ID has no row. The pointer is invalidated when the table grows.
  */
 float* getEmbedding(unsigned int token_id);
 
+/**
+ * @brief Stores the word embedding of a token in the embedding table.
+ *
+ * @param token_id The token ID (must be non-zero).
+ * @param embedding TOKEN_EMBEDDING_DIM values.
+ * @return 1 on success, 0 if the table could not grow.
+ */
+int setEmbedding(unsigned int token_id, const float* embedding);
+
+/**
+ * @brief Gathers the embeddings of a token sequence into a matrix in one call.
+ *
+ * Row i of output receives the embedding of token_ids[i]; padding (0) and
+ * unknown IDs give zero rows.
+ *
+ * @param token_ids The token sequence.
+ * @param count Number of tokens.
+ * @param output A count x TOKEN_EMBEDDING_DIM row-major matrix.
+ */
+void gatherEmbeddings(const int* token_ids, int count, float* output);
+
+/**
+ * @brief Describes the embedding table as a checkpoint tensor named name, for checkpoint_save.
+ *
+ * The tensor covers IDs 0 .. global_token - 1.
+ *
+ * @return 1 on success, 0 otherwise.
+ */
+int embeddingTableCheckpointTensor(const char* name, CheckpointTensor* tensor);
+
+/**
+ * @brief Points the embedding table at an F32 [vocab][TOKEN_EMBEDDING_DIM]
+ *        checkpoint tensor without copying it.
+ *
+ * The checkpoint must stay mapped while bound, and must be mapped with
+ * CHECKPOINT_MAP_WRITABLE if embeddings are updated. The table is copied
+ * out of the checkpoint if it has to grow.
+ *
+ * @return 1 on success, 0 if the tensor is missing or has the wrong shape.
+ */
+int bindEmbeddingTableToCheckpoint(const Checkpoint* checkpoint, const char* name);
+
+/**
+ * @brief Creates an empty tokenized corpus.
+ *
+ * @return The corpus, or NULL if allocation fails.
+ */
+TokenizedCorpus* createTokenizedCorpus(void);
+
+/**
+ * @brief Frees a tokenized corpus.
+ */
+void freeTokenizedCorpus(TokenizedCorpus* corpus);
+
+/**
+ * @brief Splits, cleans and tokenizes raw text in one pass, appending to corpus.
+ *
+ * The result is the one SplitSentences, Cleaned_Text (CLEAN_TEXT_ASCII) and
+ * nextWord would give, followed by a token ID lookup per word, but every
+ * input byte is read once and no cleaned copy is made. Sentences with no
+ * words are kept, with no IDs. The end of text ends the last sentence, so
+ * text may be a whole file, a chunk ending on a sentence boundary, or the
+ * sentences of a CorpusReader one at a time.
+ *
+ * @param flags TOKENIZE_ADD_WORDS to add new words to the vocabulary (counted,
+ *        with random embeddings, as extractUniqueWords does); without it,
+ *        unknown words get token ID 0.
+ * @return 1 on success, 0 if memory runs out.
+ */
+int tokenizeText(TokenizedCorpus* corpus, const char* text, size_t length, int flags);
+
+/**
+ * @brief Saves the vocabulary (words, IDs and hash slots), the embedding
+ *        table and the token counts to a snapshot file.
+ *
+ * @return 1 on success, 0 otherwise.
+ */
+int saveTokenizerSnapshot(const char* path);
+
+/**
+ * @brief Replaces the tokenizer state with a snapshot written by saveTokenizerSnapshot.
+ *
+ * The file is memory-mapped and the vocabulary index and embedding table are
+ * used in place, without rehashing or copying; they are copied out only if
+ * the vocabulary or the table grows. Token IDs and embeddings are exactly the
+ * saved ones, so results no longer depend on rand() order across runs.
+ *
+ * @return 1 on success, 0 if the file is missing or invalid (the current state is kept).
+ */
+int loadTokenizerSnapshot(const char* path);
+
+/**
+ * @brief Releases the vocabulary; token IDs start again from 1.
+ */
+void freeVocabulary(void);
+
+/**
+ * @brief Releases the embedding table (or unbinds it from its checkpoint).
+ */
+void freeEmbeddingTable(void);
+
 /**
  * @brief Retrieves the word embedding for a given token ID into a fixed-size array.
  *
- * The result is stored in the provided expected_embedding array.
+ * The result is stored in the provided expected_embedding array; this is a
+ * direct row read from embedding_table.
  *
  * @param token_id The token ID.
  * @param expected_embedding An array (of size 2) in which the embedding will be stored.
  */
-void getEmbeddingByTokenId(unsigned int token_id, double expected_embedding[2]);
+void getEmbeddingByTokenId(unsigned int token_id, double expected_embedding[TOKEN_EMBEDDING_DIM]);
 
 #endif /* TOKENIZER_H */
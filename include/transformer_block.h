@@ -4,6 +4,8 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include "checkpoint.h"
+
 // FUNCTION TO COMPUTE POSITIONAL ENCODING
 double* positional_encoding(int index, int vector_size);
 
@@ -11,10 +13,10 @@ double* positional_encoding(int index, int vector_size);
 #define EMBEDDING_DIM 2
 #define CLIP_THRESHOLD 100
 
-// DEFINE MATRICES
-extern double k_matrix[MATRIX_SIZE][MATRIX_SIZE];
-extern double q_matrix[MATRIX_SIZE][MATRIX_SIZE];
-extern double v_matrix[MATRIX_SIZE][MATRIX_SIZE];
+// DEFINE MATRICES (ROWS OF MATRIX_SIZE VALUES; STATIC STORAGE OR A MAPPED CHECKPOINT)
+extern double (*k_matrix)[MATRIX_SIZE];
+extern double (*q_matrix)[MATRIX_SIZE];
+extern double (*v_matrix)[MATRIX_SIZE];
 
 // FUNCTION TO READ A SINGLE VALUE FROM A FILE
 double read_single_value_from_file(const char* filename);
@@ -22,6 +24,17 @@ double read_single_value_from_file(const char* filename);
 // FUNCTION TO INITIALIZE MATRICES FROM FILES
 void initialize_matrices_from_files(void);
 
+// FUNCTION TO INITIALIZE MATRICES FROM A BINARY CHECKPOINT (RETURNS 1 ON SUCCESS)
+int initialize_matrices_from_checkpoint(const Checkpoint* checkpoint);
+
+// FUNCTION TO POINT THE MATRICES AT A MAPPED CHECKPOINT WITHOUT COPYING (RETURNS 1 ON SUCCESS)
+// THE CHECKPOINT MUST STAY MAPPED WHILE BOUND, AND MUST BE MAPPED WITH CHECKPOINT_MAP_WRITABLE
+// IF THE MATRICES ARE TRAINED (update_attention_matrices WRITES THEM)
+int bind_attention_matrices_to_checkpoint(const Checkpoint* checkpoint);
+
+// FUNCTION TO POINT THE MATRICES BACK AT THEIR STATIC STORAGE
+void unbind_attention_matrices(void);
+
 // FUNCTION TO PRINT A MATRIX
 void print_matrix(const char* name, double matrix[MATRIX_SIZE][MATRIX_SIZE]);
 
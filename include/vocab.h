@@ -0,0 +1,124 @@
+#ifndef VOCAB_H
+#define VOCAB_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "checkpoint.h"
+
+/**
+ * @brief One slot of the vocabulary index (16 bytes, four per cache line).
+ *
+ * hash is the full 32-bit hash of the word (0 marks an empty slot), so a
+ * probe only touches the string arena when hashes and lengths agree.
+ */
+typedef struct {
+    uint32_t hash;
+    uint32_t token_id;
+    uint32_t offset;   // Start of the word in the string arena
+    uint32_t length;   // Word length in bytes, without the terminating NUL
+} VocabSlot;
+
+/**
+ * @brief Open-addressing vocabulary index with Robin Hood probing.
+ *
+ * Words are interned into a single string arena, NUL-terminated and in
+ * token-id order, so the index holds no per-word allocations. Token ids
+ * start at 1 (0 means "not found" and is the padding token). The slot array
+ * is a power of two and doubles when it reaches VOCAB_MAX_LOAD; stored hashes
+ * make rehashing a pass over the slots that never reads a word.
+ */
+typedef struct {
+    VocabSlot* slots;
+    uint32_t capacity;       // Number of slots (power of two)
+    uint32_t count;          // Number of words
+    char* arena;             // Interned words
+    size_t arena_size;
+    size_t arena_capacity;
+    uint32_t* word_offsets;  // Arena offset of each token id (index 0 unused)
+    uint32_t offsets_capacity;
+    int owns_memory;         // 0 while slots, arena and offsets are checkpoint views
+} Vocab;
+
+// THE INDEX GROWS WHEN count / capacity WOULD EXCEED THIS FRACTION
+#define VOCAB_MAX_LOAD_NUM 7
+#define VOCAB_MAX_LOAD_DEN 8
+
+// BUMPED WHENEVER vocab_hash OR VocabSlot CHANGES, SO OLD SNAPSHOTS ARE REJECTED
+#define VOCAB_HASH_VERSION 1
+
+// NUMBER OF TENSORS WRITTEN BY vocab_checkpoint_tensors
+#define VOCAB_CHECKPOINT_TENSORS 4
+
+/**
+ * @brief Creates an empty vocabulary sized for about expected_words words.
+ *
+ * @return The vocabulary, or NULL if allocation fails.
+ */
+Vocab* create_vocab(size_t expected_words);
+
+/**
+ * @brief Frees the vocabulary, its index and its arena.
+ */
+void free_vocab(Vocab* vocab);
+
+/**
+ * @brief Hashes length bytes of word (case sensitive, never returns 0).
+ */
+uint32_t vocab_hash(const char* word, size_t length);
+
+/**
+ * @brief Looks up a word of length bytes (it need not be NUL-terminated).
+ *
+ * @return Its token id, or 0 if it is not in the vocabulary.
+ */
+uint32_t vocab_find(const Vocab* vocab, const char* word, size_t length);
+
+/**
+ * @brief Returns the token id of a word, inserting it with the next id if new.
+ *
+ * The word is hashed and probed once whether or not it is already present.
+ *
+ * @param inserted Set to 1 if the word was added, 0 if it was present (may be NULL).
+ * @return The token id, or 0 if the vocabulary could not grow.
+ */
+uint32_t vocab_lookup_or_insert(Vocab* vocab, const char* word, size_t length, int* inserted);
+
+/**
+ * @brief Returns the NUL-terminated word of a token id, or NULL if the id is unknown.
+ *
+ * The pointer is invalidated when the vocabulary grows.
+ */
+const char* vocab_word(const Vocab* vocab, uint32_t token_id);
+
+/**
+ * @brief Returns the length in bytes of the word of a token id (0 if unknown).
+ */
+size_t vocab_word_length(const Vocab* vocab, uint32_t token_id);
+
+/**
+ * @brief Describes the vocabulary as checkpoint tensors named <prefix>.meta,
+ *        <prefix>.slots, <prefix>.arena and <prefix>.offsets, for checkpoint_save.
+ *
+ * The slot array is written as is, so a loaded vocabulary needs no rehashing.
+ *
+ * @param tensors Receives VOCAB_CHECKPOINT_TENSORS entries.
+ * @return VOCAB_CHECKPOINT_TENSORS, or 0 on error.
+ */
+int vocab_checkpoint_tensors(const Vocab* vocab, const char* prefix, CheckpointTensor* tensors);
+
+/**
+ * @brief Creates a vocabulary on top of the tensors written by vocab_checkpoint_tensors.
+ *
+ * Lookups run directly on the checkpoint views, which must stay mapped for
+ * the life of the vocabulary. The first insertion copies the index and the
+ * arena out of the checkpoint. Every occupied slot is checked against the
+ * word offsets and the arena, so a damaged snapshot is rejected here rather
+ * than read out of bounds by a later lookup.
+ *
+ * @return The vocabulary, or NULL if the tensors are missing, inconsistent or
+ *         were written with a different VOCAB_HASH_VERSION.
+ */
+Vocab* create_vocab_from_checkpoint(const Checkpoint* checkpoint, const char* prefix);
+
+#endif // VOCAB_H
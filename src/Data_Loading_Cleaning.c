@@ -2,9 +2,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <stdint.h>
 
 #include "../include/Data_Loading_Cleaning.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TEXT_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
 // READ THE ENTIRE CONTENTS OF A FILE INTO A DYNAMICALLY ALLOCATED STRING
 char* readFileToString(const char *filename){
     // Open the file in read mode
@@ -40,67 +51,557 @@ char* readFileToString(const char *filename){
     return fileContent;
 }
 
+// SENTENCE-ENDING PUNCTUATION MARKS, AS SPLIT ON BY SplitSentences
+static const unsigned char is_sentence_end[256] = { ['.'] = 1, ['!'] = 1, ['?'] = 1 };
+
+// FIND THE FIRST SENTENCE DELIMITER IN text[from, end), OR end IF THERE IS NONE
+static size_t find_sentence_end_scalar(const char *text, size_t from, size_t end){
+    while (from < end && !is_sentence_end[(unsigned char)text[from]]) {
+        from++;
+    }
+    return from;
+}
+
+#ifdef TEXT_SIMD_X86
+// 32 bytes per step: compare against each delimiter, OR the masks, take the lowest set bit
+__attribute__((target("avx2")))
+static size_t find_sentence_end_avx2(const char *text, size_t from, size_t end){
+    const __m256i period = _mm256_set1_epi8('.');
+    const __m256i exclamation = _mm256_set1_epi8('!');
+    const __m256i question = _mm256_set1_epi8('?');
+
+    for (; from + 32 <= end; from += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)(text + from));
+        __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, period),
+                                                        _mm256_cmpeq_epi8(bytes, exclamation)),
+                                       _mm256_cmpeq_epi8(bytes, question));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(hits);
+        if (mask != 0) {
+            return from + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return find_sentence_end_scalar(text, from, end);
+}
+
+// CHECK FOR AVX2 (AND BMI2, USED BY THE CLEANER) ONCE; THE SSE2 VERSIONS ARE USED OTHERWISE
+// TRANSFORMER_ISA=scalar or sse4 (as for the math kernels) also selects SSE2.
+static int cpu_has_avx2(void){
+    static int has_avx2 = -1;
+    if (has_avx2 < 0) {
+        const char* forced = getenv("TRANSFORMER_ISA");
+        __builtin_cpu_init();
+        has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2") &&
+                   !(forced != NULL && (strcmp(forced, "scalar") == 0 || strcmp(forced, "sse4") == 0));
+    }
+    return has_avx2;
+}
+
+// SSE2 IS PART OF THE x86-64 BASELINE, SO THIS NEEDS NO CPU CHECK
+__attribute__((target("sse2")))
+static size_t find_sentence_end_sse2(const char *text, size_t from, size_t end){
+    const __m128i period = _mm_set1_epi8('.');
+    const __m128i exclamation = _mm_set1_epi8('!');
+    const __m128i question = _mm_set1_epi8('?');
+
+    for (; from + 16 <= end; from += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(text + from));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, period), _mm_cmpeq_epi8(bytes, exclamation)),
+                                    _mm_cmpeq_epi8(bytes, question));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return from + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return find_sentence_end_scalar(text, from, end);
+}
+#endif
+
+// PICK THE WIDEST DELIMITER SCAN THE CPU SUPPORTS
+static size_t find_sentence_end(const char *text, size_t from, size_t end){
+#ifdef TEXT_SIMD_X86
+    return cpu_has_avx2() ? find_sentence_end_avx2(text, from, end) : find_sentence_end_sse2(text, from, end);
+#else
+    return find_sentence_end_scalar(text, from, end);
+#endif
+}
+
+// FIND THE NEXT NON-EMPTY SENTENCE AT OR AFTER *cursor
+int nextSentenceSpan(const char *text, size_t size, size_t *cursor, SentenceSpan *span){
+    size_t start = *cursor;
+    while (start < size && is_sentence_end[(unsigned char)text[start]]) {
+        start++;
+    }
+    if (start >= size) {
+        *cursor = size;
+        return 0;
+    }
+
+    size_t stop = find_sentence_end(text, start, size);
+    span->offset = start;
+    span->length = stop - start;
+    *cursor = (stop < size) ? stop + 1 : size;
+    return 1;
+}
+
+// MOVE position FORWARD TO THE START OF THE SENTENCE THAT BEGINS AT OR AFTER IT
+size_t alignSentenceStart(const char *text, size_t size, size_t position){
+    if (position == 0 || position >= size || is_sentence_end[(unsigned char)text[position - 1]]) {
+        return position < size ? position : size;
+    }
+    size_t stop = find_sentence_end(text, position, size);
+    return (stop < size) ? stop + 1 : size;
+}
+
+// SPANS OF THE SENTENCES STARTING IN ONE BYTE RANGE
+typedef struct {
+    SentenceSpan* spans;
+    size_t count;
+    size_t capacity;
+} SpanRange;
+
+// COLLECT THE SENTENCES THAT START IN text[begin, end)
+static int collect_sentence_spans(const char *text, size_t size, size_t begin, size_t end, SpanRange *range){
+    size_t cursor = alignSentenceStart(text, size, begin);
+    SentenceSpan span;
+
+    while (cursor < end && nextSentenceSpan(text, size, &cursor, &span) && span.offset < end) {
+        if (range->count == range->capacity) {
+            size_t capacity = range->capacity > 0 ? range->capacity * 2 : 64;
+            SentenceSpan* spans = (SentenceSpan*)realloc(range->spans, capacity * sizeof(SentenceSpan));
+            if (spans == NULL) {
+                return 0;
+            }
+            range->spans = spans;
+            range->capacity = capacity;
+        }
+        range->spans[range->count++] = span;
+    }
+    return 1;
+}
+
+// SPLIT THE TEXT INTO SENTENCE SPANS, ONE BYTE RANGE PER TASK
+SentenceSpan* SplitSentenceSpans(const char *text, size_t size, size_t *count, int num_threads){
+    *count = 0;
+    if (text == NULL) {
+        return NULL;
+    }
+
+#ifdef _OPENMP
+    if (num_threads <= 0) num_threads = omp_get_max_threads();
+#else
+    num_threads = 1;
+#endif
+    // A few ranges per thread so uneven sentence lengths still balance
+    int num_ranges = (num_threads > 1 && size >= 4096) ? num_threads * 4 : 1;
+    SpanRange* ranges = (SpanRange*)calloc(num_ranges, sizeof(SpanRange));
+    if (ranges == NULL) {
+        return NULL;
+    }
+
+    int ok = 1;
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads) reduction(&& : ok) if(num_ranges > 1)
+    for (int r = 0; r < num_ranges; r++) {
+        size_t begin = size / num_ranges * r;
+        size_t end = (r == num_ranges - 1) ? size : size / num_ranges * (r + 1);
+        ok = collect_sentence_spans(text, size, begin, end, &ranges[r]) && ok;
+    }
+
+    // Concatenate the ranges in text order
+    size_t total = 0;
+    for (int r = 0; r < num_ranges; r++) total += ranges[r].count;
+    SentenceSpan* spans = ok ? (SentenceSpan*)malloc((total > 0 ? total : 1) * sizeof(SentenceSpan)) : NULL;
+    if (spans != NULL) {
+        size_t position = 0;
+        for (int r = 0; r < num_ranges; r++) {
+            if (ranges[r].count > 0) {
+                memcpy(spans + position, ranges[r].spans, ranges[r].count * sizeof(SentenceSpan));
+            }
+            position += ranges[r].count;
+        }
+        *count = total;
+    } else {
+        fprintf(stderr, "Memory allocation failed for sentence spans.\n");
+    }
+
+    for (int r = 0; r < num_ranges; r++) free(ranges[r].spans);
+    free(ranges);
+    return spans;
+}
+
+// OPEN A CORPUS FILE FOR SEQUENTIAL, CHUNKED READING
+CorpusReader* openCorpusReader(const char *filename, size_t chunk_size){
+    CorpusReader* reader = (CorpusReader*)calloc(1, sizeof(CorpusReader));
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    reader->capacity = (chunk_size > 0) ? chunk_size : CORPUS_CHUNK_SIZE;
+    reader->buffer = (char*)malloc(reader->capacity + 1);
+    reader->file = fopen(filename, "rb");
+    if (reader->buffer == NULL || reader->file == NULL) {
+        if (reader->file == NULL) perror("Error opening file");
+        closeCorpusReader(reader);
+        return NULL;
+    }
+
+    // Reads go straight into our buffer, and the kernel can read ahead aggressively
+    setvbuf(reader->file, NULL, _IONBF, 0);
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fileno(reader->file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return reader;
+}
+
+// RETURN THE NEXT NON-EMPTY SENTENCE, READING MORE OF THE FILE WHEN THE BUFFER RUNS OUT
+char* nextCorpusSentence(CorpusReader* reader, size_t* length){
+    if (reader == NULL || reader->error) {
+        return NULL;
+    }
+
+    for (;;) {
+        char* buffer = reader->buffer;
+
+        // Skip the delimiters left by the previous sentence (empty sentences)
+        while (reader->start < reader->end && is_sentence_end[(unsigned char)buffer[reader->start]]) {
+            reader->start++;
+        }
+        if (reader->scanned < reader->start) {
+            reader->scanned = reader->start;
+        }
+
+        size_t i = find_sentence_end(buffer, reader->scanned, reader->end);
+        reader->scanned = i;
+
+        // A complete sentence, or the last one of a file without a final delimiter
+        if (i < reader->end || (reader->eof && reader->start < reader->end)) {
+            char* sentence = buffer + reader->start;
+            buffer[i] = '\0';
+            if (length != NULL) *length = i - reader->start;
+            reader->start = (i < reader->end) ? i + 1 : i;
+            reader->scanned = reader->start;
+            return sentence;
+        }
+        if (reader->eof) {
+            return NULL;
+        }
+
+        // Carry the partial sentence over to the front of the buffer
+        size_t carried = reader->end - reader->start;
+        memmove(buffer, buffer + reader->start, carried);
+        reader->start = 0;
+        reader->scanned = carried;
+        reader->end = carried;
+
+        // A sentence longer than the buffer: grow it
+        if (reader->end == reader->capacity) {
+            char* grown = (char*)realloc(buffer, reader->capacity * 2 + 1);
+            if (grown == NULL) {
+                fprintf(stderr, "Memory allocation failed for corpus buffer.\n");
+                reader->error = 1;
+                return NULL;
+            }
+            reader->buffer = grown;
+            reader->capacity *= 2;
+        }
+
+        size_t bytes = fread(reader->buffer + reader->end, 1, reader->capacity - reader->end, reader->file);
+        if (bytes == 0) {
+            if (ferror(reader->file)) {
+                perror("Error reading corpus");
+                reader->error = 1;
+                return NULL;
+            }
+            reader->eof = 1;
+        }
+        reader->end += bytes;
+        reader->bytes_read += bytes;
+    }
+}
+
+// CLOSE A CORPUS READER
+void closeCorpusReader(CorpusReader* reader){
+    if (reader == NULL) {
+        return;
+    }
+    if (reader->file != NULL) {
+        fclose(reader->file);
+    }
+    free(reader->buffer);
+    free(reader);
+}
+
 // SPLIT THE TEXT INTO SENTENCES BASED ON PUNCTUATION MARKS
 char** SplitSentences(char *raw_text){
-    const char *delimiters = ".!?";  // Sentence-ending punctuation marks
+    size_t count = 0;
+    SentenceSpan* spans = SplitSentenceSpans(raw_text, raw_text != NULL ? strlen(raw_text) : 0, &count, 1);
+    if (spans == NULL) {
+        return NULL;
+    }
 
-    // Allocate memory for up to 100 sentences
-    char **sentence = malloc(100 * sizeof(char*));
+    char **sentence = malloc((count + 1) * sizeof(char*));
     if (sentence == NULL) {
+        free(spans);
         return NULL;
     }
 
-    // Split the text into sentences using strtok
-    char *token = strtok(raw_text, delimiters);
-    int i = 0;
-
-    while(token != NULL && i < 99){  // Limit to 99 sentences to leave room for NULL terminator
+    for (size_t i = 0; i < count; i++) {
         // Allocate memory for the current sentence
-        sentence[i] = malloc((strlen(token) + 1) * sizeof(char));
+        sentence[i] = malloc(spans[i].length + 1);
         if (sentence[i] == NULL) {
             // Clean up previously allocated memory
-            for (int j = 0; j < i; j++) {
+            for (size_t j = 0; j < i; j++) {
                 free(sentence[j]);
             }
             free(sentence);
+            free(spans);
             return NULL;
         }
-        
-        strcpy(sentence[i], token);
-        i++;
-        token = strtok(NULL, delimiters);
+
+        memcpy(sentence[i], raw_text + spans[i].offset, spans[i].length);
+        sentence[i][spans[i].length] = '\0';
     }
-    
-    sentence[i] = NULL; // Null-terminate the array of sentences
+
+    sentence[count] = NULL; // Null-terminate the array of sentences
+    free(spans);
     return sentence;
 }
 
+// WHAT THE CLEANER WRITES FOR EACH BYTE (SEE Data_Loading_Cleaning.h)
+const unsigned char text_clean_table[256] = {
+    [' '] = ' ',
+    ['0'] = '0', ['1'] = '1', ['2'] = '2', ['3'] = '3', ['4'] = '4',
+    ['5'] = '5', ['6'] = '6', ['7'] = '7', ['8'] = '8', ['9'] = '9',
+    ['A'] = 'a', ['B'] = 'b', ['C'] = 'c', ['D'] = 'd', ['E'] = 'e', ['F'] = 'f', ['G'] = 'g',
+    ['H'] = 'h', ['I'] = 'i', ['J'] = 'j', ['K'] = 'k', ['L'] = 'l', ['M'] = 'm', ['N'] = 'n',
+    ['O'] = 'o', ['P'] = 'p', ['Q'] = 'q', ['R'] = 'r', ['S'] = 's', ['T'] = 't', ['U'] = 'u',
+    ['V'] = 'v', ['W'] = 'w', ['X'] = 'x', ['Y'] = 'y', ['Z'] = 'z',
+    ['a'] = 'a', ['b'] = 'b', ['c'] = 'c', ['d'] = 'd', ['e'] = 'e', ['f'] = 'f', ['g'] = 'g',
+    ['h'] = 'h', ['i'] = 'i', ['j'] = 'j', ['k'] = 'k', ['l'] = 'l', ['m'] = 'm', ['n'] = 'n',
+    ['o'] = 'o', ['p'] = 'p', ['q'] = 'q', ['r'] = 'r', ['s'] = 's', ['t'] = 't', ['u'] = 'u',
+    ['v'] = 'v', ['w'] = 'w', ['x'] = 'x', ['y'] = 'y', ['z'] = 'z',
+};
+
+#ifdef TEXT_SIMD_X86
+// AVX2 PATH: EVERY 16-BYTE BLOCK IS COMPACTED, NOT ONLY CLEAN ONES.
+// Letters, digits and spaces are the candidates. pext gathers the space bits
+// in candidate order, where a space is dropped if the candidate before it is
+// one; pdep scatters the survivors back to byte positions, and pshufb packs
+// the kept bytes of each half-block to the output, with shuffle indices
+// built from the keep mask by pdep/pext instead of a table. A block with bytes >= 0x80
+// in UTF-8 mode stops the run. The 8-byte stores never pass the end of the
+// block just loaded, so cleaning in place is safe.
+__attribute__((target("avx2,bmi2")))
+static size_t clean_run_avx2(const char *text, size_t length, char *output, size_t *written,
+                             int *last_was_space, int mode){
+    const __m128i lower_bit = _mm_set1_epi8(0x20);
+    const __m128i letter_a = _mm_set1_epi8('a');
+    const __m128i letter_span = _mm_set1_epi8(25);
+    const __m128i digit_0 = _mm_set1_epi8('0');
+    const __m128i digit_span = _mm_set1_epi8(9);
+    const __m128i high_half = _mm_set1_epi8(8);
+    size_t i = 0, j = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(text + i));
+        if (mode == CLEAN_TEXT_UTF8 && _mm_movemask_epi8(bytes) != 0) {
+            break;
+        }
+        __m128i lowered = _mm_or_si128(bytes, lower_bit);
+        __m128i letter = _mm_sub_epi8(lowered, letter_a);
+        __m128i digit = _mm_sub_epi8(bytes, digit_0);
+        __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, letter_span), letter);
+        __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, digit_span), digit);
+        __m128i is_space = _mm_cmpeq_epi8(bytes, lower_bit);
+
+        unsigned int candidates = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(is_letter, is_digit), is_space));
+        unsigned int spaces = (unsigned int)_mm_movemask_epi8(is_space);
+        unsigned int count = (unsigned int)__builtin_popcount(candidates);
+        if (count == 0) {
+            continue;
+        }
+
+        unsigned int packed_spaces = _pext_u32(spaces, candidates);
+        unsigned int repeated = packed_spaces & ((packed_spaces << 1) | (unsigned int)*last_was_space);
+        unsigned int kept = _pdep_u32(~repeated & ((1u << count) - 1), candidates);
+        *last_was_space = (int)((packed_spaces >> (count - 1)) & 1);
+
+        unsigned int low = kept & 0xFF, high = kept >> 8;
+        uint64_t low_bytes = _pdep_u64(low, 0x0101010101010101ULL) * 0xFF;
+        uint64_t high_bytes = _pdep_u64(high, 0x0101010101010101ULL) * 0xFF;
+        __m128i low_indices = _mm_cvtsi64_si128((long long)_pext_u64(0x0706050403020100ULL, low_bytes));
+        __m128i high_indices = _mm_add_epi8(_mm_cvtsi64_si128((long long)_pext_u64(0x0706050403020100ULL, high_bytes)),
+                                            high_half);
+        _mm_storel_epi64((__m128i*)(output + j), _mm_shuffle_epi8(lowered, low_indices));
+        j += (size_t)__builtin_popcount(low);
+        _mm_storel_epi64((__m128i*)(output + j), _mm_shuffle_epi8(lowered, high_indices));
+        j += (size_t)__builtin_popcount(high);
+    }
+    *written = j;
+    return i;
+}
+
+// SSE2 FAST PATH: A BLOCK MADE ONLY OF LETTERS, DIGITS AND SINGLE SPACES IS
+// CLEANED BY OR-ING 0x20 INTO EVERY BYTE (IT LOWERCASES LETTERS AND LEAVES
+// DIGITS AND SPACES ALONE). THE FIRST OTHER BLOCK STOPS THE RUN.
+__attribute__((target("sse2")))
+static size_t clean_run_sse2(const char *text, size_t length, char *output, int *last_was_space){
+    const __m128i lower_bit = _mm_set1_epi8(0x20);
+    const __m128i letter_a = _mm_set1_epi8('a');
+    const __m128i letter_span = _mm_set1_epi8(25);
+    const __m128i digit_0 = _mm_set1_epi8('0');
+    const __m128i digit_span = _mm_set1_epi8(9);
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(text + i));
+        __m128i lowered = _mm_or_si128(bytes, lower_bit);
+        __m128i letter = _mm_sub_epi8(lowered, letter_a);
+        __m128i digit = _mm_sub_epi8(bytes, digit_0);
+        __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, letter_span), letter);
+        __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, digit_span), digit);
+        __m128i is_space = _mm_cmpeq_epi8(bytes, lower_bit);
+
+        unsigned int kept = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(is_letter, is_digit), is_space));
+        unsigned int spaces = (unsigned int)_mm_movemask_epi8(is_space);
+        if (kept != 0xFFFFu || (spaces & (spaces >> 1)) != 0 || ((spaces & 1) && *last_was_space)) {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(output + i), lowered);
+        *last_was_space = (int)(spaces >> 15);
+    }
+    return i;
+}
+#endif
+
+// DECODE ONE WELL-FORMED UTF-8 SEQUENCE OF 2-4 BYTES (NO OVERLONG FORMS OR SURROGATES)
+// Returns its length, or 0 if the bytes at text are not one.
+static size_t decode_utf8(const unsigned char *text, size_t available, uint32_t *code_point){
+    unsigned char lead = text[0];
+    size_t length;
+    uint32_t value, minimum;
+
+    if (lead >= 0xC2 && lead <= 0xDF)      { length = 2; value = lead & 0x1F; minimum = 0x80; }
+    else if (lead >= 0xE0 && lead <= 0xEF) { length = 3; value = lead & 0x0F; minimum = 0x800; }
+    else if (lead >= 0xF0 && lead <= 0xF4) { length = 4; value = lead & 0x07; minimum = 0x10000; }
+    else return 0;
+
+    if (length > available) return 0;
+    for (size_t k = 1; k < length; k++) {
+        if ((text[k] & 0xC0) != 0x80) return 0;
+        value = (value << 6) | (text[k] & 0x3F);
+    }
+    if (value < minimum || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) return 0;
+
+    *code_point = value;
+    return length;
+}
+
+// IS A NON-ASCII CODE POINT PUNCTUATION, A SYMBOL OR A SPACE (DROPPED LIKE ASCII PUNCTUATION)?
+static int is_unicode_separator(uint32_t c){
+    return (c <= 0xBF) || c == 0xD7 || c == 0xF7 ||      // Latin-1 controls, punctuation and signs
+           (c >= 0x2000 && c <= 0x2BFF) ||                 // General punctuation, symbols, arrows, math
+           (c >= 0x3000 && c <= 0x303F) ||                 // CJK punctuation
+           (c >= 0xFE30 && c <= 0xFE4F) ||                 // CJK compatibility forms
+           (c >= 0xFF00 && c <= 0xFF0F) || c == 0xFEFF;    // Fullwidth punctuation, byte order mark
+}
+
+// LOWERCASE THE CAPITALS OF LATIN-1, GREEK AND CYRILLIC (SAME UTF-8 LENGTH BEFORE AND AFTER)
+static uint32_t unicode_lower(uint32_t c){
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7) return c + 0x20;
+    if (c >= 0x391 && c <= 0x3A9 && c != 0x3A2) return c + 0x20;
+    if (c >= 0x410 && c <= 0x42F) return c + 0x20;
+    if (c >= 0x400 && c <= 0x40F) return c + 0x50;
+    return c;
+}
+
+// CLEAN length BYTES OF text INTO output (WHICH MAY BE text ITSELF)
+size_t cleanTextBuffer(const char *text, size_t length, char *output, int mode){
+    const unsigned char *in = (const unsigned char*)text;
+    size_t i = 0, j = 0;
+    int last_was_space = 0;
+#ifdef TEXT_SIMD_X86
+    int has_avx2 = cpu_has_avx2();
+#endif
+
+    while (i < length) {
+#ifdef TEXT_SIMD_X86
+        // The output never runs ahead of the input, so in-place blocks are safe
+        if (has_avx2) {
+            size_t written = 0;
+            i += clean_run_avx2(text + i, length - i, output + j, &written, &last_was_space, mode);
+            j += written;
+        } else {
+            size_t run = clean_run_sse2(text + i, length - i, output + j, &last_was_space);
+            i += run;
+            j += run;
+        }
+        if (i >= length) break;
+#endif
+        // Table path until the end of the next 16-byte block
+        size_t block_end = (i + 16 < length) ? i + 16 : length;
+        while (i < block_end) {
+            unsigned char c = in[i];
+            unsigned char mapped = text_clean_table[c];
+
+            if (mapped > ' ') {
+                output[j++] = (char)mapped;
+                last_was_space = 0;
+                i++;
+            } else if (mapped == ' ') {
+                if (!last_was_space) output[j++] = ' ';
+                last_was_space = 1;
+                i++;
+            } else if (c >= 0x80 && mode == CLEAN_TEXT_UTF8) {
+                uint32_t code_point;
+                size_t sequence = decode_utf8(in + i, length - i, &code_point);
+                if (sequence == 0) {
+                    i++;  // Invalid byte: dropped
+                } else if (is_unicode_separator(code_point)) {
+                    i += sequence;
+                } else {
+                    code_point = unicode_lower(code_point);
+                    // Re-encode with the same length (unicode_lower keeps it)
+                    if (sequence == 2) {
+                        output[j++] = (char)(0xC0 | (code_point >> 6));
+                    } else if (sequence == 3) {
+                        output[j++] = (char)(0xE0 | (code_point >> 12));
+                        output[j++] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+                    } else {
+                        output[j++] = (char)(0xF0 | (code_point >> 18));
+                        output[j++] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+                        output[j++] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+                    }
+                    output[j++] = (char)(0x80 | (code_point & 0x3F));
+                    last_was_space = 0;
+                    i += sequence;
+                }
+            } else {
+                i++;  // Skip all other characters
+            }
+        }
+    }
+
+    output[j] = '\0';
+    return j;
+}
+
+// CLEAN A NUL-TERMINATED STRING IN PLACE
+size_t cleanTextInPlace(char *text, int mode){
+    if (text == NULL) {
+        return 0;
+    }
+    return cleanTextBuffer(text, strlen(text), text, mode);
+}
+
 // CLEAN THE TEXT BY CONVERTING ALL CHARACTERS TO LOWERCASE AND REMOVING ALL NON-ALPHANUMERIC CHARACTERS
 char* Cleaned_Text(char *raw_text){
-    int len = strlen(raw_text);
+    size_t len = strlen(raw_text);
     char *cleaned_text = malloc((len + 1) * sizeof(char));
     if(cleaned_text == NULL){
         fprintf(stderr, "Memory allocation failed for cleaned_text.\n");
         return NULL;
     }
 
-    int j = 0;  // Index for cleaned_text
-    int last_was_space = 0;  // Flag to track consecutive spaces
-
-    for(int i = 0; i < len; i++){
-        char c = tolower(raw_text[i]);  // Convert to lowercase
-        
-        if(isalnum(c)){  // Keep alphanumeric characters
-            cleaned_text[j++] = c;
-            last_was_space = 0;
-        }
-        else if(c == ' ' && !last_was_space){  // Keep single spaces
-            cleaned_text[j++] = ' ';
-            last_was_space = 1;
-        }
-        // Skip all other characters
-    }
-    
-    cleaned_text[j] = '\0'; // Null-terminate the cleaned text
+    cleanTextBuffer(raw_text, len, cleaned_text, CLEAN_TEXT_ASCII);
     return cleaned_text;
-}
\ No newline at end of file
+}
@@ -9,11 +9,18 @@
 
 // SCALE THE EMBEDDING MATRIX TO THE RANGE [-1, 1]
 void scale_matrix(float matrix[EMBEDDING_SIZE][MATRIX_SIZE]){
+    scale_matrix_rows(matrix, EMBEDDING_SIZE);
+}
+
+// SCALE THE FIRST rows ROWS OF THE EMBEDDING MATRIX TO THE RANGE [-1, 1] (THE REST IS PADDING)
+void scale_matrix_rows(float matrix[][MATRIX_SIZE], int rows){
+    if(rows <= 0) return;
+
     // Find the minimum and maximum values in the matrix
     float min_val = matrix[0][0];
     float max_val = matrix[0][0];
 
-    for(int i = 0; i < EMBEDDING_SIZE; i++){
+    for(int i = 0; i < rows; i++){
         for(int j = 0; j < MATRIX_SIZE; j++){
             if(matrix[i][j] < min_val) min_val = matrix[i][j];
             if(matrix[i][j] > max_val) max_val = matrix[i][j];
@@ -27,7 +34,7 @@ void scale_matrix(float matrix[EMBEDDING_SIZE][MATRIX_SIZE]){
     }
 
     // Scale all values to the range [-1, 1]
-    for(int i = 0; i < EMBEDDING_SIZE; i++){
+    for(int i = 0; i < rows; i++){
         for(int j = 0; j < MATRIX_SIZE; j++){
             matrix[i][j] = 2 * (matrix[i][j] - min_val) / (max_val - min_val) - 1;
             if(matrix[i][j] == 0) matrix[i][j] = 0.01; // Avoid zero values to prevent potential issues
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/attention.h"
+#include "../include/gemm.h"
+#include "../include/kernels.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// SEQUENCES SHORTER THAN THIS (IN QUERY BLOCKS) STAY ON THE CALLING THREAD
+#define ATTENTION_PARALLEL_BLOCKS 2
+
+// Score tile of the calling thread, allocated on first use and reused by every later call
+static _Thread_local float* score_tile = NULL;
+
+static int min_int(int a, int b) {
+    return a < b ? a : b;
+}
+
+// FUNCTION TO ATTEND ONE BLOCK OF QUERIES OVER EVERY KEY/VALUE TILE
+// scores holds one Q_BLOCK x KV_BLOCK tile; row_max and row_sum carry the
+// online softmax state of each query row between tiles.
+static void attend_query_block(const KernelTable* kt, float* scores, int q0, int bq, int seq_q, int seq_k,
+                               int head_dim, float scale,
+                               const float *Q, int ldq, const float *K, int ldk,
+                               const float *V, int ldv, float *O, int ldo, int causal) {
+    float row_max[ATTENTION_Q_BLOCK];
+    float row_sum[ATTENTION_Q_BLOCK];
+    const int offset = seq_k - seq_q;  // Causal alignment of queries to keys
+    float *out = O + (size_t)q0 * ldo;
+
+    for (int r = 0; r < bq; r++) {
+        row_max[r] = -INFINITY;
+        row_sum[r] = 0.0f;
+        memset(out + (size_t)r * ldo, 0, head_dim * sizeof(float));
+    }
+
+    // With a causal mask the last row of the block sees the most keys
+    int k_end = causal ? min_int(seq_k, q0 + bq + offset) : seq_k;
+
+    for (int k0 = 0; k0 < k_end; k0 += ATTENTION_KV_BLOCK) {
+        int bk = min_int(ATTENTION_KV_BLOCK, k_end - k0);
+
+        // S = scale * Q_block * K_tile^T
+        gemm_f32(GEMM_NO_TRANS, GEMM_TRANS, bq, bk, head_dim,
+                 scale, Q + (size_t)q0 * ldq, ldq, K + (size_t)k0 * ldk, ldk,
+                 0.0f, scores, ATTENTION_KV_BLOCK);
+
+        for (int r = 0; r < bq; r++) {
+            float *s = scores + (size_t)r * ATTENTION_KV_BLOCK;
+            // Masked keys form a suffix of the tile
+            int valid = causal ? min_int(bk, q0 + r + offset + 1 - k0) : bk;
+            if (valid <= 0) {
+                memset(s, 0, bk * sizeof(float));
+                continue;
+            }
+
+            float new_max = fmaxf(row_max[r], kt->row_max(s, valid));
+
+            // P = exp(S - m_new); rescale what has been accumulated so far
+            kt->vexp(s, new_max, s, valid);
+            if (valid < bk) memset(s + valid, 0, (bk - valid) * sizeof(float));
+
+            if (new_max > row_max[r] && row_sum[r] > 0.0f) {
+                float correction = expf(row_max[r] - new_max);
+                row_sum[r] *= correction;
+                kt->scale(head_dim, correction, out + (size_t)r * ldo);
+            }
+            row_sum[r] += kt->row_sum(s, valid);
+            row_max[r] = new_max;
+        }
+
+        // O_block += P * V_tile
+        gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, bq, head_dim, bk,
+                 1.0f, scores, ATTENTION_KV_BLOCK, V + (size_t)k0 * ldv, ldv,
+                 1.0f, out, ldo);
+    }
+
+    // Normalize by the softmax denominator
+    for (int r = 0; r < bq; r++) {
+        if (row_sum[r] > 0.0f) {
+            kt->scale(head_dim, 1.0f / row_sum[r], out + (size_t)r * ldo);
+        }
+    }
+}
+
+// FUNCTION TO COMPUTE SOFTMAX(SCALE * Q * K^T) * V TILE BY TILE
+void flash_attention_f32(int seq_q, int seq_k, int head_dim, float scale,
+                         const float *Q, int ldq,
+                         const float *K, int ldk,
+                         const float *V, int ldv,
+                         float *O, int ldo, int causal) {
+    if (seq_q <= 0 || seq_k <= 0 || head_dim <= 0) return;
+
+    const KernelTable* kt = kernels();
+    int n_blocks = (seq_q + ATTENTION_Q_BLOCK - 1) / ATTENTION_Q_BLOCK;
+
+#ifdef _OPENMP
+    int workers = (n_blocks >= ATTENTION_PARALLEL_BLOCKS && !omp_in_parallel()) ? gemm_get_num_threads() : 1;
+    // Causal blocks near the end see more keys, so hand them out dynamically
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(workers) if(workers > 1)
+#endif
+    for (int b = 0; b < n_blocks; b++) {
+        if (score_tile == NULL) {
+            score_tile = (float*)aligned_alloc(64, ATTENTION_Q_BLOCK * ATTENTION_KV_BLOCK * sizeof(float));
+            if (score_tile == NULL) {
+                fprintf(stderr, "flash_attention_f32: failed to allocate the score tile\n");
+                continue;
+            }
+        }
+        int q0 = b * ATTENTION_Q_BLOCK;
+        attend_query_block(kt, score_tile, q0, min_int(ATTENTION_Q_BLOCK, seq_q - q0), seq_q, seq_k,
+                           head_dim, scale, Q, ldq, K, ldk, V, ldv, O, ldo, causal);
+    }
+}
@@ -0,0 +1,549 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/bpe.h"
+#include "../include/tokenizer.h"
+#include "../include/vocab.h"
+
+// A PAIR KEY: THE TOP BIT MARKS AN OCCUPIED SLOT SO THE PAIR (0, 0) IS NOT "EMPTY"
+#define PAIR_KEY(left, right) ((1ULL << 63) | ((uint64_t)(left) << 32) | (uint32_t)(right))
+#define PAIR_LEFT(key) ((uint32_t)(((key) >> 32) & 0x7fffffffu))
+#define PAIR_RIGHT(key) ((uint32_t)(key))
+
+// Marks a symbol merged into its left neighbour while encoding
+#define DEAD_SYMBOL UINT32_MAX
+
+// FUNCTION TO SPREAD THE BITS OF A PAIR KEY (FIBONACCI HASHING: ONE MULTIPLY)
+static uint64_t mix_key(uint64_t key) {
+    return (key * 0x9e3779b97f4a7c15ULL) >> 32;
+}
+
+// FUNCTION TO FIND THE RANK OF THE MERGE (left, right), OR -1
+static int32_t find_merge(const BPETokenizer* tokenizer, uint32_t left, uint32_t right) {
+    const uint64_t key = PAIR_KEY(left, right);
+    const uint32_t mask = tokenizer->merge_capacity - 1;
+
+    for (uint32_t slot = (uint32_t)mix_key(key) & mask;; slot = (slot + 1) & mask) {
+        if (tokenizer->merge_keys[slot] == key) return tokenizer->merge_ranks[slot];
+        if (tokenizer->merge_keys[slot] == 0) return -1;
+    }
+}
+
+// FUNCTION TO CREATE A TOKENIZER FROM A LIST OF MERGES
+BPETokenizer* create_bpe_tokenizer(const BPEMerge* merges, int num_merges) {
+    if (num_merges < 0 || (num_merges > 0 && merges == NULL)) return NULL;
+
+    BPETokenizer* tokenizer = (BPETokenizer*)calloc(1, sizeof(BPETokenizer));
+    if (tokenizer == NULL) return NULL;
+
+    tokenizer->num_merges = num_merges;
+    tokenizer->vocab_size = BPE_BYTE_TOKENS + num_merges;
+    tokenizer->merge_capacity = 16;
+    while (tokenizer->merge_capacity < (uint32_t)num_merges * 2) tokenizer->merge_capacity <<= 1;
+
+    tokenizer->merges = (BPEMerge*)malloc((num_merges > 0 ? num_merges : 1) * sizeof(BPEMerge));
+    tokenizer->merge_keys = (uint64_t*)calloc(tokenizer->merge_capacity, sizeof(uint64_t));
+    tokenizer->merge_ranks = (int32_t*)malloc(tokenizer->merge_capacity * sizeof(int32_t));
+    tokenizer->token_offsets = (uint32_t*)malloc((tokenizer->vocab_size + 1) * sizeof(uint32_t));
+    if (tokenizer->merges == NULL || tokenizer->merge_keys == NULL || tokenizer->merge_ranks == NULL ||
+        tokenizer->token_offsets == NULL) {
+        free_bpe_tokenizer(tokenizer);
+        return NULL;
+    }
+
+    // Token lengths first, so the bytes of every token fit in one buffer
+    size_t total = BPE_BYTE_TOKENS;
+    for (int t = 0; t <= BPE_BYTE_TOKENS; t++) tokenizer->token_offsets[t] = (uint32_t)t;
+    for (int r = 0; r < num_merges; r++) {
+        uint32_t token = BPE_BYTE_TOKENS + (uint32_t)r;
+        if (merges[r].left >= token || merges[r].right >= token) {
+            fprintf(stderr, "bpe: merge %d refers to a token that does not exist yet\n", r);
+            free_bpe_tokenizer(tokenizer);
+            return NULL;
+        }
+        total += (tokenizer->token_offsets[merges[r].left + 1] - tokenizer->token_offsets[merges[r].left]) +
+                 (tokenizer->token_offsets[merges[r].right + 1] - tokenizer->token_offsets[merges[r].right]);
+        if (total > UINT32_MAX) {
+            free_bpe_tokenizer(tokenizer);
+            return NULL;
+        }
+        tokenizer->token_offsets[token + 1] = (uint32_t)total;
+    }
+
+    tokenizer->token_bytes = (char*)malloc(total);
+    if (tokenizer->token_bytes == NULL) {
+        free_bpe_tokenizer(tokenizer);
+        return NULL;
+    }
+    for (int t = 0; t < BPE_BYTE_TOKENS; t++) tokenizer->token_bytes[t] = (char)t;
+
+    const uint32_t mask = tokenizer->merge_capacity - 1;
+    for (int r = 0; r < num_merges; r++) {
+        const BPEMerge m = merges[r];
+        tokenizer->merges[r] = m;
+
+        // A token's bytes are its left part followed by its right part
+        size_t left_length = tokenizer->token_offsets[m.left + 1] - tokenizer->token_offsets[m.left];
+        size_t right_length = tokenizer->token_offsets[m.right + 1] - tokenizer->token_offsets[m.right];
+        char* dst = tokenizer->token_bytes + tokenizer->token_offsets[BPE_BYTE_TOKENS + r];
+        memcpy(dst, tokenizer->token_bytes + tokenizer->token_offsets[m.left], left_length);
+        memcpy(dst + left_length, tokenizer->token_bytes + tokenizer->token_offsets[m.right], right_length);
+
+        // The first (lowest rank) merge of a pair wins if it is listed twice
+        const uint64_t key = PAIR_KEY(m.left, m.right);
+        uint32_t slot = (uint32_t)mix_key(key) & mask;
+        while (tokenizer->merge_keys[slot] != 0 && tokenizer->merge_keys[slot] != key) slot = (slot + 1) & mask;
+        if (tokenizer->merge_keys[slot] == 0) {
+            tokenizer->merge_keys[slot] = key;
+            tokenizer->merge_ranks[slot] = r;
+        }
+    }
+    return tokenizer;
+}
+
+// FUNCTION TO FREE A TOKENIZER
+void free_bpe_tokenizer(BPETokenizer* tokenizer) {
+    if (tokenizer == NULL) return;
+
+    free(tokenizer->merges);
+    free(tokenizer->merge_keys);
+    free(tokenizer->merge_ranks);
+    free(tokenizer->token_offsets);
+    free(tokenizer->token_bytes);
+    free(tokenizer);
+}
+
+// FUNCTION TO GET THE BYTES OF A TOKEN
+const char* bpe_token_bytes(const BPETokenizer* tokenizer, uint32_t token_id, size_t* length) {
+    if (tokenizer == NULL || token_id >= (uint32_t)tokenizer->vocab_size) return NULL;
+
+    if (length != NULL) *length = tokenizer->token_offsets[token_id + 1] - tokenizer->token_offsets[token_id];
+    return tokenizer->token_bytes + tokenizer->token_offsets[token_id];
+}
+
+// Encoder scratch of the calling thread, grown on demand
+static _Thread_local uint32_t* encode_symbols = NULL;
+static _Thread_local int32_t* encode_prev = NULL;
+static _Thread_local int32_t* encode_next = NULL;
+static _Thread_local uint64_t* encode_heap = NULL;
+static _Thread_local size_t encode_capacity = 0;
+
+// FUNCTION TO GROW THE ENCODER SCRATCH TO n SYMBOLS
+static int ensure_encode_scratch(size_t n) {
+    if (n <= encode_capacity) return 1;
+
+    size_t capacity = encode_capacity > 0 ? encode_capacity : 64;
+    while (capacity < n) capacity *= 2;
+
+    free(encode_symbols);
+    free(encode_prev);
+    free(encode_next);
+    free(encode_heap);
+    encode_symbols = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    encode_prev = (int32_t*)malloc(capacity * sizeof(int32_t));
+    encode_next = (int32_t*)malloc(capacity * sizeof(int32_t));
+    // Every merge pushes at most two candidates on top of the initial n - 1
+    encode_heap = (uint64_t*)malloc(3 * capacity * sizeof(uint64_t));
+    encode_capacity = (encode_symbols && encode_prev && encode_next && encode_heap) ? capacity : 0;
+    return encode_capacity != 0;
+}
+
+// FUNCTION TO PUSH A CANDIDATE (RANK IN THE HIGH HALF, POSITION IN THE LOW HALF) ON A MIN-HEAP
+static void heap_push(uint64_t* heap, int* size, uint64_t value) {
+    int i = (*size)++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap[parent] <= value) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = value;
+}
+
+// FUNCTION TO POP THE SMALLEST CANDIDATE FROM A MIN-HEAP
+static uint64_t heap_pop(uint64_t* heap, int* size) {
+    uint64_t top = heap[0];
+    uint64_t last = heap[--(*size)];
+    int i = 0;
+
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && heap[child + 1] < heap[child]) child++;
+        if (last <= heap[child]) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+// FUNCTION TO PUSH THE MERGE OF SYMBOL i WITH ITS RIGHT NEIGHBOUR, IF THERE IS ONE
+static void push_candidate(const BPETokenizer* tokenizer, uint64_t* heap, int* size, int32_t i) {
+    if (i < 0 || encode_next[i] < 0) return;
+    int32_t j = encode_next[i];
+
+    int32_t rank = find_merge(tokenizer, encode_symbols[i], encode_symbols[j]);
+    if (rank >= 0) heap_push(heap, size, ((uint64_t)rank << 32) | (uint32_t)i);
+}
+
+// FUNCTION TO ENCODE ONE WORD
+// Candidates pop in (rank, position) order: every occurrence of an earlier
+// merge is applied, left to right, before any later one, exactly as training
+// applied them. A merge only creates pairs of later rank, so order is kept.
+int bpe_encode_word(const BPETokenizer* tokenizer, const char* word, size_t length, uint32_t* ids) {
+    if (tokenizer == NULL || length == 0 || length > INT32_MAX || !ensure_encode_scratch(length)) return 0;
+
+    const int n = (int)length;
+    uint64_t* heap = encode_heap;
+    int heap_size = 0;
+
+    for (int i = 0; i < n; i++) {
+        encode_symbols[i] = (unsigned char)word[i];
+        encode_prev[i] = i - 1;
+        encode_next[i] = (i + 1 < n) ? i + 1 : -1;
+    }
+    for (int i = 0; i + 1 < n; i++) {
+        push_candidate(tokenizer, heap, &heap_size, i);
+    }
+
+    while (heap_size > 0) {
+        uint64_t candidate = heap_pop(heap, &heap_size);
+        int32_t rank = (int32_t)(candidate >> 32);
+        int32_t i = (int32_t)(uint32_t)candidate;
+        int32_t j = encode_next[i];
+
+        // Stale: the left symbol was absorbed, or either side changed since the push
+        if (encode_symbols[i] == DEAD_SYMBOL || j < 0 ||
+            encode_symbols[i] != tokenizer->merges[rank].left ||
+            encode_symbols[j] != tokenizer->merges[rank].right) {
+            continue;
+        }
+
+        encode_symbols[i] = BPE_BYTE_TOKENS + (uint32_t)rank;
+        encode_symbols[j] = DEAD_SYMBOL;
+        encode_next[i] = encode_next[j];
+        if (encode_next[j] >= 0) encode_prev[encode_next[j]] = i;
+
+        push_candidate(tokenizer, heap, &heap_size, encode_prev[i]);
+        push_candidate(tokenizer, heap, &heap_size, i);
+    }
+
+    int count = 0;
+    for (int32_t i = 0; i >= 0; i = encode_next[i]) {
+        ids[count++] = encode_symbols[i];
+    }
+    return count;
+}
+
+// FUNCTION TO ENCODE EVERY WORD OF A TEXT
+long bpe_encode(const BPETokenizer* tokenizer, const char* text, uint32_t* ids, long max_ids) {
+    if (tokenizer == NULL || text == NULL) return -1;
+
+    const char* cursor = text;
+    const char* word;
+    size_t length;
+    long count = 0;
+
+    while ((length = nextWord(&cursor, &word)) > 0) {
+        // A word never encodes to more tokens than it has bytes
+        if (count + (long)length > max_ids) return -1;
+        count += bpe_encode_word(tokenizer, word, length, ids + count);
+    }
+    return count;
+}
+
+// Training state: pair statistics indexed through an open-addressing map
+typedef struct {
+    uint64_t key;
+    long count;       // Occurrences, weighted by word frequency
+    long pushed;      // Largest count currently in the heap for this pair
+    int32_t* words;   // Words that contain (or once contained) the pair, may repeat
+    int num_words;
+    int words_capacity;
+} PairStat;
+
+typedef struct {
+    PairStat* stats;
+    int num_stats;
+    int stats_capacity;
+    int32_t* index;        // Slot -> stats entry, -1 = empty
+    uint32_t index_capacity;
+    uint64_t* heap_keys;   // Max-heap of (count, pair) entries, possibly stale
+    long* heap_counts;
+    int heap_size;
+    int heap_capacity;
+} PairTable;
+
+// FUNCTION TO FIND A PAIR'S STATISTICS, ADDING AN EMPTY ENTRY IF IT IS NEW
+static PairStat* pair_stat(PairTable* table, uint64_t key) {
+    if ((uint32_t)(table->num_stats + 1) * 2 > table->index_capacity) {
+        uint32_t capacity = table->index_capacity ? table->index_capacity * 2 : 1024;
+        int32_t* index = (int32_t*)malloc(capacity * sizeof(int32_t));
+        if (index == NULL) return NULL;
+        memset(index, 0xff, capacity * sizeof(int32_t));
+        for (int s = 0; s < table->num_stats; s++) {
+            uint32_t slot = (uint32_t)mix_key(table->stats[s].key) & (capacity - 1);
+            while (index[slot] >= 0) slot = (slot + 1) & (capacity - 1);
+            index[slot] = s;
+        }
+        free(table->index);
+        table->index = index;
+        table->index_capacity = capacity;
+    }
+
+    const uint32_t mask = table->index_capacity - 1;
+    uint32_t slot = (uint32_t)mix_key(key) & mask;
+    while (table->index[slot] >= 0) {
+        if (table->stats[table->index[slot]].key == key) return &table->stats[table->index[slot]];
+        slot = (slot + 1) & mask;
+    }
+
+    if (table->num_stats == table->stats_capacity) {
+        int capacity = table->stats_capacity ? table->stats_capacity * 2 : 1024;
+        PairStat* stats = (PairStat*)realloc(table->stats, capacity * sizeof(PairStat));
+        if (stats == NULL) return NULL;
+        table->stats = stats;
+        table->stats_capacity = capacity;
+    }
+    PairStat* stat = &table->stats[table->num_stats];
+    memset(stat, 0, sizeof(*stat));
+    stat->key = key;
+    table->index[slot] = table->num_stats++;
+    return stat;
+}
+
+// FUNCTION TO ORDER HEAP ENTRIES: HIGHER COUNT FIRST, THEN SMALLER PAIR
+static int heap_before(long count_a, uint64_t key_a, long count_b, uint64_t key_b) {
+    return count_a > count_b || (count_a == count_b && key_a < key_b);
+}
+
+// FUNCTION TO PUSH A PAIR WITH ITS CURRENT COUNT ON THE MAX-HEAP
+static int pair_heap_push(PairTable* table, PairStat* stat) {
+    if (table->heap_size == table->heap_capacity) {
+        int capacity = table->heap_capacity ? table->heap_capacity * 2 : 1024;
+        uint64_t* keys = (uint64_t*)realloc(table->heap_keys, capacity * sizeof(uint64_t));
+        if (keys == NULL) return 0;
+        table->heap_keys = keys;
+        long* counts = (long*)realloc(table->heap_counts, capacity * sizeof(long));
+        if (counts == NULL) return 0;
+        table->heap_counts = counts;
+        table->heap_capacity = capacity;
+    }
+
+    int i = table->heap_size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heap_before(stat->count, stat->key, table->heap_counts[parent], table->heap_keys[parent])) break;
+        table->heap_keys[i] = table->heap_keys[parent];
+        table->heap_counts[i] = table->heap_counts[parent];
+        i = parent;
+    }
+    table->heap_keys[i] = stat->key;
+    table->heap_counts[i] = stat->count;
+    stat->pushed = stat->count;
+    return 1;
+}
+
+// FUNCTION TO POP THE TOP ENTRY OF THE MAX-HEAP
+static void pair_heap_pop(PairTable* table, uint64_t* key, long* count) {
+    *key = table->heap_keys[0];
+    *count = table->heap_counts[0];
+
+    uint64_t last_key = table->heap_keys[--table->heap_size];
+    long last_count = table->heap_counts[table->heap_size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= table->heap_size) break;
+        if (child + 1 < table->heap_size &&
+            heap_before(table->heap_counts[child + 1], table->heap_keys[child + 1],
+                        table->heap_counts[child], table->heap_keys[child])) {
+            child++;
+        }
+        if (!heap_before(table->heap_counts[child], table->heap_keys[child], last_count, last_key)) break;
+        table->heap_keys[i] = table->heap_keys[child];
+        table->heap_counts[i] = table->heap_counts[child];
+        i = child;
+    }
+    table->heap_keys[i] = last_key;
+    table->heap_counts[i] = last_count;
+}
+
+// FUNCTION TO ADD delta OCCURRENCES OF EVERY ADJACENT PAIR OF A WORD
+// With track_token >= 0, the word is listed under new pairs that contain that
+// token; with track_token == -2 (initial pass) it is listed under every pair.
+static int add_word_pairs(PairTable* table, const uint32_t* symbols, int length, int32_t word,
+                          long delta, long track_token) {
+    for (int i = 0; i + 1 < length; i++) {
+        PairStat* stat = pair_stat(table, PAIR_KEY(symbols[i], symbols[i + 1]));
+        if (stat == NULL) return 0;
+        stat->count += delta;
+
+        int track = track_token == -2 || symbols[i] == (uint32_t)track_token || symbols[i + 1] == (uint32_t)track_token;
+        if (track && (stat->num_words == 0 || stat->words[stat->num_words - 1] != word)) {
+            if (stat->num_words == stat->words_capacity) {
+                int capacity = stat->words_capacity ? stat->words_capacity * 2 : 4;
+                int32_t* words = (int32_t*)realloc(stat->words, capacity * sizeof(int32_t));
+                if (words == NULL) return 0;
+                stat->words = words;
+                stat->words_capacity = capacity;
+            }
+            stat->words[stat->num_words++] = word;
+        }
+        if (stat->count > stat->pushed && !pair_heap_push(table, stat)) return 0;
+    }
+    return 1;
+}
+
+// FUNCTION TO MERGE EVERY (left, right) OF A WORD INTO token, LEFT TO RIGHT; RETURNS THE NEW LENGTH
+static int merge_word(uint32_t* symbols, int length, uint32_t left, uint32_t right, uint32_t token) {
+    int out = 0;
+    for (int i = 0; i < length; i++) {
+        if (i + 1 < length && symbols[i] == left && symbols[i + 1] == right) {
+            symbols[out++] = token;
+            i++;
+        } else {
+            symbols[out++] = symbols[i];
+        }
+    }
+    return out;
+}
+
+// FUNCTION TO LEARN MERGES FROM A CORPUS
+BPETokenizer* bpe_train(char** sentences, int vocab_size) {
+    if (sentences == NULL || vocab_size < BPE_BYTE_TOKENS) return NULL;
+
+    // 1) Unique words with their frequencies
+    Vocab* words = create_vocab(TOKENIZER_INITIAL_WORDS);
+    long* frequency = NULL;
+    size_t frequency_capacity = 0;
+    if (words == NULL) return NULL;
+
+    for (int s = 0; sentences[s] != NULL; s++) {
+        const char* cursor = sentences[s];
+        const char* word;
+        size_t length;
+        while ((length = nextWord(&cursor, &word)) > 0) {
+            uint32_t id = vocab_lookup_or_insert(words, word, length, NULL);
+            if (id == 0 || id >= frequency_capacity) {
+                size_t capacity = frequency_capacity ? frequency_capacity * 2 : 4096;
+                long* grown = (id != 0) ? (long*)realloc(frequency, capacity * sizeof(long)) : NULL;
+                if (grown == NULL) {
+                    free(frequency);
+                    free_vocab(words);
+                    return NULL;
+                }
+                memset(grown + frequency_capacity, 0, (capacity - frequency_capacity) * sizeof(long));
+                frequency = grown;
+                frequency_capacity = capacity;
+            }
+            frequency[id]++;
+        }
+    }
+
+    // 2) Every unique word as a symbol sequence, all in one pool (words are 1-based)
+    const int num_words = (int)words->count;
+    uint32_t* pool = (uint32_t*)malloc((words->arena_size + 1) * sizeof(uint32_t));
+    size_t* word_start = (size_t*)malloc((num_words + 1) * sizeof(size_t));
+    int* word_length = (int*)malloc((num_words + 1) * sizeof(int));
+    int* merged_in = (int*)malloc((num_words + 1) * sizeof(int));
+    int max_merges = vocab_size - BPE_BYTE_TOKENS;
+    BPEMerge* merges = (BPEMerge*)malloc((max_merges > 0 ? max_merges : 1) * sizeof(BPEMerge));
+    PairTable table = {0};
+    int ok = pool != NULL && word_start != NULL && word_length != NULL && merged_in != NULL && merges != NULL;
+
+    size_t used = 0;
+    for (int w = 1; ok && w <= num_words; w++) {
+        const char* bytes = vocab_word(words, (uint32_t)w);
+        word_start[w] = used;
+        word_length[w] = (int)vocab_word_length(words, (uint32_t)w);
+        merged_in[w] = -1;
+        for (int i = 0; i < word_length[w]; i++) pool[used++] = (unsigned char)bytes[i];
+        ok = add_word_pairs(&table, pool + word_start[w], word_length[w], w, frequency[w], -2);
+    }
+
+    // 3) Merge the most frequent pair until the vocabulary is full
+    int num_merges = 0;
+    while (ok && num_merges < max_merges && table.heap_size > 0) {
+        uint64_t key;
+        long count;
+        pair_heap_pop(&table, &key, &count);
+        PairStat* stat = pair_stat(&table, key);
+
+        // Entries go stale when a pair loses occurrences: requeue with the true count
+        if (count != stat->count) {
+            stat->pushed = 0;
+            if (stat->count > 0) ok = pair_heap_push(&table, stat);
+            continue;
+        }
+        if (count < 2) break;
+
+        const uint32_t left = PAIR_LEFT(key), right = PAIR_RIGHT(key);
+        const uint32_t token = BPE_BYTE_TOKENS + (uint32_t)num_merges;
+        merges[num_merges] = (BPEMerge){ left, right };
+
+        // Take the word list: new pairs may grow the stats array while we walk it
+        int32_t* list = stat->words;
+        int list_length = stat->num_words;
+        stat->words = NULL;
+        stat->num_words = stat->words_capacity = 0;
+
+        for (int k = 0; ok && k < list_length; k++) {
+            int32_t w = list[k];
+            if (merged_in[w] == num_merges) continue;
+            merged_in[w] = num_merges;
+
+            uint32_t* symbols = pool + word_start[w];
+            int length = word_length[w];
+            int present = 0;
+            for (int i = 0; i + 1 < length && !present; i++) {
+                present = symbols[i] == left && symbols[i + 1] == right;
+            }
+            if (!present) continue;
+
+            // Only this word's pairs change: retract them, merge, and count them again
+            ok = add_word_pairs(&table, symbols, length, w, -frequency[w], -1);
+            word_length[w] = merge_word(symbols, length, left, right, token);
+            ok = ok && add_word_pairs(&table, symbols, word_length[w], w, frequency[w], token);
+        }
+        free(list);
+        num_merges++;
+    }
+
+    BPETokenizer* tokenizer = ok ? create_bpe_tokenizer(merges, num_merges) : NULL;
+
+    for (int s = 0; s < table.num_stats; s++) free(table.stats[s].words);
+    free(table.stats);
+    free(table.index);
+    free(table.heap_keys);
+    free(table.heap_counts);
+    free(merges);
+    free(merged_in);
+    free(word_length);
+    free(word_start);
+    free(pool);
+    free(frequency);
+    free_vocab(words);
+    return tokenizer;
+}
+
+// FUNCTION TO DESCRIBE THE MERGES AS A CHECKPOINT TENSOR
+int bpe_checkpoint_tensor(const BPETokenizer* tokenizer, const char* name, CheckpointTensor* tensor) {
+    if (tokenizer == NULL) return 0;
+
+    long shape[2] = { tokenizer->num_merges, 2 };
+    return checkpoint_tensor_init(tensor, name, CHECKPOINT_U32, 2, shape, tokenizer->merges);
+}
+
+// FUNCTION TO CREATE A TOKENIZER FROM A CHECKPOINT
+BPETokenizer* create_bpe_tokenizer_from_checkpoint(const Checkpoint* checkpoint, const char* name) {
+    const CheckpointTensor* tensor = checkpoint_find(checkpoint, name);
+
+    if (tensor == NULL || tensor->dtype != CHECKPOINT_U32 || tensor->ndim != 2 || tensor->shape[1] != 2) {
+        fprintf(stderr, "bpe: checkpoint has no U32 [merges][2] tensor %s\n", name);
+        return NULL;
+    }
+    return create_bpe_tokenizer((const BPEMerge*)tensor->data, (int)tensor->shape[0]);
+}
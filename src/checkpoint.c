@@ -0,0 +1,407 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/checkpoint.h"
+
+_Static_assert(sizeof(CheckpointHeader) == 64, "checkpoint header must be 64 bytes");
+_Static_assert(sizeof(CheckpointEntry) == 128, "checkpoint entry must be 128 bytes");
+
+static size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// FUNCTION TO GET THE SIZE OF ONE ELEMENT
+size_t checkpoint_dtype_size(CheckpointDType dtype) {
+    switch (dtype) {
+        case CHECKPOINT_F32: return 4;
+        case CHECKPOINT_F64: return 8;
+        case CHECKPOINT_I32: return 4;
+        case CHECKPOINT_U16: return 2;
+        case CHECKPOINT_U32: return 4;
+        case CHECKPOINT_U8:  return 1;
+        case CHECKPOINT_U64: return 8;
+        default:             return 0;
+    }
+}
+
+// FUNCTION TO HASH A BYTE RANGE (FNV-1a 64)
+uint64_t checkpoint_hash(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// FUNCTION TO DESCRIBE A TENSOR TO SAVE
+int checkpoint_tensor_init(CheckpointTensor* tensor, const char* name, CheckpointDType dtype,
+                           int ndim, const long* shape, void* data) {
+    if (tensor == NULL || name == NULL || strlen(name) >= CHECKPOINT_NAME_LEN) return 0;
+    if (ndim < 0 || ndim > CHECKPOINT_MAX_DIMS || checkpoint_dtype_size(dtype) == 0) return 0;
+
+    memset(tensor, 0, sizeof(*tensor));
+    strcpy(tensor->name, name);
+    tensor->dtype = dtype;
+    tensor->ndim = ndim;
+
+    size_t count = 1;
+    for (int i = 0; i < ndim; i++) {
+        if (shape[i] < 0) return 0;
+        tensor->shape[i] = shape[i];
+        count *= (size_t)shape[i];
+    }
+    tensor->nbytes = count * checkpoint_dtype_size(dtype);
+    tensor->data = data;
+    return 1;
+}
+
+// FUNCTION TO WRITE ZERO BYTES AND FOLD THEM INTO THE CHECKSUM
+static int write_padding(FILE* file, size_t count, uint64_t* hash) {
+    static const unsigned char zeros[CHECKPOINT_ALIGNMENT] = {0};
+    while (count > 0) {
+        size_t chunk = count < sizeof(zeros) ? count : sizeof(zeros);
+        if (fwrite(zeros, 1, chunk, file) != chunk) return 0;
+        *hash = checkpoint_hash(*hash, zeros, chunk);
+        count -= chunk;
+    }
+    return 1;
+}
+
+// FUNCTION TO SAVE TENSORS TO A CHECKPOINT FILE
+int checkpoint_save(const char* path, const CheckpointTensor* tensors, int num_tensors) {
+    if (path == NULL || num_tensors < 0 || (num_tensors > 0 && tensors == NULL)) return 0;
+
+    CheckpointEntry* table = (CheckpointEntry*)calloc(num_tensors > 0 ? num_tensors : 1, sizeof(CheckpointEntry));
+    if (table == NULL) return 0;
+
+    // Lay the tensors out after the table, each on an aligned offset
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.version = CHECKPOINT_VERSION;
+    header.byte_order = CHECKPOINT_BYTE_ORDER;
+    header.num_tensors = (uint32_t)num_tensors;
+    header.alignment = CHECKPOINT_ALIGNMENT;
+    header.table_offset = sizeof(CheckpointHeader);
+    header.data_offset = align_up(header.table_offset + (size_t)num_tensors * sizeof(CheckpointEntry), CHECKPOINT_ALIGNMENT);
+
+    size_t offset = header.data_offset;
+    for (int i = 0; i < num_tensors; i++) {
+        const CheckpointTensor* t = &tensors[i];
+        if (t->data == NULL && t->nbytes > 0) {
+            fprintf(stderr, "checkpoint_save: tensor '%s' has no data\n", t->name);
+            free(table);
+            return 0;
+        }
+        memcpy(table[i].name, t->name, CHECKPOINT_NAME_LEN);
+        table[i].name[CHECKPOINT_NAME_LEN - 1] = '\0';
+        table[i].dtype = (uint32_t)t->dtype;
+        table[i].ndim = (uint32_t)t->ndim;
+        for (int d = 0; d < t->ndim; d++) table[i].shape[d] = (uint64_t)t->shape[d];
+        table[i].offset = offset;
+        table[i].nbytes = t->nbytes;
+        table[i].checksum = checkpoint_hash(CHECKPOINT_FNV_SEED, t->data, t->nbytes);
+        offset = align_up(offset + t->nbytes, CHECKPOINT_ALIGNMENT);
+    }
+    header.file_size = offset;
+
+    // Written beside path and renamed over it, so a reader (or a live mapping)
+    // of the old file never sees a partially written checkpoint
+    size_t path_length = strlen(path);
+    char* temp_path = (char*)malloc(path_length + sizeof(".tmp"));
+    if (temp_path == NULL) {
+        free(table);
+        return 0;
+    }
+    memcpy(temp_path, path, path_length);
+    memcpy(temp_path + path_length, ".tmp", sizeof(".tmp"));
+
+    FILE* file = fopen(temp_path, "wb");
+    if (file == NULL) {
+        perror("checkpoint_save: error opening file");
+        free(temp_path);
+        free(table);
+        return 0;
+    }
+
+    // The header is rewritten once the checksum of everything after it is known
+    uint64_t hash = CHECKPOINT_FNV_SEED;
+    size_t table_bytes = (size_t)num_tensors * sizeof(CheckpointEntry);
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             (table_bytes == 0 || fwrite(table, table_bytes, 1, file) == 1);
+    hash = checkpoint_hash(hash, table, table_bytes);
+    ok = ok && write_padding(file, header.data_offset - header.table_offset - table_bytes, &hash);
+
+    size_t written = header.data_offset;
+    for (int i = 0; ok && i < num_tensors; i++) {
+        ok = tensors[i].nbytes == 0 || fwrite(tensors[i].data, tensors[i].nbytes, 1, file) == 1;
+        hash = checkpoint_hash(hash, tensors[i].data, tensors[i].nbytes);
+        written += tensors[i].nbytes;
+        size_t next = align_up(written, CHECKPOINT_ALIGNMENT);
+        ok = ok && write_padding(file, next - written, &hash);
+        written = next;
+    }
+
+    header.checksum = hash;
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && rename(temp_path, path) == 0;
+    free(table);
+
+    if (!ok) {
+        fprintf(stderr, "checkpoint_save: error writing %s\n", path);
+        remove(temp_path);
+        free(temp_path);
+        return 0;
+    }
+    free(temp_path);
+    return 1;
+}
+
+// FUNCTION TO CHECK THAT AN ENTRY'S BYTE COUNT IS ITS SHAPE TIMES ITS DTYPE SIZE
+// Callers index tensors by shape, so a mismatch would read past the data.
+static int entry_size_matches_shape(const CheckpointEntry* entry) {
+    size_t element = checkpoint_dtype_size((CheckpointDType)entry->dtype);
+    uint64_t limit = entry->nbytes / element;  // Element count the data can hold
+    uint64_t count = 1;
+
+    for (uint32_t d = 0; d < entry->ndim; d++) {
+        if (entry->shape[d] > (uint64_t)LONG_MAX) return 0;
+        if (entry->shape[d] == 0) return entry->nbytes == 0;
+    }
+    for (uint32_t d = 0; d < entry->ndim; d++) {
+        if (count > limit / entry->shape[d]) return 0;  // More elements than bytes (and no overflow)
+        count *= entry->shape[d];
+    }
+    return count * element == entry->nbytes;
+}
+
+// FUNCTION TO VALIDATE A CHECKPOINT IMAGE AND DECODE ITS TENSOR TABLE
+// blob must hold the whole file.
+static int checkpoint_parse(Checkpoint* checkpoint, const char* path, int verify) {
+    const unsigned char* base = (const unsigned char*)checkpoint->blob;
+    size_t size = checkpoint->blob_size;
+    CheckpointHeader header;
+
+    if (size < sizeof(header)) {
+        fprintf(stderr, "checkpoint: %s is too small to be a checkpoint\n", path);
+        return 0;
+    }
+    memcpy(&header, base, sizeof(header));
+
+    if (memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+        fprintf(stderr, "checkpoint: %s is not a checkpoint file\n", path);
+        return 0;
+    }
+    if (header.byte_order != CHECKPOINT_BYTE_ORDER) {
+        fprintf(stderr, "checkpoint: %s was written with a different byte order\n", path);
+        return 0;
+    }
+    if (header.version != CHECKPOINT_VERSION) {
+        fprintf(stderr, "checkpoint: %s has unsupported version %u (expected %d)\n",
+                path, header.version, CHECKPOINT_VERSION);
+        return 0;
+    }
+    // Tensors are handed out as typed views, so they must be aligned for every dtype
+    if (header.alignment == 0 || header.alignment % sizeof(uint64_t) != 0 ||
+        (header.alignment & (header.alignment - 1)) != 0) {
+        fprintf(stderr, "checkpoint: %s has invalid alignment %u\n", path, header.alignment);
+        return 0;
+    }
+    // Bounds are compared without sums that could wrap around for hostile offsets
+    if (header.file_size != size || header.table_offset < sizeof(header) || header.table_offset > size ||
+        header.num_tensors > (size - header.table_offset) / sizeof(CheckpointEntry) ||
+        header.data_offset < header.table_offset + (uint64_t)header.num_tensors * sizeof(CheckpointEntry) ||
+        header.data_offset > size) {
+        fprintf(stderr, "checkpoint: %s is truncated or corrupt\n", path);
+        return 0;
+    }
+    if (verify && checkpoint_hash(CHECKPOINT_FNV_SEED, base + header.table_offset,
+                                  size - header.table_offset) != header.checksum) {
+        fprintf(stderr, "checkpoint: checksum mismatch in %s\n", path);
+        return 0;
+    }
+
+    checkpoint->version = (int)header.version;
+    checkpoint->num_tensors = (int)header.num_tensors;
+    checkpoint->tensors = (CheckpointTensor*)calloc(header.num_tensors > 0 ? header.num_tensors : 1,
+                                                     sizeof(CheckpointTensor));
+    if (checkpoint->tensors == NULL) return 0;
+
+    for (uint32_t i = 0; i < header.num_tensors; i++) {
+        CheckpointEntry entry;
+        memcpy(&entry, base + header.table_offset + (size_t)i * sizeof(entry), sizeof(entry));
+        CheckpointTensor* t = &checkpoint->tensors[i];
+
+        if (entry.ndim > CHECKPOINT_MAX_DIMS || checkpoint_dtype_size((CheckpointDType)entry.dtype) == 0 ||
+            entry.offset < header.data_offset || entry.offset > size || entry.nbytes > size - entry.offset ||
+            entry.offset % header.alignment != 0 || !entry_size_matches_shape(&entry)) {
+            fprintf(stderr, "checkpoint: tensor %u of %s is corrupt\n", i, path);
+            return 0;
+        }
+        if (verify && checkpoint_hash(CHECKPOINT_FNV_SEED, base + entry.offset, entry.nbytes) != entry.checksum) {
+            fprintf(stderr, "checkpoint: checksum mismatch in tensor %.*s of %s\n",
+                    CHECKPOINT_NAME_LEN, entry.name, path);
+            return 0;
+        }
+
+        memcpy(t->name, entry.name, CHECKPOINT_NAME_LEN);
+        t->name[CHECKPOINT_NAME_LEN - 1] = '\0';
+        t->dtype = (CheckpointDType)entry.dtype;
+        t->ndim = (int)entry.ndim;
+        for (int d = 0; d < t->ndim; d++) t->shape[d] = (long)entry.shape[d];
+        t->nbytes = entry.nbytes;
+        t->data = (void*)(base + entry.offset);
+    }
+    return 1;
+}
+
+// FUNCTION TO LOAD A CHECKPOINT WITH ONE SEQUENTIAL READ
+Checkpoint* checkpoint_load(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    Checkpoint* checkpoint = (Checkpoint*)calloc(1, sizeof(Checkpoint));
+    long size = -1;
+    if (checkpoint != NULL && fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (checkpoint == NULL || size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        free(checkpoint);
+        return NULL;
+    }
+
+    // One aligned buffer for the whole file keeps every tensor 64-byte aligned
+    checkpoint->blob_size = (size_t)size;
+    checkpoint->blob = aligned_alloc(CHECKPOINT_ALIGNMENT, align_up((size_t)size > 0 ? (size_t)size : 1, CHECKPOINT_ALIGNMENT));
+    if (checkpoint->blob == NULL || fread(checkpoint->blob, 1, (size_t)size, file) != (size_t)size) {
+        fprintf(stderr, "checkpoint_load: error reading %s\n", path);
+        fclose(file);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+    fclose(file);
+
+    if (!checkpoint_parse(checkpoint, path, 1)) {
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+    return checkpoint;
+}
+
+// FUNCTION TO MAP A CHECKPOINT WITHOUT COPYING IT
+Checkpoint* checkpoint_map(const char* path, int flags) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    // Private mappings of an unmodified file share the page cache across processes
+    int prot = PROT_READ | ((flags & CHECKPOINT_MAP_WRITABLE) ? PROT_WRITE : 0);
+    int map_flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (flags & CHECKPOINT_MAP_POPULATE) map_flags |= MAP_POPULATE;
+#endif
+    void* image = mmap(NULL, (size_t)st.st_size, prot, map_flags, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        perror("checkpoint_map: mmap failed");
+        return NULL;
+    }
+
+    // Advice is best effort: kernels without THP or readahead hints just ignore it
+#ifdef MADV_HUGEPAGE
+    if (flags & CHECKPOINT_MAP_HUGEPAGES) madvise(image, (size_t)st.st_size, MADV_HUGEPAGE);
+#endif
+    if (flags & CHECKPOINT_MAP_SEQUENTIAL) madvise(image, (size_t)st.st_size, MADV_SEQUENTIAL);
+    if (flags & CHECKPOINT_MAP_WILLNEED) madvise(image, (size_t)st.st_size, MADV_WILLNEED);
+
+    Checkpoint* checkpoint = (Checkpoint*)calloc(1, sizeof(Checkpoint));
+    if (checkpoint == NULL) {
+        munmap(image, (size_t)st.st_size);
+        return NULL;
+    }
+    checkpoint->blob = image;
+    checkpoint->blob_size = (size_t)st.st_size;
+    checkpoint->mapped = 1;
+
+    if (!checkpoint_parse(checkpoint, path, (flags & CHECKPOINT_MAP_VERIFY) != 0)) {
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+    return checkpoint;
+}
+
+// FUNCTION TO GET A TYPED VIEW OF A TENSOR
+void* checkpoint_view(const Checkpoint* checkpoint, const char* name, CheckpointDType dtype, long count) {
+    const CheckpointTensor* t = checkpoint_find(checkpoint, name);
+    if (t == NULL || t->dtype != dtype || count < 0 ||
+        t->nbytes != (size_t)count * checkpoint_dtype_size(dtype)) {
+        return NULL;
+    }
+    return t->data;
+}
+
+// FUNCTION TO FREE A CHECKPOINT
+void free_checkpoint(Checkpoint* checkpoint) {
+    if (checkpoint == NULL) return;
+
+    free(checkpoint->tensors);
+    if (checkpoint->mapped) {
+        munmap(checkpoint->blob, checkpoint->blob_size);
+    } else {
+        free(checkpoint->blob);
+    }
+    free(checkpoint);
+}
+
+// FUNCTION TO FIND A TENSOR BY NAME
+const CheckpointTensor* checkpoint_find(const Checkpoint* checkpoint, const char* name) {
+    if (checkpoint == NULL || name == NULL) return NULL;
+
+    for (int i = 0; i < checkpoint->num_tensors; i++) {
+        if (strcmp(checkpoint->tensors[i].name, name) == 0) {
+            return &checkpoint->tensors[i];
+        }
+    }
+    return NULL;
+}
+
+// FUNCTION TO COPY A FLOATING-POINT TENSOR INTO A DOUBLE BUFFER
+long checkpoint_read_f64(const Checkpoint* checkpoint, const char* name, double* dst, long count) {
+    const CheckpointTensor* t = checkpoint_find(checkpoint, name);
+    if (t == NULL || dst == NULL || (t->dtype != CHECKPOINT_F32 && t->dtype != CHECKPOINT_F64)) return -1;
+
+    long n = (long)(t->nbytes / checkpoint_dtype_size(t->dtype));
+    if (n > count) n = count;
+    for (long i = 0; i < n; i++) {
+        dst[i] = (t->dtype == CHECKPOINT_F64) ? ((const double*)t->data)[i] : ((const float*)t->data)[i];
+    }
+    return n;
+}
+
+// FUNCTION TO COPY A FLOATING-POINT TENSOR INTO A FLOAT BUFFER
+long checkpoint_read_f32(const Checkpoint* checkpoint, const char* name, float* dst, long count) {
+    const CheckpointTensor* t = checkpoint_find(checkpoint, name);
+    if (t == NULL || dst == NULL || (t->dtype != CHECKPOINT_F32 && t->dtype != CHECKPOINT_F64)) return -1;
+
+    long n = (long)(t->nbytes / checkpoint_dtype_size(t->dtype));
+    if (n > count) n = count;
+    if (t->dtype == CHECKPOINT_F32) {
+        memcpy(dst, t->data, (size_t)n * sizeof(float));
+    } else {
+        for (long i = 0; i < n; i++) dst[i] = (float)((const double*)t->data)[i];
+    }
+    return n;
+}
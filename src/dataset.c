@@ -0,0 +1,317 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/dataset.h"
+
+// FUNCTION TO PACK A TOKENIZED CORPUS INTO ONE BUFFER
+TokenDataset* token_dataset_from_corpus(const TokenizedCorpus* corpus, uint32_t vocab_size) {
+    if (corpus == NULL || vocab_size == 0) return NULL;
+
+    // Narrow ids to 16 bits when the vocabulary allows it (half the memory and the file)
+    CheckpointDType id_type = (vocab_size <= 65536) ? CHECKPOINT_U16 : CHECKPOINT_U32;
+    size_t offsets_bytes = (corpus->num_sentences + 1) * sizeof(uint64_t);
+    size_t ids_bytes = corpus->num_ids * checkpoint_dtype_size(id_type);
+
+    TokenDataset* dataset = (TokenDataset*)malloc(sizeof(TokenDataset));
+    void* storage = malloc(offsets_bytes + (ids_bytes > 0 ? ids_bytes : 1));
+    if (dataset == NULL || storage == NULL) {
+        free(dataset);
+        free(storage);
+        return NULL;
+    }
+
+    uint64_t* offsets = (uint64_t*)storage;
+    for (size_t s = 0; s <= corpus->num_sentences; s++) offsets[s] = corpus->sentence_starts[s];
+
+    void* ids = (char*)storage + offsets_bytes;
+    if (id_type == CHECKPOINT_U16) {
+        uint16_t* narrow = (uint16_t*)ids;
+        for (size_t i = 0; i < corpus->num_ids; i++) narrow[i] = (uint16_t)corpus->ids[i];
+    } else if (ids_bytes > 0) {
+        memcpy(ids, corpus->ids, ids_bytes);
+    }
+
+    dataset->checkpoint = NULL;
+    dataset->storage = storage;
+    dataset->id_type = id_type;
+    dataset->ids = ids;
+    dataset->sentence_offsets = offsets;
+    dataset->num_ids = corpus->num_ids;
+    dataset->num_sentences = corpus->num_sentences;
+    dataset->vocab_size = vocab_size;
+    return dataset;
+}
+
+// FUNCTION TO WRITE A PACKED DATASET AS A DATASET FILE
+int write_token_dataset(const char* path, const TokenDataset* dataset) {
+    if (dataset == NULL) return 0;
+
+    uint32_t meta[2] = { TOKEN_DATASET_VERSION, dataset->vocab_size };
+    long meta_shape[1] = { 2 };
+    long ids_shape[1] = { (long)dataset->num_ids };
+    long offsets_shape[1] = { (long)dataset->num_sentences + 1 };
+    CheckpointTensor tensors[3];
+
+    return checkpoint_tensor_init(&tensors[0], "dataset.meta", CHECKPOINT_U32, 1, meta_shape, meta) &&
+           checkpoint_tensor_init(&tensors[1], "dataset.ids", dataset->id_type, 1, ids_shape, (void*)dataset->ids) &&
+           checkpoint_tensor_init(&tensors[2], "dataset.offsets", CHECKPOINT_U64, 1, offsets_shape,
+                                  (void*)dataset->sentence_offsets) &&
+           checkpoint_save(path, tensors, 3);
+}
+
+// FUNCTION TO WRITE A TOKENIZED CORPUS AS A DATASET FILE
+int save_token_dataset(const char* path, const TokenizedCorpus* corpus, uint32_t vocab_size) {
+    TokenDataset* dataset = token_dataset_from_corpus(corpus, vocab_size);
+    int ok = write_token_dataset(path, dataset);
+    free_token_dataset(dataset);
+    return ok;
+}
+
+// FUNCTION TO MAP A DATASET FILE AND CHECK ITS TENSORS
+TokenDataset* load_token_dataset(const char* path, uint32_t expected_vocab_size) {
+    Checkpoint* checkpoint = checkpoint_map(path, CHECKPOINT_MAP_DEFAULT);
+    if (checkpoint == NULL) return NULL;
+
+    const CheckpointTensor* meta = checkpoint_find(checkpoint, "dataset.meta");
+    const CheckpointTensor* ids = checkpoint_find(checkpoint, "dataset.ids");
+    const CheckpointTensor* offsets = checkpoint_find(checkpoint, "dataset.offsets");
+
+    if (meta == NULL || meta->dtype != CHECKPOINT_U32 || meta->ndim != 1 || meta->shape[0] != 2 ||
+        ids == NULL || (ids->dtype != CHECKPOINT_U16 && ids->dtype != CHECKPOINT_U32) || ids->ndim != 1 ||
+        offsets == NULL || offsets->dtype != CHECKPOINT_U64 || offsets->ndim != 1 || offsets->shape[0] < 1 ||
+        meta->nbytes != 2 * sizeof(uint32_t) ||
+        ids->nbytes != (size_t)ids->shape[0] * checkpoint_dtype_size(ids->dtype) ||
+        offsets->nbytes != (size_t)offsets->shape[0] * sizeof(uint64_t)) {
+        fprintf(stderr, "Dataset %s is missing or has malformed tensors\n", path);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+
+    const uint32_t* header = (const uint32_t*)meta->data;
+    if (header[0] != TOKEN_DATASET_VERSION) {
+        fprintf(stderr, "Dataset %s has version %u (expected %d)\n", path, header[0], TOKEN_DATASET_VERSION);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+    if (expected_vocab_size != 0 && header[1] != expected_vocab_size) {
+        fprintf(stderr, "Dataset %s was tokenized with %u token ids, the vocabulary has %u\n",
+                path, header[1], expected_vocab_size);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+
+    // Only the ends of the index are checked here, so loading never reads the
+    // whole file; token_dataset_sentence_length guards each sentence instead
+    const uint64_t* sentence_offsets = (const uint64_t*)offsets->data;
+    size_t num_sentences = (size_t)offsets->shape[0] - 1;
+    int valid = sentence_offsets[0] == 0 && sentence_offsets[num_sentences] == (uint64_t)ids->shape[0];
+    TokenDataset* dataset = valid ? (TokenDataset*)malloc(sizeof(TokenDataset)) : NULL;
+    if (dataset == NULL) {
+        if (!valid) fprintf(stderr, "Dataset %s has an invalid sentence index\n", path);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+
+    dataset->checkpoint = checkpoint;
+    dataset->storage = NULL;
+    dataset->id_type = ids->dtype;
+    dataset->ids = ids->data;
+    dataset->sentence_offsets = sentence_offsets;
+    dataset->num_ids = (size_t)ids->shape[0];
+    dataset->num_sentences = num_sentences;
+    dataset->vocab_size = header[1];
+    return dataset;
+}
+
+// FUNCTION TO UNMAP (OR FREE THE STORAGE OF) AND FREE A DATASET
+void free_token_dataset(TokenDataset* dataset) {
+    if (dataset == NULL) return;
+    free_checkpoint(dataset->checkpoint);
+    free(dataset->storage);
+    free(dataset);
+}
+
+// FUNCTION TO GET THE NUMBER OF TOKENS OF A SENTENCE
+size_t token_dataset_sentence_length(const TokenDataset* dataset, size_t sentence) {
+    if (dataset == NULL || sentence >= dataset->num_sentences) return 0;
+
+    uint64_t start = dataset->sentence_offsets[sentence];
+    uint64_t end = dataset->sentence_offsets[sentence + 1];
+    if (start > end || end > dataset->num_ids) return 0;  // Corrupt index entry
+    return (size_t)(end - start);
+}
+
+// FUNCTION TO COPY A SENTENCE INTO A FIXED-LENGTH, ZERO-PADDED ROW
+size_t token_dataset_copy_sentence(const TokenDataset* dataset, size_t sentence, int* row, size_t row_length) {
+    size_t length = token_dataset_sentence_length(dataset, sentence);
+    if (length > row_length) length = row_length;
+
+    if (length > 0) {
+        size_t start = (size_t)dataset->sentence_offsets[sentence];
+        if (dataset->id_type == CHECKPOINT_U16) {
+            const uint16_t* ids = (const uint16_t*)dataset->ids + start;
+            for (size_t i = 0; i < length; i++) row[i] = ids[i];
+        } else {
+            const uint32_t* ids = (const uint32_t*)dataset->ids + start;
+            for (size_t i = 0; i < length; i++) row[i] = (int)ids[i];
+        }
+    }
+    for (size_t i = length; i < row_length; i++) row[i] = 0;
+    return length;
+}
+
+// FUNCTION TO GET A VIEW OF A SENTENCE
+TokenSequence token_dataset_sequence(const TokenDataset* dataset, size_t sentence) {
+    TokenSequence sequence = { CHECKPOINT_U16, NULL, 0 };
+    sequence.length = token_dataset_sentence_length(dataset, sentence);
+
+    if (sequence.length > 0) {
+        size_t start = (size_t)dataset->sentence_offsets[sentence];
+        sequence.id_type = dataset->id_type;
+        sequence.ids = (const char*)dataset->ids + start * checkpoint_dtype_size(dataset->id_type);
+    }
+    return sequence;
+}
+
+// FUNCTION TO GET ONE TOKEN OF A SEQUENCE
+uint32_t token_sequence_id(const TokenSequence* sequence, size_t i) {
+    if (sequence->id_type == CHECKPOINT_U16) return ((const uint16_t*)sequence->ids)[i];
+    return ((const uint32_t*)sequence->ids)[i];
+}
+
+// FUNCTION TO GATHER THE EMBEDDINGS OF A SEQUENCE, ZERO-PADDED TO A NUMBER OF ROWS
+void token_sequence_gather_embeddings(const TokenSequence* sequence, size_t count, size_t rows, float* output) {
+    if (count > sequence->length) count = sequence->length;
+    if (count > rows) count = rows;
+
+    for (size_t i = 0; i < count; i++) {
+        float* out = output + i * TOKEN_EMBEDDING_DIM;
+        uint32_t token_id = token_sequence_id(sequence, i);
+        const float* row = (token_id > 0) ? getEmbedding(token_id) : NULL;
+
+        if (row != NULL) {
+            memcpy(out, row, TOKEN_EMBEDDING_DIM * sizeof(float));
+        } else {
+            memset(out, 0, TOKEN_EMBEDDING_DIM * sizeof(float));
+        }
+    }
+    memset(output + count * TOKEN_EMBEDDING_DIM, 0, (rows - count) * TOKEN_EMBEDDING_DIM * sizeof(float));
+}
+
+// FUNCTION TO DRAW A RANDOM NUMBER (XORSHIFT64*) BELOW bound
+static size_t next_random_below(uint64_t* state, size_t bound) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return (size_t)((x * 0x2545F4914F6CDD1DULL) >> 11) % bound;
+}
+
+// FUNCTION TO SHUFFLE count INDICES IN PLACE
+static void shuffle_indices(size_t* indices, size_t count, uint64_t* state) {
+    for (size_t i = count; i > 1; i--) {
+        size_t j = next_random_below(state, i);
+        size_t tmp = indices[i - 1];
+        indices[i - 1] = indices[j];
+        indices[j] = tmp;
+    }
+}
+
+// FUNCTION TO GET THE LENGTH A SENTENCE IS BUCKETED WITH
+static size_t clamped_length(const TokenBatchSampler* sampler, size_t sentence) {
+    size_t length = token_dataset_sentence_length(sampler->dataset, sentence);
+    return length < sampler->max_length ? length : sampler->max_length;
+}
+
+// FUNCTION TO CREATE A LENGTH-BUCKETED BATCH SAMPLER
+TokenBatchSampler* create_token_batch_sampler(const TokenDataset* dataset, size_t batch_size, size_t max_length,
+                                              uint64_t seed) {
+    if (dataset == NULL || batch_size == 0 || max_length == 0) return NULL;
+
+    TokenBatchSampler* sampler = (TokenBatchSampler*)calloc(1, sizeof(TokenBatchSampler));
+    if (sampler == NULL) return NULL;
+
+    sampler->dataset = dataset;
+    sampler->batch_size = batch_size;
+    sampler->max_length = max_length;
+    sampler->num_sentences = dataset->num_sentences;
+    sampler->num_batches = (dataset->num_sentences + batch_size - 1) / batch_size;
+    sampler->random_state = seed * 0x9E3779B97F4A7C15ULL + 1;  // Never 0, the fixed point of xorshift
+
+    sampler->order = (size_t*)malloc((sampler->num_sentences + 1) * sizeof(size_t));
+    sampler->sorted = (size_t*)malloc((sampler->num_sentences + 1) * sizeof(size_t));
+    sampler->batch_starts = (size_t*)malloc((sampler->num_batches + 1) * sizeof(size_t));
+    sampler->batch_ids = (size_t*)malloc((sampler->num_batches + 1) * sizeof(size_t));
+    sampler->bucket_starts = (size_t*)malloc((max_length + 2) * sizeof(size_t));
+    if (sampler->order == NULL || sampler->sorted == NULL || sampler->batch_starts == NULL ||
+        sampler->batch_ids == NULL || sampler->bucket_starts == NULL) {
+        fprintf(stderr, "Failed to allocate a batch sampler over %zu sentences\n", sampler->num_sentences);
+        free_token_batch_sampler(sampler);
+        return NULL;
+    }
+
+    token_batch_sampler_next_epoch(sampler);
+    return sampler;
+}
+
+// FUNCTION TO FREE A BATCH SAMPLER
+void free_token_batch_sampler(TokenBatchSampler* sampler) {
+    if (sampler == NULL) return;
+    free(sampler->order);
+    free(sampler->sorted);
+    free(sampler->batch_starts);
+    free(sampler->batch_ids);
+    free(sampler->bucket_starts);
+    free(sampler);
+}
+
+// FUNCTION TO DRAW THE BATCHES OF THE NEXT EPOCH
+void token_batch_sampler_next_epoch(TokenBatchSampler* sampler) {
+    size_t* starts = sampler->bucket_starts;
+    size_t buckets = sampler->max_length + 1;
+
+    // Counting sort of the sentences by clamped length
+    memset(starts, 0, (buckets + 1) * sizeof(size_t));
+    for (size_t s = 0; s < sampler->num_sentences; s++) starts[clamped_length(sampler, s) + 1]++;
+    for (size_t b = 0; b < buckets; b++) starts[b + 1] += starts[b];
+    for (size_t s = 0; s < sampler->num_sentences; s++) sampler->sorted[starts[clamped_length(sampler, s)]++] = s;
+
+    // Shuffle the sentences of equal length, so batches differ from epoch to epoch
+    size_t begin = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        shuffle_indices(sampler->sorted + begin, starts[b] - begin, &sampler->random_state);
+        begin = starts[b];
+    }
+
+    // Cut the sorted sentences into batches and lay the batches out in random order
+    for (size_t i = 0; i < sampler->num_batches; i++) sampler->batch_ids[i] = i;
+    shuffle_indices(sampler->batch_ids, sampler->num_batches, &sampler->random_state);
+
+    size_t position = 0;
+    for (size_t i = 0; i < sampler->num_batches; i++) {
+        size_t first = sampler->batch_ids[i] * sampler->batch_size;
+        size_t count = sampler->num_sentences - first;
+        if (count > sampler->batch_size) count = sampler->batch_size;
+
+        sampler->batch_starts[i] = position;
+        memcpy(sampler->order + position, sampler->sorted + first, count * sizeof(size_t));
+        position += count;
+    }
+    sampler->batch_starts[sampler->num_batches] = position;
+}
+
+// FUNCTION TO GET A BATCH OF THE CURRENT EPOCH
+size_t token_batch_sampler_batch(const TokenBatchSampler* sampler, size_t i, const size_t** sentences,
+                                 size_t* longest) {
+    if (sampler == NULL || i >= sampler->num_batches) return 0;
+
+    size_t start = sampler->batch_starts[i];
+    size_t count = sampler->batch_starts[i + 1] - start;
+
+    // Batches keep the sorted order, so the last sentence is the longest
+    *sentences = sampler->order + start;
+    if (longest != NULL) *longest = clamped_length(sampler, sampler->order[start + count - 1]);
+    return count;
+}
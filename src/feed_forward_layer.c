@@ -31,14 +31,25 @@ void read_weights(const char* path, double* weights, int num_weights) {
     }
 }
 
+// READ THE WEIGHTS FROM A BINARY CHECKPOINT
+int read_weights_from_checkpoint(const Checkpoint* checkpoint, const char* name, double* weights, int num_weights) {
+    long read = checkpoint_read_f64(checkpoint, name, weights, num_weights);
+    if (read < 0) {
+        fprintf(stderr, "Checkpoint has no floating-point tensor %s\n", name);
+        return 0;
+    }
+    return 1;
+}
+
 // Create a new feed forward layer
 FeedForwardLayer* create_feed_forward_layer(int input_size, int hidden_size, int output_size) {
-    FeedForwardLayer* layer = (FeedForwardLayer*)malloc(sizeof(FeedForwardLayer));
+    FeedForwardLayer* layer = (FeedForwardLayer*)calloc(1, sizeof(FeedForwardLayer));
     if (layer == NULL) return NULL;
 
     layer->input_size = input_size;
     layer->hidden_size = hidden_size;
     layer->output_size = output_size;
+    layer->owns_weights = 1;
 
     // Allocate memory for weights and biases
     layer->weights1 = (double*)malloc(input_size * hidden_size * sizeof(double));
@@ -67,14 +78,74 @@ FeedForwardLayer* create_feed_forward_layer(int input_size, int hidden_size, int
     return layer;
 }
 
+// Parameter tensor suffixes, in FeedForwardLayer field order
+static const char* parameter_names[4] = { "weights1", "weights2", "bias1", "bias2" };
+
+// Create a feed forward layer on top of checkpoint views
+FeedForwardLayer* create_feed_forward_layer_from_checkpoint(const Checkpoint* checkpoint, const char* prefix,
+                                                            int input_size, int hidden_size, int output_size) {
+    if (checkpoint == NULL || prefix == NULL) return NULL;
+
+    long counts[4] = { (long)input_size * hidden_size, (long)hidden_size * output_size, hidden_size, output_size };
+    double* views[4];
+    char name[CHECKPOINT_NAME_LEN];
+
+    for (int i = 0; i < 4; i++) {
+        snprintf(name, sizeof(name), "%s.%s", prefix, parameter_names[i]);
+        views[i] = (double*)checkpoint_view(checkpoint, name, CHECKPOINT_F64, counts[i]);
+        if (views[i] == NULL) {
+            fprintf(stderr, "Checkpoint has no F64 tensor %s of %ld values\n", name, counts[i]);
+            return NULL;
+        }
+    }
+
+    FeedForwardLayer* layer = (FeedForwardLayer*)calloc(1, sizeof(FeedForwardLayer));
+    if (layer == NULL) return NULL;
+
+    layer->input_size = input_size;
+    layer->hidden_size = hidden_size;
+    layer->output_size = output_size;
+    layer->weights1 = views[0];
+    layer->weights2 = views[1];
+    layer->bias1 = views[2];
+    layer->bias2 = views[3];
+    layer->owns_weights = 0;
+    return layer;
+}
+
+// Describe the layer parameters as checkpoint tensors
+int feed_forward_layer_checkpoint_tensors(const FeedForwardLayer* layer, const char* prefix, CheckpointTensor* tensors) {
+    if (layer == NULL || prefix == NULL || tensors == NULL) return 0;
+
+    long shapes[4][2] = {
+        { layer->input_size, layer->hidden_size },
+        { layer->hidden_size, layer->output_size },
+        { layer->hidden_size, 0 },
+        { layer->output_size, 0 }
+    };
+    double* data[4] = { layer->weights1, layer->weights2, layer->bias1, layer->bias2 };
+    char name[CHECKPOINT_NAME_LEN];
+
+    for (int i = 0; i < 4; i++) {
+        snprintf(name, sizeof(name), "%s.%s", prefix, parameter_names[i]);
+        if (!checkpoint_tensor_init(&tensors[i], name, CHECKPOINT_F64, i < 2 ? 2 : 1, shapes[i], data[i])) {
+            return 0;
+        }
+    }
+    return 4;
+}
+
 // Free the feed forward layer
 void free_feed_forward_layer(FeedForwardLayer* layer) {
     if (layer == NULL) return;
     
-    free(layer->weights1);
-    free(layer->weights2);
-    free(layer->bias1);
-    free(layer->bias2);
+    if (layer->owns_weights) {
+        free(layer->weights1);
+        free(layer->weights2);
+        free(layer->bias1);
+        free(layer->bias2);
+    }
+    free(layer->hidden);
     free(layer);
 }
 
@@ -83,37 +154,74 @@ static double relu(double x) {
     return x > 0 ? x : 0;
 }
 
-// Forward pass through the feed forward layer
-double* feed_forward_forward(FeedForwardLayer* layer, const double* input) {
-    if (layer == NULL || input == NULL) return NULL;
-
-    // Allocate memory for hidden layer and output
-    double* hidden = (double*)malloc(layer->hidden_size * sizeof(double));
-    double* output = (double*)malloc(layer->output_size * sizeof(double));
-    
-    if (hidden == NULL || output == NULL) {
-        free(hidden);
-        free(output);
-        return NULL;
+// Compute out[b] = act(bias + in[b] * W) for every sample of a batch.
+// The loop over samples is innermost, so each weight row is read from memory
+// once per batch and then reused from cache for every sample.
+static void linear_batch(const double* in, int in_size, const double* weights, const double* bias,
+                         double* out, int out_size, int batch, int apply_relu) {
+    for (int b = 0; b < batch; b++) {
+        memcpy(out + (size_t)b * out_size, bias, out_size * sizeof(double));
     }
 
-    // First layer: input -> hidden
-    for (int i = 0; i < layer->hidden_size; i++) {
-        hidden[i] = layer->bias1[i];
-        for (int j = 0; j < layer->input_size; j++) {
-            hidden[i] += input[j] * layer->weights1[j * layer->hidden_size + i];
+    for (int j = 0; j < in_size; j++) {
+        const double* w_row = weights + (size_t)j * out_size;
+        for (int b = 0; b < batch; b++) {
+            const double x = in[(size_t)b * in_size + j];
+            double* o = out + (size_t)b * out_size;
+            for (int i = 0; i < out_size; i++) {
+                o[i] += x * w_row[i];
+            }
         }
-        hidden[i] = relu(hidden[i]);  // Apply ReLU activation
     }
 
-    // Second layer: hidden -> output
-    for (int i = 0; i < layer->output_size; i++) {
-        output[i] = layer->bias2[i];
-        for (int j = 0; j < layer->hidden_size; j++) {
-            output[i] += hidden[j] * layer->weights2[j * layer->output_size + i];
+    if (apply_relu) {
+        for (size_t i = 0; i < (size_t)batch * out_size; i++) {
+            out[i] = relu(out[i]);  // Apply ReLU activation
         }
     }
+}
+
+// FUNCTION TO GROW THE HIDDEN WORKSPACE TO HOLD rows SAMPLES
+static int ensure_hidden_workspace(FeedForwardLayer* layer, int rows) {
+    if (rows <= layer->workspace_rows) return 1;
+
+    double* hidden = (double*)realloc(layer->hidden, (size_t)rows * layer->hidden_size * sizeof(double));
+    if (hidden == NULL) {
+        fprintf(stderr, "feed_forward_forward_batch: failed to grow the workspace to %d rows\n", rows);
+        return 0;
+    }
+    layer->hidden = hidden;
+    layer->workspace_rows = rows;
+    return 1;
+}
+
+// Forward pass through the feed forward layer for a batch of inputs
+int feed_forward_forward_batch(FeedForwardLayer* layer, const double* inputs, double* outputs, int batch, double* scratch) {
+    if (layer == NULL || inputs == NULL || outputs == NULL || batch <= 0) return 0;
+
+    if (scratch == NULL) {
+        if (!ensure_hidden_workspace(layer, batch)) return 0;
+        scratch = layer->hidden;
+    }
 
-    free(hidden);
+    // First layer: input -> hidden, then hidden -> output
+    linear_batch(inputs, layer->input_size, layer->weights1, layer->bias1,
+                 scratch, layer->hidden_size, batch, 1);
+    linear_batch(scratch, layer->hidden_size, layer->weights2, layer->bias2,
+                 outputs, layer->output_size, batch, 0);
+    return 1;
+}
+
+// Forward pass through the feed forward layer
+double* feed_forward_forward(FeedForwardLayer* layer, const double* input) {
+    if (layer == NULL || input == NULL) return NULL;
+
+    double* output = (double*)malloc(layer->output_size * sizeof(double));
+    if (output == NULL) return NULL;
+
+    if (!feed_forward_forward_batch(layer, input, output, 1, NULL)) {
+        free(output);
+        return NULL;
+    }
     return output;
-}
\ No newline at end of file
+}
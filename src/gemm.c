@@ -0,0 +1,298 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/gemm.h"
+#include "../include/kernels.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// CACHE BLOCKING: A KC x NR SLIVER OF B STAYS IN L1, THE MC x KC BLOCK OF A
+// IN L2 AND THE KC x NC PANEL OF B IN L3. MC AND NC MUST BE MULTIPLES OF
+// EVERY MICRO-KERNEL'S MR AND NR (SEE kernels.c)
+#define GEMM_MC 144
+#define GEMM_KC 256
+#define GEMM_NC 4096
+
+// PRODUCTS SMALLER THAN THIS (M * N * K) ARE NOT WORTH PACKING
+#define GEMM_SMALL_WORK (16 * 16 * 16)
+
+// PRODUCTS SMALLER THAN THIS (M * N * K) STAY ON THE CALLING THREAD
+#define GEMM_PARALLEL_WORK (64 * 64 * 64)
+
+// Packing buffers of the calling thread, allocated on first use and reused by
+// every later call. packed_a holds one MC x KC block per worker of the team.
+static _Thread_local float* packed_a = NULL;
+static _Thread_local float* packed_b = NULL;
+static _Thread_local int packed_a_workers = 0;
+
+// Requested worker count (0 = use every thread OpenMP offers)
+static int gemm_num_threads = 0;
+
+// Everything a worker needs to run its share of one gemm_f32 call
+typedef struct {
+    const KernelTable* kt;
+    int trans_a, trans_b, M, N, K;
+    float alpha, beta;
+    const float *A, *B;
+    float *C;
+    int lda, ldb, ldc;
+} GemmArgs;
+
+static int min_int(int a, int b) {
+    return a < b ? a : b;
+}
+
+// FUNCTION TO ALLOCATE THE PACKING BUFFERS (GROWN ONLY WHEN THE TEAM GROWS)
+static int ensure_pack_buffers(int workers) {
+    if (packed_a_workers < workers) {
+        free(packed_a);
+        packed_a = (float*)aligned_alloc(64, (size_t)workers * GEMM_MC * GEMM_KC * sizeof(float));
+        packed_a_workers = (packed_a != NULL) ? workers : 0;
+    }
+    if (packed_b == NULL) {
+        packed_b = (float*)aligned_alloc(64, GEMM_KC * GEMM_NC * sizeof(float));
+    }
+    return packed_a != NULL && packed_b != NULL;
+}
+
+// SET THE NUMBER OF WORKER THREADS USED BY LARGE PRODUCTS
+void gemm_set_num_threads(int num_threads) {
+    gemm_num_threads = num_threads > 0 ? num_threads : 0;
+}
+
+// GET THE NUMBER OF WORKER THREADS USED BY LARGE PRODUCTS
+int gemm_get_num_threads(void) {
+#ifdef _OPENMP
+    return gemm_num_threads > 0 ? gemm_num_threads : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// PICK HOW MANY WORKERS A PRODUCT OF THIS SIZE DESERVES
+static int workers_for(int M, int N, int K) {
+#ifdef _OPENMP
+    // Nested calls (e.g. from per-head loops) run serially inside their worker
+    if ((long)M * N * K < GEMM_PARALLEL_WORK || omp_in_parallel()) return 1;
+    return gemm_get_num_threads();
+#else
+    (void)M; (void)N; (void)K;
+    return 1;
+#endif
+}
+
+// FUNCTION TO SCALE C BY BETA (USED WHEN THE PRODUCT TERM VANISHES)
+static void scale_c(int M, int N, float beta, float *C, int ldc) {
+    for (int i = 0; i < M; i++) {
+        float *c_row = C + (size_t)i * ldc;
+        for (int j = 0; j < N; j++) {
+            c_row[j] = (beta == 0.0f) ? 0.0f : beta * c_row[j];
+        }
+    }
+}
+
+// FUNCTION TO MULTIPLY SMALL MATRICES WITHOUT PACKING
+static void gemm_small(int trans_a, int trans_b, int M, int N, int K,
+                       float alpha, const float *A, int lda,
+                       const float *B, int ldb,
+                       float beta, float *C, int ldc) {
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < N; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < K; k++) {
+                float a = trans_a ? A[(size_t)k * lda + i] : A[(size_t)i * lda + k];
+                float b = trans_b ? B[(size_t)j * ldb + k] : B[(size_t)k * ldb + j];
+                sum += a * b;
+            }
+            float *c = &C[(size_t)i * ldc + j];
+            *c = (beta == 0.0f) ? alpha * sum : alpha * sum + beta * (*c);
+        }
+    }
+}
+
+// FUNCTION TO MULTIPLY A SINGLE ROW OF A (M == 1, A NOT TRANSPOSED)
+// Packing B would cost as much as the product itself, so stream B once:
+// as row updates (axpy) when B is K x N, or as dot products when it is N x K.
+static void gemv_row(const KernelTable* kt, int trans_b, int N, int K,
+                     float alpha, const float *a, const float *B, int ldb,
+                     float beta, float *c) {
+    if (trans_b) {
+        for (int j = 0; j < N; j++) {
+            float sum = alpha * kt->dot(a, B + (size_t)j * ldb, K);
+            c[j] = (beta == 0.0f) ? sum : sum + beta * c[j];
+        }
+        return;
+    }
+
+    scale_c(1, N, beta, c, N);
+    for (int k = 0; k < K; k++) {
+        kt->axpy(N, alpha * a[k], B + (size_t)k * ldb, c);
+    }
+}
+
+// FUNCTION TO PACK AN MC x KC BLOCK OF op(A) INTO MR-ROW PANELS
+static void pack_a(int trans_a, const float *A, int lda, int i0, int k0, int mc, int kc,
+                   int MR, float *dst) {
+    for (int ir = 0; ir < mc; ir += MR) {
+        int mr = min_int(MR, mc - ir);
+        for (int k = 0; k < kc; k++) {
+            for (int r = 0; r < mr; r++) {
+                int i = i0 + ir + r;
+                dst[r] = trans_a ? A[(size_t)(k0 + k) * lda + i] : A[(size_t)i * lda + k0 + k];
+            }
+            for (int r = mr; r < MR; r++) {
+                dst[r] = 0.0f;
+            }
+            dst += MR;
+        }
+    }
+}
+
+// FUNCTION TO PACK A KC x NC PANEL OF op(B) INTO NR-COLUMN SLIVERS
+static void pack_b(int trans_b, const float *B, int ldb, int k0, int j0, int kc, int nc,
+                   int NR, float *dst) {
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = min_int(NR, nc - jr);
+        for (int k = 0; k < kc; k++) {
+            if (!trans_b) {
+                memcpy(dst, B + (size_t)(k0 + k) * ldb + j0 + jr, nr * sizeof(float));
+            } else {
+                for (int c = 0; c < nr; c++) {
+                    dst[c] = B[(size_t)(j0 + jr + c) * ldb + k0 + k];
+                }
+            }
+            for (int c = nr; c < NR; c++) {
+                dst[c] = 0.0f;
+            }
+            dst += NR;
+        }
+    }
+}
+
+// FUNCTION TO WAIT FOR THE REST OF THE TEAM
+// Only a real team synchronizes: a serial call made from inside another
+// parallel region must not bind to that region's barrier.
+static void team_barrier(int workers) {
+#ifdef _OPENMP
+    if (workers > 1) {
+        #pragma omp barrier
+    }
+#else
+    (void)workers;
+#endif
+}
+
+// FUNCTION RUN BY EVERY WORKER OF THE TEAM
+// The KC x NC panel of B is packed cooperatively into the shared buffer, then
+// (MC block of A, group of NR slivers of B) tiles are split statically across
+// the team. Each worker packs the A blocks it needs into its own slot. Work is
+// partitioned by hand rather than with omp for, so the same code runs
+// unchanged on a single worker nested inside an unrelated parallel region.
+static void gemm_team(const GemmArgs* g, int workers, float* packed_a_team, float* packed_b_team) {
+    const int MR = g->kt->gemm_mr;
+    const int NR = g->kt->gemm_nr;
+#ifdef _OPENMP
+    const int tid = (workers > 1) ? omp_get_thread_num() : 0;
+#else
+    const int tid = 0;
+#endif
+    float* my_packed_a = packed_a_team + (size_t)tid * GEMM_MC * GEMM_KC;
+
+    for (int jc = 0; jc < g->N; jc += GEMM_NC) {
+        int nc = min_int(GEMM_NC, g->N - jc);
+        int n_slivers = (nc + NR - 1) / NR;
+        int n_blocks = (g->M + GEMM_MC - 1) / GEMM_MC;
+
+        // Enough tiles for a few per worker without splitting slivers
+        int slivers_per_tile = (n_blocks * n_slivers) / (workers * 4);
+        if (slivers_per_tile < 1) slivers_per_tile = 1;
+        int n_groups = (n_slivers + slivers_per_tile - 1) / slivers_per_tile;
+        int n_tiles = n_blocks * n_groups;
+
+        for (int pc = 0; pc < g->K; pc += GEMM_KC) {
+            int kc = min_int(GEMM_KC, g->K - pc);
+            // Only the first K block applies beta; later blocks accumulate
+            float beta_block = (pc == 0) ? g->beta : 1.0f;
+            int packed_block = -1;
+
+            for (int s = n_slivers * tid / workers; s < n_slivers * (tid + 1) / workers; s++) {
+                int jr = s * NR;
+                pack_b(g->trans_b, g->B, g->ldb, pc, jc + jr, kc, min_int(NR, nc - jr), NR,
+                       packed_b_team + (size_t)jr * kc);
+            }
+            team_barrier(workers);
+
+            for (int t = n_tiles * tid / workers; t < n_tiles * (tid + 1) / workers; t++) {
+                int block = t / n_groups;
+                int ic = block * GEMM_MC;
+                int mc = min_int(GEMM_MC, g->M - ic);
+
+                if (block != packed_block) {
+                    pack_a(g->trans_a, g->A, g->lda, ic, pc, mc, kc, MR, my_packed_a);
+                    packed_block = block;
+                }
+
+                int s_end = min_int((t % n_groups + 1) * slivers_per_tile, n_slivers);
+                for (int s = (t % n_groups) * slivers_per_tile; s < s_end; s++) {
+                    int jr = s * NR;
+                    int nr = min_int(NR, nc - jr);
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        int mr = min_int(MR, mc - ir);
+                        g->kt->gemm_ukernel(kc, my_packed_a + (size_t)ir * kc, packed_b_team + (size_t)jr * kc,
+                                            g->C + (size_t)(ic + ir) * g->ldc + jc + jr, g->ldc,
+                                            mr, nr, g->alpha, beta_block);
+                    }
+                }
+            }
+            // The shared B panel is repacked by the next K block
+            team_barrier(workers);
+        }
+    }
+}
+
+// FUNCTION TO COMPUTE C = ALPHA * op(A) * op(B) + BETA * C
+void gemm_f32(int trans_a, int trans_b, int M, int N, int K,
+              float alpha, const float *A, int lda,
+              const float *B, int ldb,
+              float beta, float *C, int ldc) {
+    if (M <= 0 || N <= 0) return;
+
+    if (K <= 0 || alpha == 0.0f) {
+        scale_c(M, N, beta, C, ldc);
+        return;
+    }
+
+    if (M == 1 && !trans_a && (long)N * K > GEMM_SMALL_WORK) {
+        gemv_row(kernels(), trans_b, N, K, alpha, A, B, ldb, beta, C);
+        return;
+    }
+
+    int workers = workers_for(M, N, K);
+
+    if ((long)M * N * K <= GEMM_SMALL_WORK || !ensure_pack_buffers(workers)) {
+        gemm_small(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+        return;
+    }
+
+    GemmArgs g = { kernels(), trans_a, trans_b, M, N, K, alpha, beta, A, B, C, lda, ldb, ldc };
+
+    if (workers == 1) {
+        gemm_team(&g, 1, packed_a, packed_b);
+        return;
+    }
+
+    // The OpenMP team is created once and parked between calls, so this does
+    // not spawn threads; proc_bind(close) keeps workers on the places given by
+    // OMP_PLACES (e.g. OMP_PLACES=cores) so their caches stay warm.
+    // OpenMP may grant fewer threads than requested (OMP_DYNAMIC, a thread
+    // limit), so the work is split over the team actually running; packed_a
+    // has a slot for every requested worker, which covers any smaller team.
+    float* team_a = packed_a;
+    float* team_b = packed_b;
+    #pragma omp parallel num_threads(workers) proc_bind(close)
+    {
+        gemm_team(&g, omp_get_num_threads(), team_a, team_b);
+    }
+}
@@ -0,0 +1,790 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Range of exp() arguments the vector versions handle; below it they return 0
+#define EXP_HI 88.3762626647949f
+#define EXP_LO -87.3365447504f
+
+// Cephes polynomial for exp(r) on [-ln2/2, ln2/2]
+#define EXP_LOG2E 1.44269504088896341f
+#define EXP_LN2_HI 0.693359375f
+#define EXP_LN2_LO -2.12194440e-4f
+#define EXP_P0 1.9875691500E-4f
+#define EXP_P1 1.3981999507E-3f
+#define EXP_P2 8.3334519073E-3f
+#define EXP_P3 4.1665795894E-2f
+#define EXP_P4 1.6666665459E-1f
+#define EXP_P5 5.0000001201E-1f
+
+// FUNCTION TO WRITE AN ACCUMULATED TILE BACK TO C (EDGE TILES AND SCALAR PATH)
+static void store_tile(const float *tile, int ld_tile, float *C, int ldc,
+                       int mr, int nr, float alpha, float beta) {
+    for (int r = 0; r < mr; r++) {
+        float *c_row = C + (size_t)r * ldc;
+        const float *t_row = tile + r * ld_tile;
+        if (beta == 0.0f) {
+            for (int j = 0; j < nr; j++) c_row[j] = alpha * t_row[j];
+        } else {
+            for (int j = 0; j < nr; j++) c_row[j] = alpha * t_row[j] + beta * c_row[j];
+        }
+    }
+}
+
+/////////////////////////////////// SCALAR ////////////////////////////////////
+
+static float dot_scalar(const float *a, const float *b, int n) {
+    float result = 0.0f;
+    for (int i = 0; i < n; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+static void axpy_scalar(int n, float alpha, const float *x, float *y) {
+    for (int i = 0; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+static void scale_scalar(int n, float alpha, float *x) {
+    for (int i = 0; i < n; i++) {
+        x[i] *= alpha;
+    }
+}
+
+static float row_max_scalar(const float *x, int n) {
+    float max_val = x[0];
+    for (int i = 1; i < n; i++) {
+        if (x[i] > max_val) max_val = x[i];
+    }
+    return max_val;
+}
+
+static void vexp_scalar(const float *x, float shift, float *y, int n) {
+    for (int i = 0; i < n; i++) {
+        y[i] = expf(x[i] - shift);
+    }
+}
+
+static float row_sum_scalar(const float *x, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += x[i];
+    }
+    return sum;
+}
+
+#define SCALAR_MR 6
+#define SCALAR_NR 16
+
+static void ukernel_scalar(int kc, const float *a, const float *b, float *C, int ldc,
+                           int mr, int nr, float alpha, float beta) {
+    float acc[SCALAR_MR][SCALAR_NR] = {{0.0f}};
+
+    for (int k = 0; k < kc; k++) {
+        for (int r = 0; r < SCALAR_MR; r++) {
+            const float a_r = a[r];
+            for (int j = 0; j < SCALAR_NR; j++) {
+                acc[r][j] += a_r * b[j];
+            }
+        }
+        a += SCALAR_MR;
+        b += SCALAR_NR;
+    }
+
+    store_tile(&acc[0][0], SCALAR_NR, C, ldc, mr, nr, alpha, beta);
+}
+
+static const KernelTable scalar_table = {
+    KERNEL_ISA_SCALAR, "scalar", SCALAR_MR, SCALAR_NR,
+    dot_scalar, axpy_scalar, scale_scalar, row_max_scalar, vexp_scalar, row_sum_scalar,
+    ukernel_scalar
+};
+
+#ifdef KERNELS_X86
+
+//////////////////////////////////// SSE4 /////////////////////////////////////
+
+__attribute__((target("sse4.1")))
+static float hsum_sse(__m128 v) {
+    __m128 shuf = _mm_movehdup_ps(v);
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target("sse4.1")))
+static float hmax_sse(__m128 v) {
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("sse4.1")))
+static __m128 exp_sse(__m128 x) {
+    __m128 underflow = _mm_cmplt_ps(x, _mm_set1_ps(EXP_LO));
+    x = _mm_min_ps(x, _mm_set1_ps(EXP_HI));
+    x = _mm_max_ps(x, _mm_set1_ps(EXP_LO));
+
+    __m128 n = _mm_round_ps(_mm_mul_ps(x, _mm_set1_ps(EXP_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(EXP_LN2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(EXP_LN2_LO)));
+
+    __m128 p = _mm_set1_ps(EXP_P0);
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P5));
+    p = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), _mm_add_ps(r, _mm_set1_ps(1.0f)));
+
+    __m128i e = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23);
+    p = _mm_mul_ps(p, _mm_castsi128_ps(e));
+    return _mm_andnot_ps(underflow, p);
+}
+
+__attribute__((target("sse4.1")))
+static float dot_sse4(const float *a, const float *b, int n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float result = hsum_sse(_mm_add_ps(acc0, acc1));
+    for (; i < n; i++) result += a[i] * b[i];
+    return result;
+}
+
+__attribute__((target("sse4.1")))
+static void axpy_sse4(int n, float alpha, const float *x, float *y) {
+    __m128 va = _mm_set1_ps(alpha);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(va, _mm_loadu_ps(x + i))));
+    }
+    for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+__attribute__((target("sse4.1")))
+static void scale_sse4(int n, float alpha, float *x) {
+    __m128 va = _mm_set1_ps(alpha);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(x + i, _mm_mul_ps(va, _mm_loadu_ps(x + i)));
+    }
+    for (; i < n; i++) x[i] *= alpha;
+}
+
+__attribute__((target("sse4.1")))
+static float row_max_sse4(const float *x, int n) {
+    if (n < 4) return row_max_scalar(x, n);
+    __m128 vmax = _mm_loadu_ps(x);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) vmax = _mm_max_ps(vmax, _mm_loadu_ps(x + i));
+    float max_val = hmax_sse(vmax);
+    for (; i < n; i++) if (x[i] > max_val) max_val = x[i];
+    return max_val;
+}
+
+__attribute__((target("sse4.1")))
+static void vexp_sse4(const float *x, float shift, float *y, int n) {
+    __m128 vs = _mm_set1_ps(shift);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(y + i, exp_sse(_mm_sub_ps(_mm_loadu_ps(x + i), vs)));
+    }
+    for (; i < n; i++) y[i] = expf(x[i] - shift);
+}
+
+__attribute__((target("sse4.1")))
+static float row_sum_sse4(const float *x, int n) {
+    __m128 acc = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) acc = _mm_add_ps(acc, _mm_loadu_ps(x + i));
+    float sum = hsum_sse(acc);
+    for (; i < n; i++) sum += x[i];
+    return sum;
+}
+
+#define SSE4_MR 4
+#define SSE4_NR 8
+
+__attribute__((target("sse4.1")))
+static void ukernel_sse4(int kc, const float *a, const float *b, float *C, int ldc,
+                         int mr, int nr, float alpha, float beta) {
+    __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+    __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+    __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+    __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+
+    for (int k = 0; k < kc; k++) {
+        __m128 b0 = _mm_load_ps(b);
+        __m128 b1 = _mm_load_ps(b + 4);
+        __m128 a0 = _mm_load1_ps(a + 0);
+        c00 = _mm_add_ps(c00, _mm_mul_ps(a0, b0)); c01 = _mm_add_ps(c01, _mm_mul_ps(a0, b1));
+        __m128 a1 = _mm_load1_ps(a + 1);
+        c10 = _mm_add_ps(c10, _mm_mul_ps(a1, b0)); c11 = _mm_add_ps(c11, _mm_mul_ps(a1, b1));
+        __m128 a2 = _mm_load1_ps(a + 2);
+        c20 = _mm_add_ps(c20, _mm_mul_ps(a2, b0)); c21 = _mm_add_ps(c21, _mm_mul_ps(a2, b1));
+        __m128 a3 = _mm_load1_ps(a + 3);
+        c30 = _mm_add_ps(c30, _mm_mul_ps(a3, b0)); c31 = _mm_add_ps(c31, _mm_mul_ps(a3, b1));
+        a += SSE4_MR;
+        b += SSE4_NR;
+    }
+
+    float tile[SSE4_MR * SSE4_NR];
+    _mm_storeu_ps(tile + 0, c00);  _mm_storeu_ps(tile + 4, c01);
+    _mm_storeu_ps(tile + 8, c10);  _mm_storeu_ps(tile + 12, c11);
+    _mm_storeu_ps(tile + 16, c20); _mm_storeu_ps(tile + 20, c21);
+    _mm_storeu_ps(tile + 24, c30); _mm_storeu_ps(tile + 28, c31);
+    store_tile(tile, SSE4_NR, C, ldc, mr, nr, alpha, beta);
+}
+
+static const KernelTable sse4_table = {
+    KERNEL_ISA_SSE4, "sse4", SSE4_MR, SSE4_NR,
+    dot_sse4, axpy_sse4, scale_sse4, row_max_sse4, vexp_sse4, row_sum_sse4,
+    ukernel_sse4
+};
+
+/////////////////////////////////// AVX2 //////////////////////////////////////
+
+__attribute__((target("avx2,fma")))
+static float hsum_avx(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    __m128 shuf = _mm_movehdup_ps(lo);
+    __m128 sums = _mm_add_ps(lo, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target("avx2,fma")))
+static float hmax_avx(__m256 v) {
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(m);
+}
+
+__attribute__((target("avx2,fma")))
+static __m256 exp_avx2(__m256 x) {
+    __m256 underflow = _mm256_cmp_ps(x, _mm256_set1_ps(EXP_LO), _CMP_LT_OQ);
+    x = _mm256_min_ps(x, _mm256_set1_ps(EXP_HI));
+    x = _mm256_max_ps(x, _mm256_set1_ps(EXP_LO));
+
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(EXP_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_HI), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_LO), r);
+
+    __m256 p = _mm256_set1_ps(EXP_P0);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P5));
+    p = _mm256_fmadd_ps(_mm256_mul_ps(p, r), r, _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+    __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    p = _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+    return _mm256_andnot_ps(underflow, p);
+}
+
+__attribute__((target("avx2,fma")))
+static float dot_avx2(const float *a, const float *b, int n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    float result = hsum_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < n; i++) result += a[i] * b[i];
+    return result;
+}
+
+__attribute__((target("avx2,fma")))
+static void axpy_avx2(int n, float alpha, const float *x, float *y) {
+    __m256 va = _mm256_set1_ps(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void scale_avx2(int n, float alpha, float *x) {
+    __m256 va = _mm256_set1_ps(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(va, _mm256_loadu_ps(x + i)));
+    }
+    for (; i < n; i++) x[i] *= alpha;
+}
+
+__attribute__((target("avx2,fma")))
+static float row_max_avx2(const float *x, int n) {
+    if (n < 8) return row_max_scalar(x, n);
+    __m256 vmax = _mm256_loadu_ps(x);
+    int i = 8;
+    for (; i + 8 <= n; i += 8) vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(x + i));
+    float max_val = hmax_avx(vmax);
+    for (; i < n; i++) if (x[i] > max_val) max_val = x[i];
+    return max_val;
+}
+
+__attribute__((target("avx2,fma")))
+static void vexp_avx2(const float *x, float shift, float *y, int n) {
+    __m256 vs = _mm256_set1_ps(shift);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, exp_avx2(_mm256_sub_ps(_mm256_loadu_ps(x + i), vs)));
+    }
+    for (; i < n; i++) y[i] = expf(x[i] - shift);
+}
+
+__attribute__((target("avx2,fma")))
+static float row_sum_avx2(const float *x, int n) {
+    __m256 acc = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) acc = _mm256_add_ps(acc, _mm256_loadu_ps(x + i));
+    float sum = hsum_avx(acc);
+    for (; i < n; i++) sum += x[i];
+    return sum;
+}
+
+#define AVX2_MR 6
+#define AVX2_NR 16
+
+// One row of the 6x16 AVX2 tile: broadcast a[r] and FMA it against both halves of b
+#define AVX2_ROW(r) \
+    { __m256 ar = _mm256_broadcast_ss(a + r); \
+      c##r##0 = _mm256_fmadd_ps(ar, b0, c##r##0); \
+      c##r##1 = _mm256_fmadd_ps(ar, b1, c##r##1); }
+
+// Store one row of the tile as alpha * acc (+ beta * C)
+#define AVX2_STORE(r) \
+    { float *c_row = C + (size_t)r * ldc; \
+      __m256 v0 = _mm256_mul_ps(va, c##r##0), v1 = _mm256_mul_ps(va, c##r##1); \
+      if (beta != 0.0f) { \
+          v0 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(c_row), v0); \
+          v1 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(c_row + 8), v1); \
+      } \
+      _mm256_storeu_ps(c_row, v0); _mm256_storeu_ps(c_row + 8, v1); }
+
+__attribute__((target("avx2,fma")))
+static void ukernel_avx2(int kc, const float *a, const float *b, float *C, int ldc,
+                         int mr, int nr, float alpha, float beta) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (int k = 0; k < kc; k++) {
+        __m256 b0 = _mm256_load_ps(b);
+        __m256 b1 = _mm256_load_ps(b + 8);
+        AVX2_ROW(0) AVX2_ROW(1) AVX2_ROW(2) AVX2_ROW(3) AVX2_ROW(4) AVX2_ROW(5)
+        a += AVX2_MR;
+        b += AVX2_NR;
+    }
+
+    if (mr == AVX2_MR && nr == AVX2_NR) {
+        __m256 va = _mm256_set1_ps(alpha);
+        __m256 vb = _mm256_set1_ps(beta);
+        AVX2_STORE(0) AVX2_STORE(1) AVX2_STORE(2) AVX2_STORE(3) AVX2_STORE(4) AVX2_STORE(5)
+        return;
+    }
+
+    float tile[AVX2_MR * AVX2_NR];
+    _mm256_storeu_ps(tile + 0, c00);  _mm256_storeu_ps(tile + 8, c01);
+    _mm256_storeu_ps(tile + 16, c10); _mm256_storeu_ps(tile + 24, c11);
+    _mm256_storeu_ps(tile + 32, c20); _mm256_storeu_ps(tile + 40, c21);
+    _mm256_storeu_ps(tile + 48, c30); _mm256_storeu_ps(tile + 56, c31);
+    _mm256_storeu_ps(tile + 64, c40); _mm256_storeu_ps(tile + 72, c41);
+    _mm256_storeu_ps(tile + 80, c50); _mm256_storeu_ps(tile + 88, c51);
+    store_tile(tile, AVX2_NR, C, ldc, mr, nr, alpha, beta);
+}
+
+static const KernelTable avx2_table = {
+    KERNEL_ISA_AVX2, "avx2", AVX2_MR, AVX2_NR,
+    dot_avx2, axpy_avx2, scale_avx2, row_max_avx2, vexp_avx2, row_sum_avx2,
+    ukernel_avx2
+};
+
+////////////////////////////////// AVX-512 ////////////////////////////////////
+
+__attribute__((target("avx512f")))
+static __m512 exp_avx512(__m512 x) {
+    __mmask16 underflow = _mm512_cmp_ps_mask(x, _mm512_set1_ps(EXP_LO), _CMP_LT_OQ);
+    x = _mm512_min_ps(x, _mm512_set1_ps(EXP_HI));
+    x = _mm512_max_ps(x, _mm512_set1_ps(EXP_LO));
+
+    __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(EXP_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_HI), x);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_LO), r);
+
+    __m512 p = _mm512_set1_ps(EXP_P0);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P1));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P2));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P3));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P4));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P5));
+    p = _mm512_fmadd_ps(_mm512_mul_ps(p, r), r, _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+
+    __m512i e = _mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23);
+    p = _mm512_mul_ps(p, _mm512_castsi512_ps(e));
+    return _mm512_maskz_mov_ps((__mmask16)~underflow, p);
+}
+
+__attribute__((target("avx512f")))
+static float dot_avx512(const float *a, const float *b, int n) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    if (i < n) {
+        // Masked load covers the tail in at most two steps
+        for (; i < n; i += 16) {
+            __mmask16 m = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+            acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i), acc0);
+        }
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx512f")))
+static void axpy_avx512(int n, float alpha, const float *x, float *y) {
+    __m512 va = _mm512_set1_ps(alpha);
+    for (int i = 0; i < n; i += 16) {
+        __mmask16 m = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        __m512 vy = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(m, x + i), _mm512_maskz_loadu_ps(m, y + i));
+        _mm512_mask_storeu_ps(y + i, m, vy);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void scale_avx512(int n, float alpha, float *x) {
+    __m512 va = _mm512_set1_ps(alpha);
+    for (int i = 0; i < n; i += 16) {
+        __mmask16 m = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(x + i, m, _mm512_mul_ps(va, _mm512_maskz_loadu_ps(m, x + i)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static float row_max_avx512(const float *x, int n) {
+    if (n < 16) return row_max_scalar(x, n);
+    __m512 vmax = _mm512_loadu_ps(x);
+    int i = 16;
+    for (; i + 16 <= n; i += 16) vmax = _mm512_max_ps(vmax, _mm512_loadu_ps(x + i));
+    float max_val = _mm512_reduce_max_ps(vmax);
+    for (; i < n; i++) if (x[i] > max_val) max_val = x[i];
+    return max_val;
+}
+
+__attribute__((target("avx512f")))
+static void vexp_avx512(const float *x, float shift, float *y, int n) {
+    __m512 vs = _mm512_set1_ps(shift);
+    for (int i = 0; i < n; i += 16) {
+        __mmask16 m = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        __m512 v = exp_avx512(_mm512_sub_ps(_mm512_maskz_loadu_ps(m, x + i), vs));
+        _mm512_mask_storeu_ps(y + i, m, v);
+    }
+}
+
+__attribute__((target("avx512f")))
+static float row_sum_avx512(const float *x, int n) {
+    __m512 acc = _mm512_setzero_ps();
+    for (int i = 0; i < n; i += 16) {
+        __mmask16 m = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        acc = _mm512_add_ps(acc, _mm512_maskz_loadu_ps(m, x + i));
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+#define AVX512_MR 6
+#define AVX512_NR 32
+
+#define AVX512_ROW(r) \
+    { __m512 ar = _mm512_set1_ps(a[r]); \
+      c##r##0 = _mm512_fmadd_ps(ar, b0, c##r##0); \
+      c##r##1 = _mm512_fmadd_ps(ar, b1, c##r##1); }
+
+// Masked store of one row: only the first nr columns are touched
+#define AVX512_STORE(r) \
+    if (r < mr) { float *c_row = C + (size_t)r * ldc; \
+      __m512 v0 = _mm512_mul_ps(va, c##r##0), v1 = _mm512_mul_ps(va, c##r##1); \
+      if (beta != 0.0f) { \
+          v0 = _mm512_fmadd_ps(vb, _mm512_maskz_loadu_ps(m0, c_row), v0); \
+          v1 = _mm512_fmadd_ps(vb, _mm512_maskz_loadu_ps(m1, c_row + 16), v1); \
+      } \
+      _mm512_mask_storeu_ps(c_row, m0, v0); _mm512_mask_storeu_ps(c_row + 16, m1, v1); }
+
+__attribute__((target("avx512f")))
+static void ukernel_avx512(int kc, const float *a, const float *b, float *C, int ldc,
+                           int mr, int nr, float alpha, float beta) {
+    __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+    __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+    __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+    __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+    __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+    __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+
+    for (int k = 0; k < kc; k++) {
+        __m512 b0 = _mm512_load_ps(b);
+        __m512 b1 = _mm512_load_ps(b + 16);
+        AVX512_ROW(0) AVX512_ROW(1) AVX512_ROW(2) AVX512_ROW(3) AVX512_ROW(4) AVX512_ROW(5)
+        a += AVX512_MR;
+        b += AVX512_NR;
+    }
+
+    __mmask16 m0 = nr >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << nr) - 1);
+    __mmask16 m1 = nr >= 32 ? (__mmask16)0xFFFF : (nr <= 16 ? (__mmask16)0 : (__mmask16)((1u << (nr - 16)) - 1));
+    __m512 va = _mm512_set1_ps(alpha);
+    __m512 vb = _mm512_set1_ps(beta);
+    AVX512_STORE(0) AVX512_STORE(1) AVX512_STORE(2) AVX512_STORE(3) AVX512_STORE(4) AVX512_STORE(5)
+}
+
+static const KernelTable avx512_table = {
+    KERNEL_ISA_AVX512, "avx512", AVX512_MR, AVX512_NR,
+    dot_avx512, axpy_avx512, scale_avx512, row_max_avx512, vexp_avx512, row_sum_avx512,
+    ukernel_avx512
+};
+
+#endif // KERNELS_X86
+
+#ifdef KERNELS_NEON
+
+/////////////////////////////////// NEON //////////////////////////////////////
+
+static float32x4_t exp_neon(float32x4_t x) {
+    uint32x4_t underflow = vcltq_f32(x, vdupq_n_f32(EXP_LO));
+    x = vminq_f32(x, vdupq_n_f32(EXP_HI));
+    x = vmaxq_f32(x, vdupq_n_f32(EXP_LO));
+
+    float32x4_t n = vrndnq_f32(vmulq_n_f32(x, EXP_LOG2E));
+    float32x4_t r = vfmsq_f32(x, n, vdupq_n_f32(EXP_LN2_HI));
+    r = vfmsq_f32(r, n, vdupq_n_f32(EXP_LN2_LO));
+
+    float32x4_t p = vdupq_n_f32(EXP_P0);
+    p = vfmaq_f32(vdupq_n_f32(EXP_P1), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_P2), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_P3), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_P4), p, r);
+    p = vfmaq_f32(vdupq_n_f32(EXP_P5), p, r);
+    p = vfmaq_f32(vaddq_f32(r, vdupq_n_f32(1.0f)), vmulq_f32(p, r), r);
+
+    int32x4_t e = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+    p = vmulq_f32(p, vreinterpretq_f32_s32(e));
+    return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(p), underflow));
+}
+
+static float dot_neon(const float *a, const float *b, int n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float result = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; i++) result += a[i] * b[i];
+    return result;
+}
+
+static void axpy_neon(int n, float alpha, const float *x, float *y) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(y + i, vfmaq_n_f32(vld1q_f32(y + i), vld1q_f32(x + i), alpha));
+    }
+    for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+static void scale_neon(int n, float alpha, float *x) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(x + i, vmulq_n_f32(vld1q_f32(x + i), alpha));
+    }
+    for (; i < n; i++) x[i] *= alpha;
+}
+
+static float row_max_neon(const float *x, int n) {
+    if (n < 4) return row_max_scalar(x, n);
+    float32x4_t vmax = vld1q_f32(x);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) vmax = vmaxq_f32(vmax, vld1q_f32(x + i));
+    float max_val = vmaxvq_f32(vmax);
+    for (; i < n; i++) if (x[i] > max_val) max_val = x[i];
+    return max_val;
+}
+
+static void vexp_neon(const float *x, float shift, float *y, int n) {
+    float32x4_t vs = vdupq_n_f32(shift);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(y + i, exp_neon(vsubq_f32(vld1q_f32(x + i), vs)));
+    }
+    for (; i < n; i++) y[i] = expf(x[i] - shift);
+}
+
+static float row_sum_neon(const float *x, int n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) acc = vaddq_f32(acc, vld1q_f32(x + i));
+    float sum = vaddvq_f32(acc);
+    for (; i < n; i++) sum += x[i];
+    return sum;
+}
+
+#define NEON_MR 6
+#define NEON_NR 8
+
+#define NEON_ROW(r) \
+    { c##r##0 = vfmaq_n_f32(c##r##0, b0, a[r]); \
+      c##r##1 = vfmaq_n_f32(c##r##1, b1, a[r]); }
+
+static void ukernel_neon(int kc, const float *a, const float *b, float *C, int ldc,
+                         int mr, int nr, float alpha, float beta) {
+    float32x4_t c00 = vdupq_n_f32(0.0f), c01 = vdupq_n_f32(0.0f);
+    float32x4_t c10 = vdupq_n_f32(0.0f), c11 = vdupq_n_f32(0.0f);
+    float32x4_t c20 = vdupq_n_f32(0.0f), c21 = vdupq_n_f32(0.0f);
+    float32x4_t c30 = vdupq_n_f32(0.0f), c31 = vdupq_n_f32(0.0f);
+    float32x4_t c40 = vdupq_n_f32(0.0f), c41 = vdupq_n_f32(0.0f);
+    float32x4_t c50 = vdupq_n_f32(0.0f), c51 = vdupq_n_f32(0.0f);
+
+    for (int k = 0; k < kc; k++) {
+        float32x4_t b0 = vld1q_f32(b);
+        float32x4_t b1 = vld1q_f32(b + 4);
+        NEON_ROW(0) NEON_ROW(1) NEON_ROW(2) NEON_ROW(3) NEON_ROW(4) NEON_ROW(5)
+        a += NEON_MR;
+        b += NEON_NR;
+    }
+
+    float tile[NEON_MR * NEON_NR];
+    vst1q_f32(tile + 0, c00);  vst1q_f32(tile + 4, c01);
+    vst1q_f32(tile + 8, c10);  vst1q_f32(tile + 12, c11);
+    vst1q_f32(tile + 16, c20); vst1q_f32(tile + 20, c21);
+    vst1q_f32(tile + 24, c30); vst1q_f32(tile + 28, c31);
+    vst1q_f32(tile + 32, c40); vst1q_f32(tile + 36, c41);
+    vst1q_f32(tile + 40, c50); vst1q_f32(tile + 44, c51);
+    store_tile(tile, NEON_NR, C, ldc, mr, nr, alpha, beta);
+}
+
+static const KernelTable neon_table = {
+    KERNEL_ISA_NEON, "neon", NEON_MR, NEON_NR,
+    dot_neon, axpy_neon, scale_neon, row_max_neon, vexp_neon, row_sum_neon,
+    ukernel_neon
+};
+
+#endif // KERNELS_NEON
+
+///////////////////////////////// DISPATCH ////////////////////////////////////
+
+static const KernelTable* active_table = NULL;
+
+static const KernelTable* table_for_isa(KernelIsa isa) {
+    switch (isa) {
+        case KERNEL_ISA_SCALAR: return &scalar_table;
+#ifdef KERNELS_X86
+        case KERNEL_ISA_SSE4:   return &sse4_table;
+        case KERNEL_ISA_AVX2:   return &avx2_table;
+        case KERNEL_ISA_AVX512: return &avx512_table;
+#endif
+#ifdef KERNELS_NEON
+        case KERNEL_ISA_NEON:   return &neon_table;
+#endif
+        default:                return NULL;
+    }
+}
+
+// CHECK IF THE CPU CAN RUN THE GIVEN KERNEL TABLE
+int kernels_isa_supported(KernelIsa isa) {
+    if (table_for_isa(isa) == NULL) return 0;
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    switch (isa) {
+        case KERNEL_ISA_SSE4:   return __builtin_cpu_supports("sse4.1");
+        case KERNEL_ISA_AVX2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case KERNEL_ISA_AVX512: return __builtin_cpu_supports("avx512f");
+        default:                break;
+    }
+#endif
+    return 1;
+}
+
+// MAP AN ISA NAME TO ITS ENUM VALUE
+KernelIsa kernels_isa_from_name(const char* name) {
+    static const char* names[KERNEL_ISA_COUNT] = { "scalar", "sse4", "avx2", "avx512", "neon" };
+    if (name == NULL) return KERNEL_ISA_COUNT;
+    for (int i = 0; i < KERNEL_ISA_COUNT; i++) {
+        if (strcmp(name, names[i]) == 0) return (KernelIsa)i;
+    }
+    return KERNEL_ISA_COUNT;
+}
+
+// PICK THE WIDEST TABLE THE CPU SUPPORTS, HONOURING TRANSFORMER_ISA
+static const KernelTable* select_kernels(void) {
+    const char* forced = getenv("TRANSFORMER_ISA");
+    if (forced != NULL) {
+        KernelIsa isa = kernels_isa_from_name(forced);
+        if (isa != KERNEL_ISA_COUNT && kernels_isa_supported(isa)) {
+            return table_for_isa(isa);
+        }
+        fprintf(stderr, "TRANSFORMER_ISA=%s is not available, using auto-detection\n", forced);
+    }
+
+    static const KernelIsa preference[] = {
+        KERNEL_ISA_AVX512, KERNEL_ISA_AVX2, KERNEL_ISA_NEON, KERNEL_ISA_SSE4
+    };
+    for (size_t i = 0; i < sizeof(preference) / sizeof(preference[0]); i++) {
+        if (kernels_isa_supported(preference[i])) {
+            return table_for_isa(preference[i]);
+        }
+    }
+    return &scalar_table;
+}
+
+// GET THE ACTIVE KERNEL TABLE (SELECTED ON FIRST USE)
+const KernelTable* kernels(void) {
+    const KernelTable* table = __atomic_load_n(&active_table, __ATOMIC_ACQUIRE);
+    if (table == NULL) {
+        table = select_kernels();
+        __atomic_store_n(&active_table, table, __ATOMIC_RELEASE);
+    }
+    return table;
+}
+
+// FORCE A SPECIFIC KERNEL TABLE
+int kernels_force_isa(KernelIsa isa) {
+    if (!kernels_isa_supported(isa)) return 0;
+    __atomic_store_n(&active_table, table_for_isa(isa), __ATOMIC_RELEASE);
+    return 1;
+}
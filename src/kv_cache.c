@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/kv_cache.h"
+
+// FUNCTION TO CREATE A KEY/VALUE CACHE
+KVCache* create_kv_cache(int num_heads, int head_dim, int capacity) {
+    if (num_heads <= 0 || head_dim <= 0 || capacity <= 0) return NULL;
+
+    KVCache* cache = (KVCache*)calloc(1, sizeof(KVCache));
+    if (cache == NULL) return NULL;
+
+    cache->num_heads = num_heads;
+    cache->head_dim = head_dim;
+    cache->capacity = capacity;
+
+    size_t size = (size_t)num_heads * capacity * head_dim;
+    cache->K = (float*)aligned_alloc(64, ((size * sizeof(float) + 63) / 64) * 64);
+    cache->V = (float*)aligned_alloc(64, ((size * sizeof(float) + 63) / 64) * 64);
+
+    if (cache->K == NULL || cache->V == NULL) {
+        fprintf(stderr, "create_kv_cache: failed to allocate %zu bytes\n", 2 * size * sizeof(float));
+        free_kv_cache(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+// FUNCTION TO FREE A KEY/VALUE CACHE
+void free_kv_cache(KVCache* cache) {
+    if (cache == NULL) return;
+
+    free(cache->K);
+    free(cache->V);
+    free(cache);
+}
+
+// FUNCTION TO RESET A KEY/VALUE CACHE
+void kv_cache_reset(KVCache* cache) {
+    if (cache == NULL) return;
+
+    cache->length = 0;
+    cache->next = 0;
+    cache->position = 0;
+}
+
+// FUNCTION TO APPEND ONE TOKEN TO THE CACHE
+int kv_cache_append(KVCache* cache, const float* key, const float* value) {
+    const int hd = cache->head_dim;
+    const int slot = cache->next;
+
+    // Scatter the token-major row into each head's slab
+    for (int h = 0; h < cache->num_heads; h++) {
+        size_t row = ((size_t)h * cache->capacity + slot) * hd;
+        memcpy(cache->K + row, key + (size_t)h * hd, hd * sizeof(float));
+        memcpy(cache->V + row, value + (size_t)h * hd, hd * sizeof(float));
+    }
+
+    cache->next = (slot + 1 == cache->capacity) ? 0 : slot + 1;
+    if (cache->length < cache->capacity) cache->length++;
+    cache->position++;
+    return slot;
+}
+
+// FUNCTION TO GET THE CACHED KEYS OF ONE HEAD
+float* kv_cache_keys(const KVCache* cache, int head) {
+    return cache->K + (size_t)head * cache->capacity * cache->head_dim;
+}
+
+// FUNCTION TO GET THE CACHED VALUES OF ONE HEAD
+float* kv_cache_values(const KVCache* cache, int head) {
+    return cache->V + (size_t)head * cache->capacity * cache->head_dim;
+}
@@ -1,10 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include <assert.h>
 
 #include "../include/self_attention_layer.h"
 #include "../include/utils.h"
+#include "../include/gemm.h"
+#include "../include/attention.h"
 
 // Model hyperparameters
 #define VOCAB_SIZE 1000        // Size of the vocabulary
@@ -13,39 +16,18 @@
 #define EPSILON 1e-6          // Small value for numerical stability
 #define FF_DIM 2048          // Feed-forward network dimension
 
+// ATTENTION WORK (QUERIES x CACHED POSITIONS x EMBEDDING_DIM) BELOW WHICH
+// A CACHED ATTENTION CALL STAYS ON THE CALLING THREAD
+#define DECODE_PARALLEL_WORK (64 * 1024)
+
 // FUNCTION TO COMPUTE THE DOT PRODUCT OF TWO VECTORS
 float dot_product(float *a, float *b, int dim){
-    assert(a != NULL && b != NULL && dim > 0);
-    float result = 0.0f;
-    for(int i = 0; i < dim; i++){
-        result += a[i] * b[i];
-    }
-    return result;
+    return dot_product_float(a, b, dim);
 }
 
 // FUNCTION TO APPLY SOFTMAX TO A VECTOR OF SCORES
 void softmax(float *input, float *output, int length){
-    assert(input != NULL && output != NULL && length > 0);
-    
-    // Find maximum value for numerical stability
-    float max_val = input[0];
-    for(int i = 1; i < length; i++){
-        if(input[i] > max_val){
-            max_val = input[i];
-        }
-    }
-
-    // Compute exponentials and sum
-    float sum = 0.0f;
-    for(int i = 0; i < length; i++){
-        output[i] = exp(input[i] - max_val);
-        sum += output[i];
-    }
-
-    // Normalize to get probabilities
-    for(int i = 0; i < length; i++){
-        output[i] /= sum;
-    }
+    softmax_float(input, output, length);
 }
 
 // FUNCTION TO INITIALIZE THE TOKEN EMBEDDING MATRIX
@@ -118,14 +100,8 @@ void concatenate_embeddings(float token_embedding[EMBEDDING_DIM], float position
 
 // FUNCTION TO MULTIPLY TWO MATRICES
 void matrix_multiply(float A[MAX_SEQ_LENGTH][EMBEDDING_DIM], float B[EMBEDDING_DIM][EMBEDDING_DIM], float C[MAX_SEQ_LENGTH][EMBEDDING_DIM], int rows_A, int cols_A, int cols_B){
-    for(int i = 0; i < rows_A; i++){
-        for(int j = 0; j < cols_B; j++){
-            C[i][j] = 0.0f;
-            for (int k = 0; k < cols_A; k++) {
-                C[i][j] += A[i][k] * B[k][j];
-            }
-        }
-    }
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, rows_A, cols_B, cols_A,
+             1.0f, &A[0][0], EMBEDDING_DIM, &B[0][0], EMBEDDING_DIM, 0.0f, &C[0][0], EMBEDDING_DIM);
 }
 
 // FUNCTION TO INITIALIZE A WEIGHT MATRIX
@@ -137,126 +113,501 @@ void initialize_weight_matrix(float weight[EMBEDDING_DIM][EMBEDDING_DIM]) {
     }
 }
 
-// FUNCTION TO COMPUTE SELF-ATTENTION WITH TRAINABLE K, Q, V
-void self_attention(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length) {
-    float W_Q[EMBEDDING_DIM][EMBEDDING_DIM]; // Weight matrix for Q
-    float W_K[EMBEDDING_DIM][EMBEDDING_DIM]; // Weight matrix for K
-    float W_V[EMBEDDING_DIM][EMBEDDING_DIM]; // Weight matrix for V
-
-    // Initialize weight matrices
-    initialize_weight_matrix(W_Q);
-    initialize_weight_matrix(W_K);
-    initialize_weight_matrix(W_V);
-
-    float Q[MAX_SEQ_LENGTH][EMBEDDING_DIM]; // Query matrix
-    float K[MAX_SEQ_LENGTH][EMBEDDING_DIM]; // Key matrix
-    float V[MAX_SEQ_LENGTH][EMBEDDING_DIM]; // Value matrix
-
-    // Compute Q, K, V by multiplying input with the weight matrices
-    matrix_multiply_float((float*)input, (float*)W_Q, (float*)Q, seq_length, EMBEDDING_DIM, EMBEDDING_DIM);
-    matrix_multiply_float((float*)input, (float*)W_K, (float*)K, seq_length, EMBEDDING_DIM, EMBEDDING_DIM);
-    matrix_multiply_float((float*)input, (float*)W_V, (float*)V, seq_length, EMBEDDING_DIM, EMBEDDING_DIM);
-
-    float attention_scores[MAX_SEQ_LENGTH][MAX_SEQ_LENGTH] = {0};
-    float attention_weights[MAX_SEQ_LENGTH][MAX_SEQ_LENGTH] = {0};
-
-    // Compute attention scores
-    for(int i = 0; i < seq_length; i++) {
-        for (int j = 0; j < seq_length; j++) {
-            attention_scores[i][j] = dot_product_float(Q[i], K[j], EMBEDDING_DIM) / sqrt(EMBEDDING_DIM);
+// FUNCTION TO CREATE A SELF-ATTENTION LAYER
+SelfAttentionLayer* create_self_attention_layer(int embedding_dim, int max_seq_length) {
+    return create_multi_head_attention_layer(embedding_dim, 1, max_seq_length);
+}
+
+// FUNCTION TO CREATE A MULTI-HEAD ATTENTION LAYER
+SelfAttentionLayer* create_multi_head_attention_layer(int embedding_dim, int num_heads, int max_seq_length) {
+    if (embedding_dim <= 0 || num_heads <= 0 || max_seq_length <= 0) return NULL;
+    if (embedding_dim % num_heads != 0) {
+        fprintf(stderr, "create_multi_head_attention_layer: %d heads do not divide embedding dimension %d\n",
+                num_heads, embedding_dim);
+        return NULL;
+    }
+
+    SelfAttentionLayer* layer = (SelfAttentionLayer*)calloc(1, sizeof(SelfAttentionLayer));
+    if (layer == NULL) return NULL;
+
+    layer->embedding_dim = embedding_dim;
+    layer->num_heads = num_heads;
+    layer->head_dim = embedding_dim / num_heads;
+    layer->max_seq_length = max_seq_length;
+    layer->workspace_rows = max_seq_length;
+
+    size_t qkv_dim = (size_t)3 * embedding_dim;
+    size_t weight_size = (size_t)embedding_dim * qkv_dim;
+    size_t activation_size = (size_t)max_seq_length * embedding_dim;
+
+    // Allocate memory for the fused weights and the forward-pass workspace
+    layer->W_QKV = (float*)malloc(weight_size * sizeof(float));
+    layer->QKV = (float*)malloc(3 * activation_size * sizeof(float));
+    int ok = layer->W_QKV != NULL && layer->QKV != NULL;
+
+    if (num_heads > 1) {
+        layer->W_O = (float*)malloc((size_t)embedding_dim * embedding_dim * sizeof(float));
+        layer->heads = (float*)malloc(3 * activation_size * sizeof(float));
+        layer->context = (float*)malloc(activation_size * sizeof(float));
+        ok = ok && layer->W_O != NULL && layer->heads != NULL && layer->context != NULL;
+    }
+
+    if (!ok) {
+        free_self_attention_layer(layer);
+        return NULL;
+    }
+
+    layer->Q = layer->QKV;
+    layer->K = layer->QKV + embedding_dim;
+    layer->V = layer->QKV + 2 * embedding_dim;
+
+    // Initialize weights with random values between -0.5 and 0.5 (once, not per call)
+    for (size_t i = 0; i < weight_size; i++) {
+        layer->W_QKV[i] = ((float)rand() / (float)(RAND_MAX / 2)) - 0.5f;
+    }
+    if (layer->W_O != NULL) {
+        for (size_t i = 0; i < (size_t)embedding_dim * embedding_dim; i++) {
+            layer->W_O[i] = ((float)rand() / (float)(RAND_MAX / 2)) - 0.5f;
+        }
+    }
+
+    return layer;
+}
+
+// FUNCTION TO LOAD SEPARATE Q, K, V WEIGHTS INTO THE FUSED MATRIX
+void self_attention_set_weights(SelfAttentionLayer* layer, const float* W_Q, const float* W_K, const float* W_V) {
+    if (layer == NULL || W_Q == NULL || W_K == NULL || W_V == NULL) return;
+
+    const int d = layer->embedding_dim;
+    const float* weights[3] = { W_Q, W_K, W_V };
+    for (int i = 0; i < d; i++) {
+        float* row = layer->W_QKV + (size_t)i * 3 * d;
+        for (int w = 0; w < 3; w++) {
+            memcpy(row + (size_t)w * d, weights[w] + (size_t)i * d, d * sizeof(float));
         }
     }
+}
+
+// FUNCTION TO FREE A SELF-ATTENTION LAYER
+void free_self_attention_layer(SelfAttentionLayer* layer) {
+    if (layer == NULL) return;
 
-    // Compute attention weights using softmax
-    for(int i = 0; i < seq_length; i++) {
-        softmax_float(attention_scores[i], attention_weights[i], seq_length);
+    free(layer->W_QKV);
+    free(layer->W_O);
+    free(layer->QKV);
+    free(layer->heads);
+    free(layer->context);
+    free(layer);
+}
+
+// FUNCTION TO GROW THE ATTENTION WORKSPACE TO HOLD rows TOKENS
+// Only batched calls need more than max_seq_length rows; the buffers are grown
+// once and then reused, so steady-state forward passes do not allocate.
+static int ensure_attention_workspace(SelfAttentionLayer* layer, long rows) {
+    if (rows <= layer->workspace_rows) return 1;
+
+    const size_t activation_size = (size_t)rows * layer->embedding_dim;
+    float* qkv = (float*)realloc(layer->QKV, 3 * activation_size * sizeof(float));
+    if (qkv == NULL) goto fail;
+    layer->QKV = qkv;
+
+    if (layer->num_heads > 1) {
+        float* heads = (float*)realloc(layer->heads, 3 * activation_size * sizeof(float));
+        if (heads == NULL) goto fail;
+        layer->heads = heads;
+        float* context = (float*)realloc(layer->context, activation_size * sizeof(float));
+        if (context == NULL) goto fail;
+        layer->context = context;
     }
 
-    // Compute output of self-attention
-    for(int i = 0; i < seq_length; i++) {
-        for (int j = 0; j < EMBEDDING_DIM; j++) {
-            output[i][j] = 0.0f;
-            for(int k = 0; k < seq_length; k++) {
-                output[i][j] += attention_weights[i][k] * V[k][j];
+    layer->workspace_rows = rows;
+    layer->Q = layer->QKV;
+    layer->K = layer->QKV + layer->embedding_dim;
+    layer->V = layer->QKV + 2 * layer->embedding_dim;
+    return 1;
+
+fail:
+    // Buffers that were already grown stay valid; views must follow QKV
+    layer->Q = layer->QKV;
+    layer->K = layer->QKV + layer->embedding_dim;
+    layer->V = layer->QKV + 2 * layer->embedding_dim;
+    fprintf(stderr, "self_attention: failed to grow the workspace to %ld rows\n", rows);
+    return 0;
+}
+
+// FUNCTION TO RUN ATTENTION OVER n_seqs SEQUENCES STORED seq_stride ROWS APART
+// Every row of every sequence (padding included) is projected by one GEMM, as is
+// the output projection; attention itself only covers the first lengths[b] rows
+// of sequence b, and the padding rows of the output are zeroed.
+static void attention_rows(SelfAttentionLayer* layer, const float* input, float* output,
+                           int n_seqs, int seq_stride, const int* lengths) {
+    const int d = layer->embedding_dim;
+    const int ld_qkv = 3 * d;
+    const int num_heads = layer->num_heads;
+    const int hd = layer->head_dim;
+    const long rows = (long)n_seqs * seq_stride;
+    const float scale = 1.0f / sqrtf((float)hd);
+
+    if (!ensure_attention_workspace(layer, rows)) return;
+
+    // Compute Q, K, V in one pass over the input: [Q | K | V] = input * [W_Q | W_K | W_V]
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, (int)rows, ld_qkv, d,
+             1.0f, input, d, layer->W_QKV, ld_qkv, 0.0f, layer->QKV, ld_qkv);
+
+    // Without an output projection the heads write straight into the output
+    float* context = (num_heads > 1) ? layer->context : output;
+    const int tasks = n_seqs * num_heads;
+
+    // Each (sequence, head) task gathers its Q, K, V columns into contiguous
+    // head-major blocks and attends independently, so tasks run in parallel.
+    // A lone single-head sequence is left to split its query blocks instead.
+#ifdef _OPENMP
+    int workers = gemm_get_num_threads();
+    if (workers > tasks) workers = tasks;
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(workers) if(workers > 1)
+#endif
+    for (int t = 0; t < tasks; t++) {
+        const int b = t / num_heads;
+        const int h = t % num_heads;
+        const int len = lengths[b];
+        const size_t first_row = (size_t)b * seq_stride;
+        if (len <= 0) continue;
+
+        const float* qkv_head[3];
+        int ld_head = ld_qkv;
+        for (int w = 0; w < 3; w++) {
+            qkv_head[w] = layer->QKV + first_row * ld_qkv + (size_t)w * d + (size_t)h * hd;
+        }
+
+        if (num_heads > 1) {
+            ld_head = hd;
+            for (int w = 0; w < 3; w++) {
+                float* slab = layer->heads + (((size_t)w * n_seqs + b) * num_heads + h) * seq_stride * hd;
+                for (int i = 0; i < len; i++) {
+                    memcpy(slab + (size_t)i * hd, qkv_head[w] + (size_t)i * ld_qkv, hd * sizeof(float));
+                }
+                qkv_head[w] = slab;
             }
         }
+
+        // softmax(Q * K^T / sqrt(head_dim)) * V tile by tile, without storing the scores
+        flash_attention_f32(len, len, hd, scale,
+                            qkv_head[0], ld_head, qkv_head[1], ld_head, qkv_head[2], ld_head,
+                            context + first_row * d + (size_t)h * hd, d, 0);
+    }
+
+    if (num_heads > 1) {
+        // Mix the concatenated heads with the output projection
+        gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, (int)rows, d, d,
+                 1.0f, layer->context, d, layer->W_O, d, 0.0f, output, d);
+    }
+
+    for (int b = 0; b < n_seqs; b++) {
+        int len = lengths[b] > 0 ? lengths[b] : 0;
+        if (len < seq_stride) {
+            memset(output + ((size_t)b * seq_stride + len) * d, 0, (size_t)(seq_stride - len) * d * sizeof(float));
+        }
     }
 }
 
-void feed_forward(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length) {
-    // Allocate memory for weights and intermediate values
-    float (*W1)[FF_DIM] = malloc(sizeof(float[EMBEDDING_DIM][FF_DIM]));
-    float (*W2)[EMBEDDING_DIM] = malloc(sizeof(float[FF_DIM][EMBEDDING_DIM]));
-    float (*intermediate)[FF_DIM] = malloc(sizeof(float[MAX_SEQ_LENGTH][FF_DIM]));
-    
-    if (!W1 || !W2 || !intermediate) {
-        printf("Memory allocation failed in feed_forward\n");
-        if (W1) free(W1);
-        if (W2) free(W2);
-        if (intermediate) free(intermediate);
+// FUNCTION TO RUN THE SELF-ATTENTION FORWARD PASS
+void self_attention_forward(SelfAttentionLayer* layer, const float* input, float* output, int seq_length) {
+    if (layer == NULL || input == NULL || output == NULL) return;
+    if (seq_length <= 0 || seq_length > layer->max_seq_length) {
+        fprintf(stderr, "self_attention_forward: sequence length %d outside [1, %d]\n",
+                seq_length, layer->max_seq_length);
         return;
     }
-    
-    // Initialize weights
-    for(int i = 0; i < EMBEDDING_DIM; i++) {
-        for(int j = 0; j < FF_DIM; j++) {
-            W1[i][j] = ((float) rand() / (float)(RAND_MAX)) - 0.5;
+
+    attention_rows(layer, input, output, 1, seq_length, &seq_length);
+}
+
+// FUNCTION TO RUN THE SELF-ATTENTION FORWARD PASS OVER A BATCH
+void self_attention_forward_batch(SelfAttentionLayer* layer, const BatchTensor* input, BatchTensor* output) {
+    if (layer == NULL || input == NULL || output == NULL) return;
+    if (input->dim != layer->embedding_dim || output->dim != layer->embedding_dim ||
+        output->batch != input->batch || output->max_seq != input->max_seq) {
+        fprintf(stderr, "self_attention_forward_batch: tensor shapes do not match the layer\n");
+        return;
+    }
+    if (input->max_seq > layer->max_seq_length) {
+        fprintf(stderr, "self_attention_forward_batch: sequence length %d exceeds %d\n",
+                input->max_seq, layer->max_seq_length);
+        return;
+    }
+
+    batch_tensor_copy_lengths(output, input);
+    attention_rows(layer, input->data, output->data, input->batch, input->max_seq, input->lengths);
+}
+
+// FUNCTION TO CREATE A KEY/VALUE CACHE SHAPED FOR A LAYER
+KVCache* create_kv_cache_for_layer(const SelfAttentionLayer* layer, int capacity) {
+    if (layer == NULL) return NULL;
+    return create_kv_cache(layer->num_heads, layer->head_dim, capacity);
+}
+
+// FUNCTION TO ATTEND n_queries QUERY ROWS OVER EVERY HEAD OF THE CACHE
+// The queries are the last n_queries positions written to the cache. Heads
+// write their slice of context (row stride embedding_dim), then the output
+// projection is applied if the layer has one.
+static void attend_cached(SelfAttentionLayer* layer, const KVCache* cache, const float* queries, int ldq,
+                          int n_queries, float* output, int causal) {
+    const int d = layer->embedding_dim;
+    const int hd = layer->head_dim;
+    const int num_heads = layer->num_heads;
+    const float scale = 1.0f / sqrtf((float)hd);
+    float* context = (num_heads > 1) ? layer->context : output;
+
+#ifdef _OPENMP
+    int workers = gemm_get_num_threads();
+    if (workers > num_heads) workers = num_heads;
+    // A single short decode step is cheaper than waking the team
+    if ((long)n_queries * cache->length * d < DECODE_PARALLEL_WORK) workers = 1;
+    #pragma omp parallel for schedule(static) num_threads(workers) if(workers > 1)
+#endif
+    for (int h = 0; h < num_heads; h++) {
+        flash_attention_f32(n_queries, cache->length, hd, scale,
+                            queries + (size_t)h * hd, ldq,
+                            kv_cache_keys(cache, h), hd, kv_cache_values(cache, h), hd,
+                            context + (size_t)h * hd, d, causal);
+    }
+
+    if (num_heads > 1) {
+        gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, n_queries, d, d,
+                 1.0f, layer->context, d, layer->W_O, d, 0.0f, output, d);
+    }
+}
+
+// FUNCTION TO CHECK THAT A CACHE MATCHES A LAYER
+static int cache_matches_layer(const SelfAttentionLayer* layer, const KVCache* cache, const char* caller) {
+    if (cache->num_heads != layer->num_heads || cache->head_dim != layer->head_dim) {
+        fprintf(stderr, "%s: cache has %d heads of %d, layer has %d heads of %d\n", caller,
+                cache->num_heads, cache->head_dim, layer->num_heads, layer->head_dim);
+        return 0;
+    }
+    return 1;
+}
+
+// FUNCTION TO DECODE ONE TOKEN AGAINST THE CACHE
+void self_attention_decode_step(SelfAttentionLayer* layer, KVCache* cache, const float* token, float* output) {
+    if (layer == NULL || cache == NULL || token == NULL || output == NULL) return;
+    if (!cache_matches_layer(layer, cache, "self_attention_decode_step")) return;
+
+    const int d = layer->embedding_dim;
+    const int ld_qkv = 3 * d;
+
+    // Project only the new token, then make its key and value visible to itself
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, 1, ld_qkv, d,
+             1.0f, token, d, layer->W_QKV, ld_qkv, 0.0f, layer->QKV, ld_qkv);
+    kv_cache_append(cache, layer->K, layer->V);
+
+    // Every cached position is in the past, so no mask is needed
+    attend_cached(layer, cache, layer->Q, ld_qkv, 1, output, 0);
+}
+
+// FUNCTION TO RUN A CAUSAL FORWARD PASS OVER A PROMPT AND FILL THE CACHE
+void self_attention_prefill(SelfAttentionLayer* layer, KVCache* cache, const float* input, float* output, int seq_length) {
+    if (layer == NULL || cache == NULL || input == NULL || output == NULL || seq_length <= 0) return;
+    if (!cache_matches_layer(layer, cache, "self_attention_prefill")) return;
+
+    const int d = layer->embedding_dim;
+    const int ld_qkv = 3 * d;
+
+    // The batched path needs the prompt to land in order after the cached
+    // prefix; prompts that would wrap the ring are fed one token at a time
+    if (seq_length > layer->max_seq_length || cache->position != cache->length ||
+        cache->length + seq_length > cache->capacity) {
+        for (int i = 0; i < seq_length; i++) {
+            self_attention_decode_step(layer, cache, input + (size_t)i * d, output + (size_t)i * d);
         }
+        return;
     }
-    
-    for(int i = 0; i < FF_DIM; i++) {
-        for(int j = 0; j < EMBEDDING_DIM; j++) {
-            W2[i][j] = ((float) rand() / (float)(RAND_MAX)) - 0.5;
+
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, seq_length, ld_qkv, d,
+             1.0f, input, d, layer->W_QKV, ld_qkv, 0.0f, layer->QKV, ld_qkv);
+    for (int i = 0; i < seq_length; i++) {
+        const float* row = layer->QKV + (size_t)i * ld_qkv;
+        kv_cache_append(cache, row + d, row + 2 * d);
+    }
+
+    // Queries are the last seq_length cached positions; the causal mask hides later ones
+    attend_cached(layer, cache, layer->Q, ld_qkv, seq_length, output, 1);
+}
+
+// FUNCTION TO COMPUTE SELF-ATTENTION WITH TRAINABLE K, Q, V
+void self_attention(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length) {
+    // The default layer keeps its weights across calls
+    static SelfAttentionLayer* default_layer = NULL;
+
+    if (default_layer == NULL) {
+        default_layer = create_self_attention_layer(EMBEDDING_DIM, MAX_SEQ_LENGTH);
+        if (default_layer == NULL) {
+            printf("Memory allocation failed in self_attention\n");
+            return;
         }
     }
-    
+
+    self_attention_forward(default_layer, &input[0][0], &output[0][0], seq_length);
+}
+
+// FUNCTION TO CREATE A FEED FORWARD BLOCK
+FeedForwardBlock* create_feed_forward_block(int embedding_dim, int ff_dim, int max_seq_length) {
+    if (embedding_dim <= 0 || ff_dim <= 0 || max_seq_length <= 0) return NULL;
+
+    FeedForwardBlock* block = (FeedForwardBlock*)calloc(1, sizeof(FeedForwardBlock));
+    if (block == NULL) return NULL;
+
+    block->embedding_dim = embedding_dim;
+    block->ff_dim = ff_dim;
+    block->max_seq_length = max_seq_length;
+    block->workspace_rows = max_seq_length;
+
+    size_t weight_size = (size_t)embedding_dim * ff_dim;
+
+    // Allocate memory for weights and intermediate values
+    block->W1 = (float*)malloc(weight_size * sizeof(float));
+    block->W2 = (float*)malloc(weight_size * sizeof(float));
+    block->intermediate = (float*)malloc((size_t)max_seq_length * ff_dim * sizeof(float));
+
+    if (block->W1 == NULL || block->W2 == NULL || block->intermediate == NULL) {
+        free_feed_forward_block(block);
+        return NULL;
+    }
+
+    // Initialize weights (once, not per call)
+    for (size_t i = 0; i < weight_size; i++) {
+        block->W1[i] = ((float)rand() / (float)(RAND_MAX)) - 0.5f;
+    }
+    for (size_t i = 0; i < weight_size; i++) {
+        block->W2[i] = ((float)rand() / (float)(RAND_MAX)) - 0.5f;
+    }
+
+    return block;
+}
+
+// FUNCTION TO FREE A FEED FORWARD BLOCK
+void free_feed_forward_block(FeedForwardBlock* block) {
+    if (block == NULL) return;
+
+    free(block->W1);
+    free(block->W2);
+    free(block->intermediate);
+    free(block);
+}
+
+// FUNCTION TO GROW THE FEED FORWARD WORKSPACE TO HOLD rows TOKENS
+static int ensure_feed_forward_workspace(FeedForwardBlock* block, long rows) {
+    if (rows <= block->workspace_rows) return 1;
+
+    float* intermediate = (float*)realloc(block->intermediate, (size_t)rows * block->ff_dim * sizeof(float));
+    if (intermediate == NULL) {
+        fprintf(stderr, "feed_forward_block_forward: failed to grow the workspace to %ld rows\n", rows);
+        return 0;
+    }
+    block->intermediate = intermediate;
+    block->workspace_rows = rows;
+    return 1;
+}
+
+// FUNCTION TO RUN THE FEED FORWARD BLOCK
+void feed_forward_block_forward(FeedForwardBlock* block, const float* input, float* output, int seq_length, float* scratch) {
+    if (block == NULL || input == NULL || output == NULL || seq_length <= 0) return;
+
+    if (scratch == NULL) {
+        if (!ensure_feed_forward_workspace(block, seq_length)) return;
+        scratch = block->intermediate;
+    }
+
+    const int d = block->embedding_dim;
+    const int ff = block->ff_dim;
+
     // First linear transformation with ReLU
-    for(int i = 0; i < seq_length; i++) {
-        for(int j = 0; j < FF_DIM; j++) {
-            intermediate[i][j] = 0;
-            for(int k = 0; k < EMBEDDING_DIM; k++) {
-                intermediate[i][j] += input[i][k] * W1[k][j];
-            }
-            intermediate[i][j] = fmax(0, intermediate[i][j]); // ReLU activation
-        }
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, seq_length, ff, d,
+             1.0f, input, d, block->W1, ff, 0.0f, scratch, ff);
+    for (size_t i = 0; i < (size_t)seq_length * ff; i++) {
+        scratch[i] = fmaxf(0.0f, scratch[i]); // ReLU activation
     }
-    
+
     // Second linear transformation
-    for(int i = 0; i < seq_length; i++) {
-        for(int j = 0; j < EMBEDDING_DIM; j++) {
-            output[i][j] = 0;
-            for(int k = 0; k < FF_DIM; k++) {
-                output[i][j] += intermediate[i][k] * W2[k][j];
-            }
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, seq_length, d, ff,
+             1.0f, scratch, ff, block->W2, d, 0.0f, output, d);
+}
+
+// FUNCTION TO RUN THE FEED FORWARD BLOCK OVER A BATCH
+void feed_forward_block_forward_batch(FeedForwardBlock* block, const BatchTensor* input, BatchTensor* output) {
+    if (block == NULL || input == NULL || output == NULL) return;
+    if (input->dim != block->embedding_dim || output->dim != block->embedding_dim ||
+        output->batch != input->batch || output->max_seq != input->max_seq) {
+        fprintf(stderr, "feed_forward_block_forward_batch: tensor shapes do not match the block\n");
+        return;
+    }
+
+    // The whole batch goes through each linear layer as one (batch * max_seq)-row GEMM
+    batch_tensor_copy_lengths(output, input);
+    feed_forward_block_forward(block, input->data, output->data, input->batch * input->max_seq, NULL);
+    batch_tensor_clear_padding(output);
+}
+
+// FUNCTION TO APPLY THE FEED FORWARD NETWORK
+void feed_forward(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length) {
+    // The default block keeps its weights and workspace across calls
+    static FeedForwardBlock* default_block = NULL;
+
+    if (default_block == NULL) {
+        default_block = create_feed_forward_block(EMBEDDING_DIM, FF_DIM, MAX_SEQ_LENGTH);
+        if (default_block == NULL) {
+            printf("Memory allocation failed in feed_forward\n");
+            return;
         }
     }
-    
-    // Free allocated memory
-    free(W1);
-    free(W2);
-    free(intermediate);
+
+    feed_forward_block_forward(default_block, &input[0][0], &output[0][0], seq_length, NULL);
 }
 
-// FUNCTION TO APPLY LAYER NORMALIZATION
-void layer_normalization(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length) {
-    for(int i = 0; i < seq_length; i++) {
+// FUNCTION TO APPLY LAYER NORMALIZATION TO rows ROWS OF dim VALUES
+void layer_normalization_rows(const float* input, float* output, int rows, int dim) {
+    for(int i = 0; i < rows; i++) {
+        const float* in = input + (size_t)i * dim;
+        float* out = output + (size_t)i * dim;
+
         // Calculate mean
         float mean = 0.0f;
-        for(int j = 0; j < EMBEDDING_DIM; j++) {
-            mean += input[i][j];
+        for(int j = 0; j < dim; j++) {
+            mean += in[j];
         }
-        mean /= EMBEDDING_DIM;
+        mean /= dim;
 
         // Calculate variance
         float variance = 0.0f;
-        for(int j = 0; j < EMBEDDING_DIM; j++) {
-            variance += (input[i][j] - mean) * (input[i][j] - mean);
+        for(int j = 0; j < dim; j++) {
+            variance += (in[j] - mean) * (in[j] - mean);
         }
-        variance /= EMBEDDING_DIM;
+        variance /= dim;
 
         // Normalize
-        for(int j = 0; j < EMBEDDING_DIM; j++) {
-            output[i][j] = (input[i][j] - mean) / sqrt(variance + EPSILON);
+        for(int j = 0; j < dim; j++) {
+            out[j] = (in[j] - mean) / sqrt(variance + EPSILON);
         }
     }
-}
\ No newline at end of file
+}
+
+// FUNCTION TO APPLY LAYER NORMALIZATION
+void layer_normalization(float input[MAX_SEQ_LENGTH][EMBEDDING_DIM], float output[MAX_SEQ_LENGTH][EMBEDDING_DIM], int seq_length) {
+    layer_normalization_rows(&input[0][0], &output[0][0], seq_length, EMBEDDING_DIM);
+}
+
+// FUNCTION TO APPLY LAYER NORMALIZATION OVER A BATCH
+void layer_normalization_batch(const BatchTensor* input, BatchTensor* output) {
+    if (input == NULL || output == NULL) return;
+    if (output->batch != input->batch || output->max_seq != input->max_seq || output->dim != input->dim) {
+        fprintf(stderr, "layer_normalization_batch: tensor shapes do not match\n");
+        return;
+    }
+
+    batch_tensor_copy_lengths(output, input);
+    for (int b = 0; b < input->batch; b++) {
+        layer_normalization_rows(batch_tensor_row(input, b, 0), batch_tensor_row(output, b, 0),
+                                 input->lengths[b], input->dim);
+    }
+    batch_tensor_clear_padding(output);
+}
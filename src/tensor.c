@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/tensor.h"
+
+// FUNCTION TO CREATE A BATCH TENSOR
+BatchTensor* create_batch_tensor(int batch, int max_seq, int dim) {
+    if (batch <= 0 || max_seq <= 0 || dim <= 0) return NULL;
+
+    BatchTensor* tensor = (BatchTensor*)calloc(1, sizeof(BatchTensor));
+    if (tensor == NULL) return NULL;
+
+    tensor->batch = batch;
+    tensor->max_seq = max_seq;
+    tensor->dim = dim;
+    tensor->lengths = (int*)calloc(batch, sizeof(int));
+    tensor->data = (float*)calloc((size_t)batch * max_seq * dim, sizeof(float));
+    tensor->capacity = (size_t)batch * max_seq * dim;
+    tensor->batch_capacity = batch;
+
+    if (tensor->lengths == NULL || tensor->data == NULL) {
+        fprintf(stderr, "create_batch_tensor: failed to allocate a %d x %d x %d tensor\n", batch, max_seq, dim);
+        free_batch_tensor(tensor);
+        return NULL;
+    }
+
+    return tensor;
+}
+
+// FUNCTION TO FREE A BATCH TENSOR
+void free_batch_tensor(BatchTensor* tensor) {
+    if (tensor == NULL) return;
+
+    free(tensor->lengths);
+    free(tensor->data);
+    free(tensor);
+}
+
+// FUNCTION TO RESHAPE A BATCH TENSOR, GROWING ITS STORAGE ONLY WHEN NEEDED
+int batch_tensor_reshape(BatchTensor* tensor, int batch, int max_seq) {
+    if (tensor == NULL || batch <= 0 || max_seq <= 0) return 0;
+
+    size_t values = (size_t)batch * max_seq * tensor->dim;
+    if (values > tensor->capacity) {
+        float* data = (float*)realloc(tensor->data, values * sizeof(float));
+        if (data == NULL) {
+            fprintf(stderr, "batch_tensor_reshape: failed to allocate a %d x %d x %d tensor\n", batch, max_seq, tensor->dim);
+            return 0;
+        }
+        tensor->data = data;
+        tensor->capacity = values;
+    }
+    if (batch > tensor->batch_capacity) {
+        int* lengths = (int*)realloc(tensor->lengths, (size_t)batch * sizeof(int));
+        if (lengths == NULL) {
+            fprintf(stderr, "batch_tensor_reshape: failed to allocate %d lengths\n", batch);
+            return 0;
+        }
+        tensor->lengths = lengths;
+        tensor->batch_capacity = batch;
+    }
+
+    tensor->batch = batch;
+    tensor->max_seq = max_seq;
+    memset(tensor->lengths, 0, (size_t)batch * sizeof(int));
+    return 1;
+}
+
+// FUNCTION TO GET ROW i OF SEQUENCE b
+float* batch_tensor_row(const BatchTensor* tensor, int b, int i) {
+    return tensor->data + ((size_t)b * tensor->max_seq + i) * tensor->dim;
+}
+
+// FUNCTION TO SET THE VALID LENGTH OF SEQUENCE b
+void batch_tensor_set_length(BatchTensor* tensor, int b, int length) {
+    if (length < 0) length = 0;
+    if (length > tensor->max_seq) length = tensor->max_seq;
+    tensor->lengths[b] = length;
+}
+
+// FUNCTION TO COPY SEQUENCE LENGTHS BETWEEN TENSORS
+void batch_tensor_copy_lengths(BatchTensor* dst, const BatchTensor* src) {
+    for (int b = 0; b < dst->batch && b < src->batch; b++) {
+        batch_tensor_set_length(dst, b, src->lengths[b]);
+    }
+}
+
+// FUNCTION TO ZERO THE PADDING ROWS
+void batch_tensor_clear_padding(BatchTensor* tensor) {
+    for (int b = 0; b < tensor->batch; b++) {
+        int pad = tensor->max_seq - tensor->lengths[b];
+        if (pad > 0) {
+            memset(batch_tensor_row(tensor, b, tensor->lengths[b]), 0, (size_t)pad * tensor->dim * sizeof(float));
+        }
+    }
+}
+
+// FUNCTION TO FILL THE PADDING MASK
+void batch_tensor_fill_mask(const BatchTensor* tensor, unsigned char* mask) {
+    for (int b = 0; b < tensor->batch; b++) {
+        unsigned char* row = mask + (size_t)b * tensor->max_seq;
+        memset(row, 1, tensor->lengths[b]);
+        memset(row + tensor->lengths[b], 0, tensor->max_seq - tensor->lengths[b]);
+    }
+}
+
+// FUNCTION TO COUNT THE REAL TOKENS OF A BATCH
+long batch_tensor_num_tokens(const BatchTensor* tensor) {
+    long total = 0;
+    for (int b = 0; b < tensor->batch; b++) {
+        total += tensor->lengths[b];
+    }
+    return total;
+}
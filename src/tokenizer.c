@@ -5,90 +5,172 @@
 #include <math.h>
 
 #include "../include/tokenizer.h"
+#include "../include/Data_Loading_Cleaning.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Global variables
-word_token_node* hashTable[TABLE_SIZE] = {NULL};
+Vocab* vocabulary = NULL;
 int global_token = 1;
+float* embedding_table = NULL;
+int embedding_table_capacity = 0;
+
+// 0 when embedding_table is a view into a mapped checkpoint
+static int embedding_table_owned = 1;
+
+// Mapped snapshot the vocabulary and/or the embedding table are views into
+static Checkpoint* snapshot = NULL;
+static int vocabulary_on_snapshot = 0;
+static int embeddings_on_snapshot = 0;
+
+// Tensor names inside a tokenizer snapshot
+#define SNAPSHOT_VOCAB_PREFIX "tokenizer.vocab"
+#define SNAPSHOT_EMBEDDINGS "tokenizer.embeddings"
+#define SNAPSHOT_COUNTS "tokenizer.counts"
+
+// UNMAP THE SNAPSHOT ONCE NOTHING POINTS INTO IT
+static void releaseSnapshotIfUnused(void) {
+    if (snapshot != NULL && !vocabulary_on_snapshot && !embeddings_on_snapshot) {
+        free_checkpoint(snapshot);
+        snapshot = NULL;
+    }
+}
 
-// IMPROVED HASH FUNCTION USING DJB2 ALGORITHM
-unsigned int hash(const char *word) {
-    unsigned long hashValue = 5381;
-    int c;
+// Occurrences of each token ID seen by extractUniqueWords (index 0 unused)
+static unsigned long* token_counts = NULL;
+static size_t token_counts_capacity = 0;
 
-    while ((c = *word) != '\0') {
-        hashValue = ((hashValue << 5) + hashValue) + tolower(c); // hash * 33 + c
-        word++;
+// WORD DELIMITERS USED WHEN EXTRACTING THE VOCABULARY (INDEXED BY BYTE)
+static const unsigned char is_delimiter[256] = {
+    [' '] = 1, [','] = 1, ['.'] = 1, [';'] = 1, ['!'] = 1, ['?'] = 1, ['-'] = 1
+};
+
+// FIND THE NEXT WORD OF A NUL-TERMINATED STRING (REENTRANT, UNLIKE strtok)
+size_t nextWord(const char** cursor, const char** word) {
+    const char* p = *cursor;
+
+    while (*p != '\0' && is_delimiter[(unsigned char)*p]) p++;
+    *word = p;
+    while (*p != '\0' && !is_delimiter[(unsigned char)*p]) p++;
+    *cursor = p;
+    return (size_t)(p - *word);
+}
+
+// ADD n OCCURRENCES OF A TOKEN ID TO ITS COUNT
+static void countToken(unsigned int token_id, unsigned long n) {
+    if (token_id >= token_counts_capacity) {
+        size_t capacity = token_counts_capacity > 0 ? token_counts_capacity : 1024;
+        while (capacity <= token_id) capacity *= 2;
+        unsigned long* counts = (unsigned long*)realloc(token_counts, capacity * sizeof(unsigned long));
+        if (counts == NULL) return;
+        memset(counts + token_counts_capacity, 0, (capacity - token_counts_capacity) * sizeof(unsigned long));
+        token_counts = counts;
+        token_counts_capacity = capacity;
     }
+    token_counts[token_id] += n;
+}
 
-    return hashValue % TABLE_SIZE;
+// GET HOW OFTEN A TOKEN ID WAS SEEN BY extractUniqueWords
+unsigned long getTokenCount(unsigned int token_id) {
+    return (token_id < token_counts_capacity) ? token_counts[token_id] : 0;
 }
 
-void insertWord(const char* word) {
-    unsigned int index = hash(word);
-    word_token_node* newNode = (word_token_node*)malloc(sizeof(word_token_node));
+// HASH A WORD WITH THE VOCABULARY HASH
+unsigned int hash(const char *word) {
+    return vocab_hash(word, strlen(word));
+}
 
-    if (newNode == NULL) {
-        fprintf(stderr, "Memory allocation failed for newNode.\n");
-        return;
+// CREATE THE VOCABULARY ON FIRST USE
+static Vocab* getVocabulary(void) {
+    if (vocabulary == NULL) {
+        vocabulary = create_vocab(TOKENIZER_INITIAL_WORDS);
+        if (vocabulary == NULL) {
+            fprintf(stderr, "Memory allocation failed for vocabulary.\n");
+        }
     }
+    return vocabulary;
+}
 
-    newNode->word = strdup(word);
+// GROW THE EMBEDDING TABLE SO THAT IT HAS A ROW FOR token_id
+// New rows are zero. A table bound to a checkpoint is copied out before it grows.
+static int ensureEmbeddingRow(unsigned int token_id) {
+    if ((long)token_id < embedding_table_capacity) return 1;
 
-    if (newNode->word == NULL) {
-        fprintf(stderr, "Memory allocation failed for word string.\n");
-        free(newNode);
-        return;
-    }
+    long capacity = embedding_table_capacity > 0 ? embedding_table_capacity : 1024;
+    while (capacity <= (long)token_id) capacity *= 2;
 
-    newNode->token_id = global_token++;
-    newNode->next = hashTable[index];
-    hashTable[index] = newNode;
+    float* table = (float*)calloc((size_t)capacity * TOKEN_EMBEDDING_DIM, sizeof(float));
+    if (table == NULL) return 0;
+
+    if (embedding_table != NULL) {
+        memcpy(table, embedding_table, (size_t)embedding_table_capacity * TOKEN_EMBEDDING_DIM * sizeof(float));
+        if (embedding_table_owned) free(embedding_table);
+    }
+    embedding_table = table;
+    embedding_table_capacity = (int)capacity;
+    embedding_table_owned = 1;
+    embeddings_on_snapshot = 0;
+    releaseSnapshotIfUnused();
+    return 1;
 }
 
-// CHECK IF THE WORD IS PRESENT IN THE HASH TABLE
-int isWordPresent(const char* word) {
-    unsigned int index = hash(word);
-    word_token_node* current = hashTable[index];
+// LOOK UP A WORD, ADDING IT (WITH A ZERO EMBEDDING ROW) IF IT IS NEW
+unsigned int lookupOrInsertWord(const char* word, size_t length, int* inserted) {
+    int is_new = 0;
+    if (inserted != NULL) *inserted = 0;
+
+    Vocab* vocab = getVocabulary();
+    if (vocab == NULL || word == NULL) return 0;
 
-    while (current) {
-        if (strcmp(current->word, word) == 0) {
-            return 1; // Word found
+    unsigned int token_id = vocab_lookup_or_insert(vocab, word, length, &is_new);
+    if (token_id == 0) {
+        fprintf(stderr, "Memory allocation failed for vocabulary word.\n");
+        return 0;
+    }
+
+    if (is_new) {
+        global_token = (int)token_id + 1;
+        if (!ensureEmbeddingRow(token_id)) {
+            fprintf(stderr, "Memory allocation failed for embedding table.\n");
         }
-        current = current->next;
     }
+    if (inserted != NULL) *inserted = is_new;
+    return token_id;
+}
+
+// INSERT A WORD INTO THE VOCABULARY
+void insertWord(const char* word) {
+    if (word == NULL) return;
+    lookupOrInsertWord(word, strlen(word), NULL);
+}
 
-    return 0; // Word not found
+// CHECK IF THE WORD IS PRESENT IN THE VOCABULARY
+int isWordPresent(const char* word) {
+    return getTokenId(word) != 0;
 }
 
 // PRINT THE TOKENS AND THEIR IDS
 void Print_Tokens_And_Ids(void) {
+    unsigned int count = (vocabulary != NULL) ? vocabulary->count : 0;
+
     printf("Token / Token ID / Embedding:\n");
-    printf("Table Size: %d \n", TABLE_SIZE);
-
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        word_token_node* current = hashTable[i];
-        while (current) {
-            printf("%s : %d : { %.4f, %.4f }\n", 
-                   current->word, current->token_id, 
-                   current->embedding[0], current->embedding[1]);
-            current = current->next;
-        }
+    printf("Vocabulary Size: %u \n", count);
+
+    for (unsigned int id = 1; id <= count; id++) {
+        const float* embedding = getEmbedding(id);
+        printf("%s : %u : { %.4f, %.4f }\n",
+               vocab_word(vocabulary, id), id,
+               embedding != NULL ? embedding[0] : 0.0f,
+               embedding != NULL ? embedding[1] : 0.0f);
     }
 }
 
 // GET THE TOKEN ID FOR THE GIVEN WORD
 unsigned int getTokenId(const char* word) {
-    unsigned int index = hash(word);
-    word_token_node* current = hashTable[index];
-
-    while (current) {
-        if (strcmp(current->word, word) == 0) {
-            return current->token_id;
-        }
-        current = current->next;
-    }
-
-    return 0; // Word not found
+    if (word == NULL) return 0;
+    return vocab_find(vocabulary, word, strlen(word));
 }
 
 // GENERATE A RANDOM FLOAT BETWEEN -50.0 AND 50.0
@@ -120,65 +202,372 @@ float** Word_Embedding_Generation(int token_id) {
     return embedding;
 }
 
+// COUNT A WORD, GIVING A NEW ONE A RANDOM EMBEDDING WRITTEN IN PLACE
+static unsigned int addWordOccurrences(const char* word, size_t length, unsigned long n) {
+    int inserted = 0;
+    unsigned int token_id = lookupOrInsertWord(word, length, &inserted);
+    float* embedding = inserted ? getEmbedding(token_id) : NULL;
+
+    if (embedding != NULL) {
+        for (int d = 0; d < TOKEN_EMBEDDING_DIM; d++) {
+            embedding[d] = generate_random();
+        }
+    }
+    if (token_id != 0) countToken(token_id, n);
+    return token_id;
+}
+
 // EXTRACT UNIQUE WORDS FROM AN ARRAY OF SENTENCES AND GENERATE EMBEDDINGS
+// Words are delimited in place (no copy of the sentence), each one is hashed
+// and probed once, and a new word's embedding is written straight into its
+// row of the embedding table.
 void extractUniqueWords(char** sentences) {
-    const char* delimiters = " ,.;!?-";
-
     for (int i = 0; sentences[i] != NULL; i++) {
-        char* sentence = strdup(sentences[i]);
+        const char* p = sentences[i];
+        const char* word;
+        size_t length;
 
-        if (sentence == NULL) {
-            continue;
+        while ((length = nextWord(&p, &word)) > 0) {
+            addWordOccurrences(word, length, 1);
+        }
+    }
+}
+
+// One shard of the parallel vocabulary build: its words in first-seen order, with counts
+typedef struct {
+    Vocab* words;
+    unsigned long* counts;
+    size_t counts_capacity;
+} VocabularyShard;
+
+// FUNCTION TO COUNT THE WORDS OF SENTENCES [begin, end) INTO A SHARD
+static int buildVocabularyShard(char** sentences, int begin, int end, VocabularyShard* shard) {
+    shard->words = create_vocab(TOKENIZER_INITIAL_WORDS);
+    shard->counts_capacity = TOKENIZER_INITIAL_WORDS;
+    shard->counts = (unsigned long*)calloc(shard->counts_capacity, sizeof(unsigned long));
+    if (shard->words == NULL || shard->counts == NULL) return 0;
+
+    for (int i = begin; i < end; i++) {
+        const char* p = sentences[i];
+        const char* word;
+        size_t length;
+
+        while ((length = nextWord(&p, &word)) > 0) {
+            uint32_t id = vocab_lookup_or_insert(shard->words, word, length, NULL);
+            if (id == 0) return 0;
+
+            if (id >= shard->counts_capacity) {
+                size_t capacity = shard->counts_capacity * 2;
+                unsigned long* counts = (unsigned long*)realloc(shard->counts, capacity * sizeof(unsigned long));
+                if (counts == NULL) return 0;
+                memset(counts + shard->counts_capacity, 0, (capacity - shard->counts_capacity) * sizeof(unsigned long));
+                shard->counts = counts;
+                shard->counts_capacity = capacity;
+            }
+            shard->counts[id]++;
+        }
+    }
+    return 1;
+}
+
+// EXTRACT UNIQUE WORDS WITH SEVERAL THREADS
+// Map: contiguous shards of sentences are counted concurrently into private
+// vocabularies. Reduce: shards are merged into the global vocabulary in shard
+// order, each in its own first-seen order, which is exactly the order a serial
+// pass meets new words in. Token IDs, counts and embeddings (rand() is only
+// called during the merge) therefore match extractUniqueWords for any thread count.
+int extractUniqueWordsParallel(char** sentences, int num_threads) {
+    int num_sentences = 0;
+    while (sentences[num_sentences] != NULL) num_sentences++;
+
+#ifdef _OPENMP
+    if (num_threads <= 0) num_threads = omp_get_max_threads();
+#else
+    num_threads = 1;
+#endif
+    if (num_threads > num_sentences) num_threads = num_sentences;
+    if (num_threads <= 1) {
+        extractUniqueWords(sentences);
+        return 1;
+    }
+
+    // A few shards per thread so uneven sentence lengths still balance
+    int num_shards = num_threads * 4 < num_sentences ? num_threads * 4 : num_sentences;
+    VocabularyShard* shards = (VocabularyShard*)calloc(num_shards, sizeof(VocabularyShard));
+    if (shards == NULL) return 0;
+
+    int ok = 1;
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads) reduction(&& : ok)
+    for (int s = 0; s < num_shards; s++) {
+        int begin = (int)((long)num_sentences * s / num_shards);
+        int end = (int)((long)num_sentences * (s + 1) / num_shards);
+        ok = buildVocabularyShard(sentences, begin, end, &shards[s]) && ok;
+    }
+
+    for (int s = 0; s < num_shards && ok; s++) {
+        const Vocab* words = shards[s].words;
+        for (uint32_t id = 1; id <= words->count; id++) {
+            addWordOccurrences(vocab_word(words, id), vocab_word_length(words, id), shards[s].counts[id]);
         }
+    }
+
+    for (int s = 0; s < num_shards; s++) {
+        free_vocab(shards[s].words);
+        free(shards[s].counts);
+    }
+    free(shards);
+    if (!ok) fprintf(stderr, "Memory allocation failed while building the vocabulary.\n");
+    return ok;
+}
+
+// CREATE AN EMPTY TOKENIZED CORPUS
+TokenizedCorpus* createTokenizedCorpus(void) {
+    TokenizedCorpus* corpus = (TokenizedCorpus*)calloc(1, sizeof(TokenizedCorpus));
+    if (corpus == NULL) return NULL;
+
+    corpus->ids_capacity = 4096;
+    corpus->sentences_capacity = 256;
+    corpus->ids = (uint32_t*)malloc(corpus->ids_capacity * sizeof(uint32_t));
+    corpus->sentence_starts = (size_t*)malloc((corpus->sentences_capacity + 1) * sizeof(size_t));
+    if (corpus->ids == NULL || corpus->sentence_starts == NULL) {
+        freeTokenizedCorpus(corpus);
+        return NULL;
+    }
+    corpus->sentence_starts[0] = 0;
+    return corpus;
+}
+
+// FREE A TOKENIZED CORPUS
+void freeTokenizedCorpus(TokenizedCorpus* corpus) {
+    if (corpus == NULL) return;
+    free(corpus->ids);
+    free(corpus->sentence_starts);
+    free(corpus);
+}
+
+// APPEND ONE TOKEN ID, DOUBLING THE ID BUFFER WHEN IT IS FULL
+static int appendTokenId(TokenizedCorpus* corpus, uint32_t token_id) {
+    if (corpus->num_ids == corpus->ids_capacity) {
+        size_t capacity = corpus->ids_capacity * 2;
+        uint32_t* ids = (uint32_t*)realloc(corpus->ids, capacity * sizeof(uint32_t));
+        if (ids == NULL) return 0;
+        corpus->ids = ids;
+        corpus->ids_capacity = capacity;
+    }
+    corpus->ids[corpus->num_ids++] = token_id;
+    return 1;
+}
 
-        char* token = strtok(sentence, delimiters);
-
-        while (token != NULL) {
-            if (!isWordPresent(token)) {
-                insertWord(token);
-                unsigned int token_id = getTokenId(token);
-                float** embedding = Word_Embedding_Generation(token_id);
-
-                if (embedding != NULL) {
-                    unsigned int index = hash(token);
-                    word_token_node* current = hashTable[index];
-
-                    while (current) {
-                        if (strcmp(current->word, token) == 0) {
-                            current->embedding[0] = embedding[0][0];
-                            current->embedding[1] = embedding[1][0];
-                            break;
-                        }
-                        current = current->next;
-                    }
-                    free(embedding[0]);
-                    free(embedding[1]);
-                    free(embedding);
+// CLOSE THE CURRENT SENTENCE AT THE CURRENT END OF THE ID BUFFER
+static int endTokenizedSentence(TokenizedCorpus* corpus) {
+    if (corpus->num_sentences == corpus->sentences_capacity) {
+        size_t capacity = corpus->sentences_capacity * 2;
+        size_t* starts = (size_t*)realloc(corpus->sentence_starts, (capacity + 1) * sizeof(size_t));
+        if (starts == NULL) return 0;
+        corpus->sentence_starts = starts;
+        corpus->sentences_capacity = capacity;
+    }
+    corpus->sentence_starts[++corpus->num_sentences] = corpus->num_ids;
+    return 1;
+}
+
+// SPLIT, CLEAN AND TOKENIZE RAW TEXT IN ONE PASS
+// Each byte is classified once through text_clean_table: word bytes are
+// appended (lowercased) to a small word buffer, spaces and sentence ends
+// flush the word to its token id, and other bytes are dropped, so no cleaned
+// copy of the text or of any sentence is ever made.
+int tokenizeText(TokenizedCorpus* corpus, const char* text, size_t length, int flags) {
+    static _Thread_local char* word_buffer = NULL;
+    static _Thread_local size_t word_buffer_capacity = 0;
+    // Local copies: stores into word (a char*) would otherwise force reloads of the thread-locals
+    char* word = word_buffer;
+    size_t word_capacity = word_buffer_capacity;
+    size_t word_length = 0;
+    int in_sentence = 0;
+    int ok = 1;
+
+    if (corpus == NULL || text == NULL) return 0;
+
+    for (size_t i = 0; i <= length && ok; i++) {
+        unsigned char c = (i < length) ? (unsigned char)text[i] : '.';
+        unsigned char mapped = text_clean_table[c];
+
+        if (mapped > ' ') {
+            if (word_length == word_capacity) {
+                size_t capacity = word_capacity > 0 ? word_capacity * 2 : 64;
+                char* grown = (char*)realloc(word, capacity);
+                if (grown == NULL) {
+                    ok = 0;
+                    break;
                 }
+                word = word_buffer = grown;
+                word_capacity = word_buffer_capacity = capacity;
             }
-            token = strtok(NULL, delimiters);
+            word[word_length++] = (char)mapped;
+            in_sentence = 1;
+            continue;
+        }
+
+        int sentence_end = (c == '.' || c == '!' || c == '?');
+        if (word_length > 0 && (mapped == ' ' || sentence_end)) {
+            uint32_t token_id = (flags & TOKENIZE_ADD_WORDS) ? addWordOccurrences(word, word_length, 1)
+                                                             : vocab_find(vocabulary, word, word_length);
+            ok = appendTokenId(corpus, token_id);
+            word_length = 0;
+        }
+        if (sentence_end) {
+            if (in_sentence && ok) ok = endTokenizedSentence(corpus);
+            in_sentence = 0;
+        } else {
+            in_sentence = 1;  // Spaces and dropped bytes still belong to a sentence
         }
-        free(sentence);
     }
+
+    if (!ok) fprintf(stderr, "Memory allocation failed while tokenizing text.\n");
+    return ok;
+}
+
+// GET THE EMBEDDING ROW FOR THE GIVEN TOKEN ID
+float* getEmbedding(unsigned int token_id) {
+    if ((long)token_id >= embedding_table_capacity) return NULL;
+    return embedding_table + (size_t)token_id * TOKEN_EMBEDDING_DIM;
+}
+
+// STORE THE EMBEDDING FOR THE GIVEN TOKEN ID
+int setEmbedding(unsigned int token_id, const float* embedding) {
+    if (token_id == 0 || embedding == NULL || !ensureEmbeddingRow(token_id)) return 0;
+
+    memcpy(getEmbedding(token_id), embedding, TOKEN_EMBEDDING_DIM * sizeof(float));
+    return 1;
 }
 
 // GET THE EMBEDDING FOR THE GIVEN TOKEN ID
-void getEmbeddingByTokenId(unsigned int token_id, double expected_embedding[2]) {
-    // Initialize with default values
-    expected_embedding[0] = 0.0;
-    expected_embedding[1] = 0.0;
-
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        word_token_node* current = hashTable[i];
-        
-        while (current) {
-            if (current->token_id == token_id) {
-                expected_embedding[0] = current->embedding[0];
-                expected_embedding[1] = current->embedding[1];
-                return;
-            }
-            current = current->next;
+void getEmbeddingByTokenId(unsigned int token_id, double expected_embedding[TOKEN_EMBEDDING_DIM]) {
+    const float* row = getEmbedding(token_id);
+
+    // Unknown token IDs get the zero embedding
+    for (int d = 0; d < TOKEN_EMBEDDING_DIM; d++) {
+        expected_embedding[d] = (row != NULL) ? row[d] : 0.0;
+    }
+}
+
+// GATHER THE EMBEDDINGS OF A TOKEN SEQUENCE INTO A count x TOKEN_EMBEDDING_DIM MATRIX
+void gatherEmbeddings(const int* token_ids, int count, float* output) {
+    for (int i = 0; i < count; i++) {
+        float* out = output + (size_t)i * TOKEN_EMBEDDING_DIM;
+        const float* row = (token_ids[i] > 0) ? getEmbedding((unsigned int)token_ids[i]) : NULL;
+
+        if (row != NULL) {
+            memcpy(out, row, TOKEN_EMBEDDING_DIM * sizeof(float));
+        } else {
+            memset(out, 0, TOKEN_EMBEDDING_DIM * sizeof(float));
         }
     }
-    // Token ID not found - embeddings remain at default values
-}
\ No newline at end of file
+}
+
+// DESCRIBE THE EMBEDDING TABLE AS A CHECKPOINT TENSOR
+int embeddingTableCheckpointTensor(const char* name, CheckpointTensor* tensor) {
+    if (!ensureEmbeddingRow((unsigned int)global_token - 1)) return 0;
+
+    long shape[2] = { global_token, TOKEN_EMBEDDING_DIM };
+    return checkpoint_tensor_init(tensor, name, CHECKPOINT_F32, 2, shape, embedding_table);
+}
+
+// POINT THE EMBEDDING TABLE AT A CHECKPOINT TENSOR WITHOUT COPYING
+int bindEmbeddingTableToCheckpoint(const Checkpoint* checkpoint, const char* name) {
+    const CheckpointTensor* tensor = checkpoint_find(checkpoint, name);
+
+    if (tensor == NULL || tensor->dtype != CHECKPOINT_F32 || tensor->ndim != 2 ||
+        tensor->shape[1] != TOKEN_EMBEDDING_DIM || tensor->shape[0] < 1) {
+        fprintf(stderr, "Checkpoint has no F32 [vocab][%d] embedding table %s\n", TOKEN_EMBEDDING_DIM, name);
+        return 0;
+    }
+
+    freeEmbeddingTable();
+    embedding_table = (float*)tensor->data;
+    embedding_table_capacity = (int)tensor->shape[0];
+    embedding_table_owned = 0;
+    return 1;
+}
+
+// RELEASE THE VOCABULARY
+void freeVocabulary(void) {
+    free_vocab(vocabulary);
+    vocabulary = NULL;
+    global_token = 1;
+    free(token_counts);
+    token_counts = NULL;
+    token_counts_capacity = 0;
+    vocabulary_on_snapshot = 0;
+    releaseSnapshotIfUnused();
+}
+
+// RELEASE THE EMBEDDING TABLE
+void freeEmbeddingTable(void) {
+    if (embedding_table_owned) free(embedding_table);
+    embedding_table = NULL;
+    embedding_table_capacity = 0;
+    embedding_table_owned = 1;
+    embeddings_on_snapshot = 0;
+    releaseSnapshotIfUnused();
+}
+
+// SAVE THE VOCABULARY, EMBEDDINGS AND COUNTS TO A SNAPSHOT FILE
+int saveTokenizerSnapshot(const char* path) {
+    Vocab* vocab = getVocabulary();
+    if (vocab == NULL) return 0;
+
+    CheckpointTensor tensors[VOCAB_CHECKPOINT_TENSORS + 2];
+    uint64_t* counts = (uint64_t*)malloc(((size_t)vocab->count + 1) * sizeof(uint64_t));
+    long counts_shape[1] = { (long)vocab->count + 1 };
+    if (counts == NULL) return 0;
+
+    for (uint32_t id = 0; id <= vocab->count; id++) counts[id] = getTokenCount(id);
+
+    int ok = vocab_checkpoint_tensors(vocab, SNAPSHOT_VOCAB_PREFIX, tensors) == VOCAB_CHECKPOINT_TENSORS &&
+             embeddingTableCheckpointTensor(SNAPSHOT_EMBEDDINGS, &tensors[VOCAB_CHECKPOINT_TENSORS]) &&
+             checkpoint_tensor_init(&tensors[VOCAB_CHECKPOINT_TENSORS + 1], SNAPSHOT_COUNTS, CHECKPOINT_U64, 1,
+                                    counts_shape, counts) &&
+             checkpoint_save(path, tensors, VOCAB_CHECKPOINT_TENSORS + 2);
+    free(counts);
+    return ok;
+}
+
+// MAP A SNAPSHOT AND USE IT AS THE TOKENIZER STATE WITHOUT REHASHING
+int loadTokenizerSnapshot(const char* path) {
+    // Copy-on-write, so embeddings and the vocabulary can still be updated
+    Checkpoint* checkpoint = checkpoint_map(path, CHECKPOINT_MAP_WRITABLE);
+    if (checkpoint == NULL) return 0;
+
+    Vocab* vocab = create_vocab_from_checkpoint(checkpoint, SNAPSHOT_VOCAB_PREFIX);
+    const CheckpointTensor* embeddings = checkpoint_find(checkpoint, SNAPSHOT_EMBEDDINGS);
+    const CheckpointTensor* counts = checkpoint_find(checkpoint, SNAPSHOT_COUNTS);
+    // Everything is checked before the current state is torn down, so a rejected file leaves it untouched
+    if (vocab == NULL || embeddings == NULL || embeddings->dtype != CHECKPOINT_F32 || embeddings->ndim != 2 ||
+        embeddings->shape[0] != (long)vocab->count + 1 || embeddings->shape[1] != TOKEN_EMBEDDING_DIM ||
+        counts == NULL || counts->dtype != CHECKPOINT_U64 || counts->ndim != 1 ||
+        counts->shape[0] != (long)vocab->count + 1) {
+        fprintf(stderr, "Tokenizer snapshot %s is incomplete\n", path);
+        free_vocab(vocab);
+        free_checkpoint(checkpoint);
+        return 0;
+    }
+
+    // Replace the current state (which may itself live in an older snapshot)
+    freeVocabulary();
+    freeEmbeddingTable();
+    snapshot = checkpoint;
+    vocabulary = vocab;
+    vocabulary_on_snapshot = 1;
+    global_token = (int)vocab->count + 1;
+
+    bindEmbeddingTableToCheckpoint(checkpoint, SNAPSHOT_EMBEDDINGS);  // Cannot fail: checked above
+    embeddings_on_snapshot = 1;
+
+    // Counts are small and rarely read: copy them so countToken can grow them
+    const uint64_t* saved_counts = (const uint64_t*)counts->data;
+    for (uint32_t id = 1; id <= vocab->count; id++) {
+        if (saved_counts[id] > 0) countToken(id, (unsigned long)saved_counts[id]);
+    }
+    return 1;
+}
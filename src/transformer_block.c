@@ -29,10 +29,13 @@ double* positional_encoding(int index, int vector_size) {
 #define MAX_SENTENCE_LENGTH 512
 #define CLIP_THRESHOLD 100
 
-// DEFINE MATRICES
-double k_matrix[MATRIX_SIZE][MATRIX_SIZE];
-double q_matrix[MATRIX_SIZE][MATRIX_SIZE];
-double v_matrix[MATRIX_SIZE][MATRIX_SIZE];
+// DEFINE MATRICES (STATIC STORAGE UNTIL BOUND TO A MAPPED CHECKPOINT)
+static double k_storage[MATRIX_SIZE][MATRIX_SIZE];
+static double q_storage[MATRIX_SIZE][MATRIX_SIZE];
+static double v_storage[MATRIX_SIZE][MATRIX_SIZE];
+double (*k_matrix)[MATRIX_SIZE] = k_storage;
+double (*q_matrix)[MATRIX_SIZE] = q_storage;
+double (*v_matrix)[MATRIX_SIZE] = v_storage;
 
 // FUNCTION TO READ A SINGLE VALUE FROM A FILE
 double read_single_value_from_file(const char* filename) {
@@ -92,6 +95,45 @@ void initialize_matrices_from_files() {
     printf("Initialized VALUE MATRIX\n");
 }
 
+// FUNCTION TO INITIALIZE MATRICES FROM A BINARY CHECKPOINT
+int initialize_matrices_from_checkpoint(const Checkpoint* checkpoint) {
+    const long count = MATRIX_SIZE * MATRIX_SIZE;
+
+    if(checkpoint_read_f64(checkpoint, "attention.key", &k_matrix[0][0], count) != count ||
+       checkpoint_read_f64(checkpoint, "attention.query", &q_matrix[0][0], count) != count ||
+       checkpoint_read_f64(checkpoint, "attention.value", &v_matrix[0][0], count) != count) {
+        printf("Checkpoint is missing the attention matrices\n");
+        return 0;
+    }
+    printf("Initialized KEY, QUERY and VALUE MATRICES from checkpoint\n");
+    return 1;
+}
+
+// FUNCTION TO POINT THE MATRICES AT A MAPPED CHECKPOINT WITHOUT COPYING
+int bind_attention_matrices_to_checkpoint(const Checkpoint* checkpoint) {
+    const long count = MATRIX_SIZE * MATRIX_SIZE;
+    double* k = (double*)checkpoint_view(checkpoint, "attention.key", CHECKPOINT_F64, count);
+    double* q = (double*)checkpoint_view(checkpoint, "attention.query", CHECKPOINT_F64, count);
+    double* v = (double*)checkpoint_view(checkpoint, "attention.value", CHECKPOINT_F64, count);
+
+    if(k == NULL || q == NULL || v == NULL) {
+        printf("Checkpoint is missing the attention matrices\n");
+        return 0;
+    }
+    k_matrix = (double (*)[MATRIX_SIZE])k;
+    q_matrix = (double (*)[MATRIX_SIZE])q;
+    v_matrix = (double (*)[MATRIX_SIZE])v;
+    printf("Bound KEY, QUERY and VALUE MATRICES to checkpoint\n");
+    return 1;
+}
+
+// FUNCTION TO POINT THE MATRICES BACK AT THEIR STATIC STORAGE
+void unbind_attention_matrices(void) {
+    k_matrix = k_storage;
+    q_matrix = q_storage;
+    v_matrix = v_storage;
+}
+
 // FUNCTION TO PRINT THE MATRICES
 void print_matrix(const char* name, double matrix[MATRIX_SIZE][MATRIX_SIZE]) {
     printf("%s:\n", name);
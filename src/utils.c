@@ -1,14 +1,12 @@
 #include "../include/utils.h"
+#include "../include/gemm.h"
+#include "../include/kernels.h"
 #include <assert.h>
 
 // FUNCTION TO COMPUTE THE DOT PRODUCT OF TWO VECTORS (FLOAT)
 float dot_product_float(float *a, float *b, int dim) {
     assert(a != NULL && b != NULL && dim > 0);
-    float result = 0.0f;
-    for(int i = 0; i < dim; i++) {
-        result += a[i] * b[i];
-    }
-    return result;
+    return kernels()->dot(a, b, dim);
 }
 
 // FUNCTION TO COMPUTE THE DOT PRODUCT OF TWO MATRICES (DOUBLE)
@@ -26,26 +24,17 @@ void dot_product_double(double A[][2], double B[][2], double result[][2]) {
 // FUNCTION TO APPLY SOFTMAX TO A VECTOR OF SCORES (FLOAT)
 void softmax_float(float *input, float *output, int length) {
     assert(input != NULL && output != NULL && length > 0);
-    
-    // Find maximum value for numerical stability
-    float max_val = input[0];
-    for(int i = 1; i < length; i++) {
-        if(input[i] > max_val) {
-            max_val = input[i];
-        }
-    }
+    const KernelTable* kt = kernels();
+
+    // Subtract the maximum value for numerical stability
+    float max_val = kt->row_max(input, length);
 
     // Compute exponentials and sum
-    float sum = 0.0f;
-    for(int i = 0; i < length; i++) {
-        output[i] = exp(input[i] - max_val);
-        sum += output[i];
-    }
+    kt->vexp(input, max_val, output, length);
+    float sum = kt->row_sum(output, length);
 
     // Normalize to get probabilities
-    for(int i = 0; i < length; i++) {
-        output[i] /= sum;
-    }
+    kt->scale(length, 1.0f / sum, output);
 }
 
 // FUNCTION TO APPLY SOFTMAX TO A MATRIX (DOUBLE)
@@ -63,14 +52,8 @@ void softmax_double(double matrix[][2]) {
 
 // FUNCTION TO MULTIPLY TWO MATRICES (FLOAT)
 void matrix_multiply_float(float *A, float *B, float *C, int rows_A, int cols_A, int cols_B) {
-    for(int i = 0; i < rows_A; i++) {
-        for(int j = 0; j < cols_B; j++) {
-            C[i * cols_B + j] = 0.0f;
-            for(int k = 0; k < cols_A; k++) {
-                C[i * cols_B + j] += A[i * cols_A + k] * B[k * cols_B + j];
-            }
-        }
-    }
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, rows_A, cols_B, cols_A,
+             1.0f, A, cols_A, B, cols_B, 0.0f, C, cols_B);
 }
 
 // FUNCTION TO MULTIPLY TWO MATRICES (DOUBLE)
@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/vocab.h"
+
+// FUNCTION TO READ 8 BYTES OF A WORD REGARDLESS OF ALIGNMENT
+static uint64_t load64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// FUNCTION TO MIX THE BITS OF A 64-BIT VALUE (MURMUR3 FINALIZER)
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// FUNCTION TO HASH A WORD EIGHT BYTES AT A TIME
+uint32_t vocab_hash(const char* word, size_t length) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ ((uint64_t)length * 0x100000001b3ULL);
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        h = (h ^ load64(word + i)) * 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
+    }
+    if (i < length) {
+        uint64_t tail = 0;
+        memcpy(&tail, word + i, length - i);
+        h = (h ^ tail) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    uint32_t result = (uint32_t)mix64(h);
+    return result != 0 ? result : 1;  // 0 marks an empty slot
+}
+
+// FUNCTION TO ROUND UP TO A POWER OF TWO
+static uint32_t next_power_of_two(size_t n) {
+    uint32_t p = 16;
+    while (p < n && p < (1u << 31)) p <<= 1;
+    return p;
+}
+
+// FUNCTION TO CREATE AN EMPTY VOCABULARY
+Vocab* create_vocab(size_t expected_words) {
+    Vocab* vocab = (Vocab*)calloc(1, sizeof(Vocab));
+    if (vocab == NULL) return NULL;
+
+    vocab->capacity = next_power_of_two(expected_words * VOCAB_MAX_LOAD_DEN / VOCAB_MAX_LOAD_NUM + 1);
+    vocab->slots = (VocabSlot*)calloc(vocab->capacity, sizeof(VocabSlot));
+    vocab->arena_capacity = 4096 + expected_words * 8;
+    vocab->arena = (char*)malloc(vocab->arena_capacity);
+    vocab->offsets_capacity = (uint32_t)(expected_words + 2);
+    vocab->word_offsets = (uint32_t*)malloc(vocab->offsets_capacity * sizeof(uint32_t));
+
+    if (vocab->slots == NULL || vocab->arena == NULL || vocab->word_offsets == NULL) {
+        free_vocab(vocab);
+        return NULL;
+    }
+    vocab->word_offsets[0] = 0;
+    vocab->owns_memory = 1;
+    return vocab;
+}
+
+// FUNCTION TO FREE A VOCABULARY
+void free_vocab(Vocab* vocab) {
+    if (vocab == NULL) return;
+
+    if (vocab->owns_memory) {
+        free(vocab->slots);
+        free(vocab->arena);
+        free(vocab->word_offsets);
+    }
+    free(vocab);
+}
+
+// FUNCTION TO GET HOW FAR A SLOT'S ENTRY SITS FROM ITS HOME SLOT
+static uint32_t probe_distance(const Vocab* vocab, uint32_t slot, uint32_t hash) {
+    return (slot - (hash & (vocab->capacity - 1))) & (vocab->capacity - 1);
+}
+
+// FUNCTION TO PLACE AN ENTRY WITHOUT COMPARING WORDS (IT IS KNOWN TO BE NEW)
+// Robin Hood: an entry further from home than the resident takes its slot,
+// and the resident moves on, which keeps probe lengths short and even.
+static void place_slot(Vocab* vocab, VocabSlot entry, uint32_t slot, uint32_t dist) {
+    const uint32_t mask = vocab->capacity - 1;
+
+    for (;;) {
+        VocabSlot* s = &vocab->slots[slot];
+        if (s->hash == 0) {
+            *s = entry;
+            return;
+        }
+        uint32_t resident_dist = probe_distance(vocab, slot, s->hash);
+        if (resident_dist < dist) {
+            VocabSlot displaced = *s;
+            *s = entry;
+            entry = displaced;
+            dist = resident_dist;
+        }
+        slot = (slot + 1) & mask;
+        dist++;
+    }
+}
+
+// FUNCTION TO DOUBLE THE SLOT ARRAY (STORED HASHES: NO WORD IS RE-READ)
+static int grow_slots(Vocab* vocab) {
+    VocabSlot* old_slots = vocab->slots;
+    uint32_t old_capacity = vocab->capacity;
+
+    if (old_capacity >= (1u << 31)) return 0;
+    VocabSlot* slots = (VocabSlot*)calloc((size_t)old_capacity * 2, sizeof(VocabSlot));
+    if (slots == NULL) return 0;
+
+    vocab->slots = slots;
+    vocab->capacity = old_capacity * 2;
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].hash != 0) {
+            place_slot(vocab, old_slots[i], old_slots[i].hash & (vocab->capacity - 1), 0);
+        }
+    }
+    free(old_slots);
+    return 1;
+}
+
+// FUNCTION TO COPY A WORD INTO THE ARENA AND RECORD ITS TOKEN ID
+static int intern_word(Vocab* vocab, const char* word, size_t length, uint32_t token_id) {
+    if (vocab->arena_size + length + 1 > UINT32_MAX) {
+        fprintf(stderr, "vocab: string arena is full\n");
+        return 0;
+    }
+    if (vocab->arena_size + length + 1 > vocab->arena_capacity) {
+        size_t capacity = vocab->arena_capacity * 2;
+        while (capacity < vocab->arena_size + length + 1) capacity *= 2;
+        char* arena = (char*)realloc(vocab->arena, capacity);
+        if (arena == NULL) return 0;
+        vocab->arena = arena;
+        vocab->arena_capacity = capacity;
+    }
+    if (token_id >= vocab->offsets_capacity) {
+        uint32_t capacity = vocab->offsets_capacity * 2;
+        uint32_t* offsets = (uint32_t*)realloc(vocab->word_offsets, capacity * sizeof(uint32_t));
+        if (offsets == NULL) return 0;
+        vocab->word_offsets = offsets;
+        vocab->offsets_capacity = capacity;
+    }
+
+    memcpy(vocab->arena + vocab->arena_size, word, length);
+    vocab->arena[vocab->arena_size + length] = '\0';
+    vocab->word_offsets[token_id] = (uint32_t)vocab->arena_size;
+    vocab->arena_size += length + 1;
+    return 1;
+}
+
+// FUNCTION TO COPY A VOCABULARY OUT OF THE CHECKPOINT VIEWS IT WAS CREATED ON
+static int take_ownership(Vocab* vocab) {
+    size_t arena_capacity = vocab->arena_size * 2 + 4096;
+    uint32_t offsets_capacity = vocab->count * 2 + 2;
+    VocabSlot* slots = (VocabSlot*)malloc((size_t)vocab->capacity * sizeof(VocabSlot));
+    char* arena = (char*)malloc(arena_capacity);
+    uint32_t* offsets = (uint32_t*)malloc(offsets_capacity * sizeof(uint32_t));
+
+    if (slots == NULL || arena == NULL || offsets == NULL) {
+        free(slots);
+        free(arena);
+        free(offsets);
+        return 0;
+    }
+    memcpy(slots, vocab->slots, (size_t)vocab->capacity * sizeof(VocabSlot));
+    memcpy(arena, vocab->arena, vocab->arena_size);
+    memcpy(offsets, vocab->word_offsets, ((size_t)vocab->count + 1) * sizeof(uint32_t));
+
+    vocab->slots = slots;
+    vocab->arena = arena;
+    vocab->arena_capacity = arena_capacity;
+    vocab->word_offsets = offsets;
+    vocab->offsets_capacity = offsets_capacity;
+    vocab->owns_memory = 1;
+    return 1;
+}
+
+// FUNCTION TO LOOK UP A WORD
+uint32_t vocab_find(const Vocab* vocab, const char* word, size_t length) {
+    if (vocab == NULL || word == NULL) return 0;
+
+    const uint32_t hash = vocab_hash(word, length);
+    const uint32_t mask = vocab->capacity - 1;
+    uint32_t slot = hash & mask;
+
+    for (uint32_t dist = 0;; dist++, slot = (slot + 1) & mask) {
+        const VocabSlot* s = &vocab->slots[slot];
+        // An empty slot, or a resident closer to home than we are, ends the search
+        if (s->hash == 0 || probe_distance(vocab, slot, s->hash) < dist) return 0;
+        if (s->hash == hash && s->length == length &&
+            memcmp(vocab->arena + s->offset, word, length) == 0) {
+            return s->token_id;
+        }
+    }
+}
+
+// FUNCTION TO LOOK UP A WORD, INSERTING IT IF IT IS NEW
+uint32_t vocab_lookup_or_insert(Vocab* vocab, const char* word, size_t length, int* inserted) {
+    if (inserted != NULL) *inserted = 0;
+    if (vocab == NULL || word == NULL || length >= UINT32_MAX) return 0;
+
+    // A vocabulary on checkpoint views is copied out before it changes
+    if (!vocab->owns_memory && !take_ownership(vocab)) return 0;
+
+    // Grow first so the probe below can insert where it stops
+    if ((uint64_t)(vocab->count + 1) * VOCAB_MAX_LOAD_DEN > (uint64_t)vocab->capacity * VOCAB_MAX_LOAD_NUM &&
+        !grow_slots(vocab)) {
+        return 0;
+    }
+
+    const uint32_t hash = vocab_hash(word, length);
+    const uint32_t mask = vocab->capacity - 1;
+    uint32_t slot = hash & mask;
+    uint32_t dist = 0;
+
+    for (;; dist++, slot = (slot + 1) & mask) {
+        const VocabSlot* s = &vocab->slots[slot];
+        if (s->hash == 0 || probe_distance(vocab, slot, s->hash) < dist) break;
+        if (s->hash == hash && s->length == length &&
+            memcmp(vocab->arena + s->offset, word, length) == 0) {
+            return s->token_id;
+        }
+    }
+
+    uint32_t token_id = vocab->count + 1;
+    if (!intern_word(vocab, word, length, token_id)) return 0;
+
+    VocabSlot entry = { hash, token_id, vocab->word_offsets[token_id], (uint32_t)length };
+    place_slot(vocab, entry, slot, dist);
+    vocab->count++;
+    if (inserted != NULL) *inserted = 1;
+    return token_id;
+}
+
+// FUNCTION TO GET THE WORD OF A TOKEN ID
+const char* vocab_word(const Vocab* vocab, uint32_t token_id) {
+    if (vocab == NULL || token_id == 0 || token_id > vocab->count) return NULL;
+    return vocab->arena + vocab->word_offsets[token_id];
+}
+
+// FUNCTION TO GET THE LENGTH OF THE WORD OF A TOKEN ID
+size_t vocab_word_length(const Vocab* vocab, uint32_t token_id) {
+    if (vocab == NULL || token_id == 0 || token_id > vocab->count) return 0;
+
+    // Words are interned in id order, so the next word starts right after this one
+    size_t end = (token_id < vocab->count) ? vocab->word_offsets[token_id + 1] : vocab->arena_size;
+    return end - vocab->word_offsets[token_id] - 1;
+}
+
+// Snapshot compatibility stamp: hash version and slot layout
+static const uint32_t vocab_meta[2] = { VOCAB_HASH_VERSION, sizeof(VocabSlot) };
+
+// Suffixes of the snapshot tensors, in vocab_checkpoint_tensors order
+static const char* snapshot_names[VOCAB_CHECKPOINT_TENSORS] = { "meta", "slots", "arena", "offsets" };
+
+// FUNCTION TO DESCRIBE A VOCABULARY AS CHECKPOINT TENSORS
+int vocab_checkpoint_tensors(const Vocab* vocab, const char* prefix, CheckpointTensor* tensors) {
+    if (vocab == NULL || prefix == NULL || tensors == NULL) return 0;
+
+    long shapes[VOCAB_CHECKPOINT_TENSORS][2] = {
+        { 2, 0 },
+        { vocab->capacity, sizeof(VocabSlot) / sizeof(uint32_t) },
+        { (long)vocab->arena_size, 0 },
+        { (long)vocab->count + 1, 0 }
+    };
+    CheckpointDType dtypes[VOCAB_CHECKPOINT_TENSORS] = { CHECKPOINT_U32, CHECKPOINT_U32, CHECKPOINT_U8, CHECKPOINT_U32 };
+    const void* data[VOCAB_CHECKPOINT_TENSORS] = { vocab_meta, vocab->slots, vocab->arena, vocab->word_offsets };
+    char name[CHECKPOINT_NAME_LEN];
+
+    for (int i = 0; i < VOCAB_CHECKPOINT_TENSORS; i++) {
+        snprintf(name, sizeof(name), "%s.%s", prefix, snapshot_names[i]);
+        if (!checkpoint_tensor_init(&tensors[i], name, dtypes[i], i == 1 ? 2 : 1, shapes[i], (void*)data[i])) {
+            return 0;
+        }
+    }
+    return VOCAB_CHECKPOINT_TENSORS;
+}
+
+// FUNCTION TO CREATE A VOCABULARY ON CHECKPOINT VIEWS
+Vocab* create_vocab_from_checkpoint(const Checkpoint* checkpoint, const char* prefix) {
+    if (checkpoint == NULL || prefix == NULL) return NULL;
+
+    const CheckpointTensor* t[VOCAB_CHECKPOINT_TENSORS];
+    char name[CHECKPOINT_NAME_LEN];
+    for (int i = 0; i < VOCAB_CHECKPOINT_TENSORS; i++) {
+        snprintf(name, sizeof(name), "%s.%s", prefix, snapshot_names[i]);
+        t[i] = checkpoint_find(checkpoint, name);
+        if (t[i] == NULL) {
+            fprintf(stderr, "vocab: checkpoint has no tensor %s\n", name);
+            return NULL;
+        }
+    }
+
+    const uint32_t* meta = (const uint32_t*)t[0]->data;
+    if (t[0]->dtype != CHECKPOINT_U32 || t[0]->nbytes != sizeof(vocab_meta) ||
+        meta[0] != vocab_meta[0] || meta[1] != vocab_meta[1]) {
+        fprintf(stderr, "vocab: %s was written with an incompatible hash or slot layout\n", prefix);
+        return NULL;
+    }
+
+    // The slot array must be a power of two, offsets must fit the arena and count must fit the slots
+    long capacity = t[1]->shape[0];
+    long count = t[3]->shape[0] - 1;
+    const uint32_t* offsets = (const uint32_t*)t[3]->data;
+    int ok = t[1]->dtype == CHECKPOINT_U32 && t[1]->ndim == 2 && t[1]->nbytes == (size_t)capacity * sizeof(VocabSlot) &&
+             capacity >= 16 && capacity <= (1L << 31) && (capacity & (capacity - 1)) == 0 &&
+             t[2]->dtype == CHECKPOINT_U8 && t[3]->dtype == CHECKPOINT_U32 && t[3]->ndim == 1 &&
+             count >= 0 && count < capacity;
+    for (long id = 1; ok && id <= count; id++) {
+        ok = offsets[id] < t[2]->nbytes && (id == 1 || offsets[id] > offsets[id - 1]);
+    }
+    if (ok && count > 0 && ((const char*)t[2]->data)[t[2]->nbytes - 1] != '\0') ok = 0;
+
+    // Lookups compare words straight out of the arena, so every occupied slot must name
+    // a distinct token id, that word's arena offset and a NUL-terminated length inside the arena
+    unsigned char* seen = ok ? (unsigned char*)calloc((size_t)count + 1, 1) : NULL;
+    if (ok && seen == NULL) return NULL;
+    const VocabSlot* slots = (const VocabSlot*)t[1]->data;
+    const char* arena = (const char*)t[2]->data;
+    long occupied = 0;
+    for (long i = 0; ok && i < capacity; i++) {
+        const VocabSlot* s = &slots[i];
+        if (s->hash == 0) continue;
+        ok = s->token_id >= 1 && s->token_id <= count && !seen[s->token_id] &&
+             s->offset == offsets[s->token_id] && s->length < t[2]->nbytes - s->offset &&
+             arena[s->offset + s->length] == '\0';
+        if (ok) seen[s->token_id] = 1;
+        occupied++;
+    }
+    free(seen);
+    if (!ok || occupied != count) {
+        fprintf(stderr, "vocab: tensors of %s are inconsistent\n", prefix);
+        return NULL;
+    }
+
+    Vocab* vocab = (Vocab*)calloc(1, sizeof(Vocab));
+    if (vocab == NULL) return NULL;
+
+    vocab->slots = (VocabSlot*)t[1]->data;
+    vocab->capacity = (uint32_t)capacity;
+    vocab->count = (uint32_t)count;
+    vocab->arena = (char*)t[2]->data;
+    vocab->arena_size = t[2]->nbytes;
+    vocab->arena_capacity = t[2]->nbytes;
+    vocab->word_offsets = (uint32_t*)t[3]->data;
+    vocab->offsets_capacity = (uint32_t)count + 1;
+    vocab->owns_memory = 0;
+    return vocab;
+}
@@ -88,6 +88,179 @@ void test_self_attention() {
     printf("self_attention test passed!\n\n");
 }
 
+// Test the persistent self-attention layer
+void test_self_attention_layer() {
+    printf("Testing self_attention_forward...\n");
+
+    int dim = 64, max_len = 16, seq_len = 10;
+    SelfAttentionLayer* layer = create_self_attention_layer(dim, max_len);
+    assert(layer != NULL);
+
+    float* input = malloc(max_len * dim * sizeof(float));
+    float* first = malloc(max_len * dim * sizeof(float));
+    float* second = malloc(max_len * dim * sizeof(float));
+    for(int i = 0; i < seq_len * dim; i++) {
+        input[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+
+    self_attention_forward(layer, input, first, seq_len);
+    self_attention_forward(layer, input, second, seq_len);
+
+    // Weights are created once, so repeated calls must agree exactly
+    for(int i = 0; i < seq_len * dim; i++) {
+        assert(!isnan(first[i]));
+        assert(first[i] == second[i]);
+    }
+
+    free(input);
+    free(first);
+    free(second);
+    free_self_attention_layer(layer);
+
+    printf("self_attention_forward test passed!\n\n");
+}
+
+// Test the fused Q/K/V projection against separate per-matrix projections
+void test_fused_qkv() {
+    printf("Testing fused QKV projection...\n");
+
+    int dim = 24, max_len = 8, seq_len = 6;
+    SelfAttentionLayer* layer = create_self_attention_layer(dim, max_len);
+    assert(layer != NULL);
+
+    float* W[3];
+    for(int w = 0; w < 3; w++) {
+        W[w] = malloc(dim * dim * sizeof(float));
+        for(int i = 0; i < dim * dim; i++) {
+            W[w][i] = (((float)rand() / (float)RAND_MAX) - 0.5f) * 0.5f;
+        }
+    }
+    self_attention_set_weights(layer, W[0], W[1], W[2]);
+
+    float* input = malloc(max_len * dim * sizeof(float));
+    float* output = malloc(max_len * dim * sizeof(float));
+    for(int i = 0; i < seq_len * dim; i++) {
+        input[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+    self_attention_forward(layer, input, output, seq_len);
+
+    // Reference: separate Q, K, V projections, scaled scores, softmax, weighted sum of V
+    double proj[3][8][24];
+    for(int w = 0; w < 3; w++) {
+        for(int i = 0; i < seq_len; i++) {
+            for(int j = 0; j < dim; j++) {
+                double sum = 0.0;
+                for(int k = 0; k < dim; k++) sum += input[i * dim + k] * W[w][k * dim + j];
+                proj[w][i][j] = sum;
+            }
+        }
+    }
+    for(int i = 0; i < seq_len; i++) {
+        double scores[8], max_score = -1e30, total = 0.0;
+        for(int j = 0; j < seq_len; j++) {
+            double sum = 0.0;
+            for(int k = 0; k < dim; k++) sum += proj[0][i][k] * proj[1][j][k];
+            scores[j] = sum / sqrt((double)dim);
+            if(scores[j] > max_score) max_score = scores[j];
+        }
+        for(int j = 0; j < seq_len; j++) {
+            scores[j] = exp(scores[j] - max_score);
+            total += scores[j];
+        }
+        for(int k = 0; k < dim; k++) {
+            double expected = 0.0;
+            for(int j = 0; j < seq_len; j++) expected += scores[j] / total * proj[2][j][k];
+            assert(fabs(output[i * dim + k] - expected) < 1e-4);
+        }
+    }
+
+    for(int w = 0; w < 3; w++) free(W[w]);
+    free(input);
+    free(output);
+    free_self_attention_layer(layer);
+
+    printf("Fused QKV projection test passed!\n\n");
+}
+
+// Test multi-head attention against a per-head reference followed by the output projection
+void test_multi_head_attention() {
+    printf("Testing multi-head attention...\n");
+
+    int dim = 32, num_heads = 4, max_len = 12, seq_len = 9;
+    int hd = dim / num_heads;
+
+    assert(create_multi_head_attention_layer(dim, 5, max_len) == NULL);
+
+    SelfAttentionLayer* layer = create_multi_head_attention_layer(dim, num_heads, max_len);
+    assert(layer != NULL);
+    assert(layer->head_dim == hd && layer->W_O != NULL);
+
+    // Keep the logits small so every head has a non-trivial softmax
+    for(int i = 0; i < dim * 3 * dim; i++) layer->W_QKV[i] *= 0.5f;
+
+    float* input = malloc(max_len * dim * sizeof(float));
+    float* output = malloc(max_len * dim * sizeof(float));
+    float* threaded = malloc(max_len * dim * sizeof(float));
+    for(int i = 0; i < seq_len * dim; i++) {
+        input[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+
+    self_attention_forward(layer, input, output, seq_len);
+
+    // Reference projections: proj[w][i][c] = input[i] . W_QKV[:, w * dim + c]
+    double proj[3][12][32], context[12][32];
+    for(int w = 0; w < 3; w++) {
+        for(int i = 0; i < seq_len; i++) {
+            for(int c = 0; c < dim; c++) {
+                double sum = 0.0;
+                for(int k = 0; k < dim; k++) sum += input[i * dim + k] * layer->W_QKV[k * 3 * dim + w * dim + c];
+                proj[w][i][c] = sum;
+            }
+        }
+    }
+    for(int h = 0; h < num_heads; h++) {
+        for(int i = 0; i < seq_len; i++) {
+            double scores[12], max_score = -1e30, total = 0.0;
+            for(int j = 0; j < seq_len; j++) {
+                double sum = 0.0;
+                for(int k = h * hd; k < (h + 1) * hd; k++) sum += proj[0][i][k] * proj[1][j][k];
+                scores[j] = sum / sqrt((double)hd);
+                if(scores[j] > max_score) max_score = scores[j];
+            }
+            for(int j = 0; j < seq_len; j++) {
+                scores[j] = exp(scores[j] - max_score);
+                total += scores[j];
+            }
+            for(int k = h * hd; k < (h + 1) * hd; k++) {
+                context[i][k] = 0.0;
+                for(int j = 0; j < seq_len; j++) context[i][k] += scores[j] / total * proj[2][j][k];
+            }
+        }
+    }
+    for(int i = 0; i < seq_len; i++) {
+        for(int c = 0; c < dim; c++) {
+            double expected = 0.0;
+            for(int k = 0; k < dim; k++) expected += context[i][k] * layer->W_O[k * dim + c];
+            assert(fabs(output[i * dim + c] - expected) < 1e-4);
+        }
+    }
+
+    // Heads split across a worker team must give the same result
+    gemm_set_num_threads(3);
+    self_attention_forward(layer, input, threaded, seq_len);
+    gemm_set_num_threads(0);
+    for(int i = 0; i < seq_len * dim; i++) {
+        assert(threaded[i] == output[i]);
+    }
+
+    free(input);
+    free(output);
+    free(threaded);
+    free_self_attention_layer(layer);
+
+    printf("Multi-head attention test passed!\n\n");
+}
+
 // Test layer normalization
 void test_layer_normalization() {
     printf("Testing layer_normalization...\n");
@@ -142,6 +315,48 @@ void test_feed_forward() {
     printf("feed_forward test passed!\n\n");
 }
 
+// Test the persistent feed forward block with its own and a caller-provided workspace
+void test_feed_forward_block() {
+    printf("Testing feed_forward_block_forward...\n");
+
+    int dim = 32, ff_dim = 96, max_len = 8, seq_len = 5;
+    FeedForwardBlock* block = create_feed_forward_block(dim, ff_dim, max_len);
+    assert(block != NULL);
+
+    float* input = malloc(max_len * dim * sizeof(float));
+    float* owned = malloc(max_len * dim * sizeof(float));
+    float* external = malloc(max_len * dim * sizeof(float));
+    float* scratch = malloc(seq_len * ff_dim * sizeof(float));
+    for(int i = 0; i < seq_len * dim; i++) {
+        input[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+
+    feed_forward_block_forward(block, input, owned, seq_len, NULL);
+    feed_forward_block_forward(block, input, external, seq_len, scratch);
+
+    // Check against a direct computation of ReLU(x W1) W2
+    for(int i = 0; i < seq_len; i++) {
+        for(int j = 0; j < dim; j++) {
+            double expected = 0.0;
+            for(int h = 0; h < ff_dim; h++) {
+                double hidden = 0.0;
+                for(int k = 0; k < dim; k++) hidden += input[i * dim + k] * block->W1[k * ff_dim + h];
+                if(hidden > 0) expected += hidden * block->W2[h * dim + j];
+            }
+            assert(fabs(owned[i * dim + j] - expected) < 1e-3);
+            assert(owned[i * dim + j] == external[i * dim + j]);
+        }
+    }
+
+    free(input);
+    free(owned);
+    free(external);
+    free(scratch);
+    free_feed_forward_block(block);
+
+    printf("feed_forward_block_forward test passed!\n\n");
+}
+
 int main() {
     printf("Starting self-attention layer tests...\n\n");
     
@@ -152,8 +367,12 @@ int main() {
     test_softmax();
     test_matrix_multiply();
     test_self_attention();
+    test_self_attention_layer();
+    test_fused_qkv();
+    test_multi_head_attention();
     test_layer_normalization();
     test_feed_forward();
+    test_feed_forward_block();
     
     printf("All tests completed successfully!\n");
     return 0;
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include "../include/self_attention_layer.h"
+#include "../include/feed_forward_layer.h"
+#include "../include/tensor.h"
+
+#define DIM 32
+#define BATCH 4
+#define MAX_SEQ 10
+
+static const int seq_lengths[BATCH] = {10, 4, 0, 7};
+
+// Fill a batch with random tokens and the test lengths
+static BatchTensor* random_batch(void) {
+    BatchTensor* t = create_batch_tensor(BATCH, MAX_SEQ, DIM);
+    assert(t != NULL);
+    for(int b = 0; b < BATCH; b++) {
+        batch_tensor_set_length(t, b, seq_lengths[b]);
+        for(int i = 0; i < seq_lengths[b] * DIM; i++) {
+            batch_tensor_row(t, b, 0)[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+        }
+    }
+    return t;
+}
+
+// Check a batched result against one computed sequence by sequence
+static void assert_matches_per_sequence(const BatchTensor* out, const float* expected, int b) {
+    assert(out->lengths[b] == seq_lengths[b]);
+    for(int i = 0; i < MAX_SEQ; i++) {
+        const float* row = batch_tensor_row(out, b, i);
+        for(int j = 0; j < DIM; j++) {
+            if(i < seq_lengths[b]) {
+                assert(fabsf(row[j] - expected[i * DIM + j]) < 1e-5f);
+            } else {
+                assert(row[j] == 0.0f);  // Padding is zeroed
+            }
+        }
+    }
+}
+
+// Test tensor lengths, masks and padding helpers
+void test_batch_tensor() {
+    printf("Testing BatchTensor...\n");
+
+    assert(create_batch_tensor(0, 4, 4) == NULL);
+
+    BatchTensor* t = create_batch_tensor(2, 3, 2);
+    assert(t != NULL);
+    batch_tensor_set_length(t, 0, 5);   // Clamped to max_seq
+    batch_tensor_set_length(t, 1, 1);
+    assert(t->lengths[0] == 3 && t->lengths[1] == 1);
+    assert(batch_tensor_num_tokens(t) == 4);
+    assert(batch_tensor_row(t, 1, 2) == t->data + (1 * 3 + 2) * 2);
+
+    for(int i = 0; i < 2 * 3 * 2; i++) t->data[i] = 1.0f;
+    batch_tensor_clear_padding(t);
+    assert(batch_tensor_row(t, 1, 0)[1] == 1.0f);
+    assert(batch_tensor_row(t, 1, 1)[0] == 0.0f && batch_tensor_row(t, 1, 2)[1] == 0.0f);
+
+    unsigned char mask[6];
+    batch_tensor_fill_mask(t, mask);
+    unsigned char expected[6] = {1, 1, 1, 1, 0, 0};
+    for(int i = 0; i < 6; i++) assert(mask[i] == expected[i]);
+
+    // Shrinking keeps the storage, growing reallocates it
+    float* storage = t->data;
+    assert(batch_tensor_reshape(t, 3, 2));
+    assert(t->batch == 3 && t->max_seq == 2 && t->data == storage);
+    assert(t->lengths[0] == 0 && t->lengths[2] == 0 && batch_tensor_num_tokens(t) == 0);
+    assert(batch_tensor_row(t, 2, 1) == t->data + (2 * 2 + 1) * 2);
+    assert(batch_tensor_reshape(t, 4, 8) && t->capacity == 4 * 8 * 2 && t->batch_capacity == 4);
+    batch_tensor_set_length(t, 3, 8);
+    for(int i = 0; i < 4 * 8 * 2; i++) t->data[i] = 1.0f;
+    assert(batch_tensor_num_tokens(t) == 8);
+    assert(!batch_tensor_reshape(t, 0, 8) && t->batch == 4 && t->max_seq == 8);
+
+    free_batch_tensor(t);
+    printf("BatchTensor test passed\n");
+}
+
+// Test batched attention against per-sequence calls
+void test_attention_batch(int num_heads) {
+    printf("Testing self_attention_forward_batch with %d head(s)...\n", num_heads);
+
+    SelfAttentionLayer* layer = create_multi_head_attention_layer(DIM, num_heads, MAX_SEQ);
+    assert(layer != NULL);
+    BatchTensor* in = random_batch();
+    BatchTensor* out = create_batch_tensor(BATCH, MAX_SEQ, DIM);
+    assert(out != NULL);
+
+    self_attention_forward_batch(layer, in, out);
+
+    float expected[MAX_SEQ * DIM];
+    for(int b = 0; b < BATCH; b++) {
+        if(seq_lengths[b] > 0) {
+            self_attention_forward(layer, batch_tensor_row(in, b, 0), expected, seq_lengths[b]);
+        }
+        assert_matches_per_sequence(out, expected, b);
+    }
+
+    free_batch_tensor(in);
+    free_batch_tensor(out);
+    free_self_attention_layer(layer);
+    printf("Batched attention test with %d head(s) passed\n", num_heads);
+}
+
+// Test the batched feed forward block and layer normalization against per-sequence calls
+void test_feed_forward_and_norm_batch() {
+    printf("Testing feed_forward_block_forward_batch and layer_normalization_batch...\n");
+
+    FeedForwardBlock* block = create_feed_forward_block(DIM, 3 * DIM, MAX_SEQ);
+    assert(block != NULL);
+    BatchTensor* in = random_batch();
+    BatchTensor* out = create_batch_tensor(BATCH, MAX_SEQ, DIM);
+    BatchTensor* norm = create_batch_tensor(BATCH, MAX_SEQ, DIM);
+    assert(out != NULL && norm != NULL);
+
+    feed_forward_block_forward_batch(block, in, out);
+    layer_normalization_batch(out, norm);
+
+    float expected[MAX_SEQ * DIM], expected_norm[MAX_SEQ * DIM];
+    for(int b = 0; b < BATCH; b++) {
+        if(seq_lengths[b] > 0) {
+            feed_forward_block_forward(block, batch_tensor_row(in, b, 0), expected, seq_lengths[b], NULL);
+            layer_normalization_rows(expected, expected_norm, seq_lengths[b], DIM);
+        }
+        assert_matches_per_sequence(out, expected, b);
+        assert_matches_per_sequence(norm, expected_norm, b);
+    }
+
+    free_batch_tensor(in);
+    free_batch_tensor(out);
+    free_batch_tensor(norm);
+    free_feed_forward_block(block);
+    printf("Batched feed forward and layer normalization test passed\n");
+}
+
+// Test that the batched double feed forward layer matches single-sample calls exactly
+void test_feed_forward_layer_batch() {
+    printf("Testing feed_forward_forward_batch...\n");
+
+    int batch = 5, in_size = 6, hidden = 9, out_size = 3;
+    FeedForwardLayer* layer = create_feed_forward_layer(in_size, hidden, out_size);
+    assert(layer != NULL);
+    for(int i = 0; i < hidden; i++) layer->bias1[i] = 0.01 * i - 0.02;
+
+    double inputs[5 * 6], outputs[5 * 3];
+    for(int i = 0; i < batch * in_size; i++) inputs[i] = (double)rand() / RAND_MAX - 0.5;
+
+    assert(feed_forward_forward_batch(layer, inputs, outputs, batch, NULL));
+    for(int b = 0; b < batch; b++) {
+        double* single = feed_forward_forward(layer, inputs + b * in_size);
+        assert(single != NULL);
+        for(int i = 0; i < out_size; i++) {
+            assert(single[i] == outputs[b * out_size + i]);
+        }
+        free(single);
+    }
+
+    // The workspace is kept across calls, and a caller-provided scratch gives the same result
+    double* workspace = layer->hidden;
+    assert(layer->workspace_rows == batch);
+    assert(feed_forward_forward_batch(layer, inputs, outputs, batch, NULL));
+    assert(layer->hidden == workspace);
+
+    double scratch[5 * 9], with_scratch[5 * 3];
+    assert(feed_forward_forward_batch(layer, inputs, with_scratch, batch, scratch));
+    assert(memcmp(outputs, with_scratch, sizeof(outputs)) == 0);
+
+    free_feed_forward_layer(layer);
+    printf("feed_forward_forward_batch test passed\n");
+}
+
+int main() {
+    printf("Starting batched forward tests...\n\n");
+
+    srand(42);
+
+    test_batch_tensor();
+    test_attention_batch(1);
+    test_attention_batch(4);
+    test_feed_forward_and_norm_batch();
+    test_feed_forward_layer_batch();
+
+    printf("\nAll batched forward tests passed successfully!\n");
+    return 0;
+}
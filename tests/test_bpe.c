@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../include/bpe.h"
+
+#define NUM_SENTENCES 400
+
+// Reference encoder: apply every merge, in rank order, left to right over the whole word
+static int reference_encode(const BPETokenizer* tokenizer, const char* word, int length, uint32_t* ids) {
+    for (int i = 0; i < length; i++) ids[i] = (unsigned char)word[i];
+    for (int r = 0; r < tokenizer->num_merges; r++) {
+        int out = 0;
+        for (int i = 0; i < length; i++) {
+            if (i + 1 < length && ids[i] == tokenizer->merges[r].left && ids[i + 1] == tokenizer->merges[r].right) {
+                ids[out++] = BPE_BYTE_TOKENS + r;
+                i++;
+            } else {
+                ids[out++] = ids[i];
+            }
+        }
+        length = out;
+    }
+    return length;
+}
+
+// Sentences of words built from a few syllables, so frequent pairs exist
+static char** make_corpus(void) {
+    const char* syllables[] = { "th", "e", "an", "ing", "er", "a", "re", "on", "s", "t" };
+    char** sentences = malloc((NUM_SENTENCES + 1) * sizeof(char*));
+    srand(9);
+    for (int i = 0; i < NUM_SENTENCES; i++) {
+        sentences[i] = malloc(512);
+        int pos = 0;
+        for (int w = 0; w < 10; w++) {
+            int parts = 1 + rand() % 4;
+            for (int p = 0; p < parts; p++) {
+                int sy = (rand() % 10) * (rand() % 10) / 10;  // Skewed towards early syllables
+                pos += sprintf(sentences[i] + pos, "%s", syllables[sy]);
+            }
+            sentences[i][pos++] = (w == 9) ? '.' : ' ';
+        }
+        sentences[i][pos] = '\0';
+    }
+    sentences[NUM_SENTENCES] = NULL;
+    return sentences;
+}
+
+// Test that trained merges encode every word like the reference and decode back to its bytes
+void test_train_and_encode() {
+    printf("Testing BPE training and encoding...\n");
+
+    char** sentences = make_corpus();
+    BPETokenizer* tokenizer = bpe_train(sentences, BPE_BYTE_TOKENS + 200);
+    assert(tokenizer != NULL);
+    assert(tokenizer->num_merges > 20 && tokenizer->num_merges <= 200);
+    assert(tokenizer->vocab_size == BPE_BYTE_TOKENS + tokenizer->num_merges);
+
+    // The first merge is the most frequent byte pair (smaller pair on ties)
+    static long pair_counts[256][256];
+    for (int i = 0; i < NUM_SENTENCES; i++) {
+        for (const char* p = sentences[i]; p[0] && p[1]; p++) {
+            if (p[0] != ' ' && p[0] != '.' && p[1] != ' ' && p[1] != '.') {
+                pair_counts[(unsigned char)p[0]][(unsigned char)p[1]]++;
+            }
+        }
+    }
+    int best_left = 0, best_right = 0;
+    for (int l = 0; l < 256; l++) {
+        for (int r = 0; r < 256; r++) {
+            if (pair_counts[l][r] > pair_counts[best_left][best_right]) {
+                best_left = l;
+                best_right = r;
+            }
+        }
+    }
+    assert(tokenizer->merges[0].left == (uint32_t)best_left && tokenizer->merges[0].right == (uint32_t)best_right);
+
+    // Training is deterministic
+    BPETokenizer* again = bpe_train(sentences, BPE_BYTE_TOKENS + 200);
+    assert(again->num_merges == tokenizer->num_merges);
+    assert(memcmp(again->merges, tokenizer->merges, tokenizer->num_merges * sizeof(BPEMerge)) == 0);
+    free_bpe_tokenizer(again);
+
+    // Every sentence encodes like the reference and decodes back to its words
+    uint32_t ids[512], expected[512];
+    for (int i = 0; i < NUM_SENTENCES; i++) {
+        long count = bpe_encode(tokenizer, sentences[i], ids, 512);
+        assert(count > 0);
+
+        char decoded[512];
+        size_t decoded_length = 0;
+        for (long t = 0; t < count; t++) {
+            size_t length;
+            const char* bytes = bpe_token_bytes(tokenizer, ids[t], &length);
+            memcpy(decoded + decoded_length, bytes, length);
+            decoded_length += length;
+        }
+
+        char words_only[512];
+        size_t words_length = 0;
+        for (const char* p = sentences[i]; *p; p++) {
+            if (*p != ' ' && *p != '.') words_only[words_length++] = *p;
+        }
+        assert(decoded_length == words_length && memcmp(decoded, words_only, words_length) == 0);
+    }
+
+    // Random words, including bytes never seen in training
+    char word[64];
+    for (int trial = 0; trial < 2000; trial++) {
+        int length = 1 + rand() % 40;
+        for (int c = 0; c < length; c++) word[c] = (rand() % 8 == 0) ? (char)(rand() % 256 | 1) : "theanigrso"[rand() % 10];
+        int got = bpe_encode_word(tokenizer, word, length, ids);
+        int want = reference_encode(tokenizer, word, length, expected);
+        assert(got == want && memcmp(ids, expected, got * sizeof(uint32_t)) == 0);
+    }
+
+    // Output never exceeds the given capacity
+    assert(bpe_encode(tokenizer, "theanthe", ids, 1) == -1);
+    assert(bpe_encode(tokenizer, "", ids, 0) == 0);
+
+    free_bpe_tokenizer(tokenizer);
+    for (int i = 0; i < NUM_SENTENCES; i++) free(sentences[i]);
+    free(sentences);
+    printf("BPE training and encoding test passed\n");
+}
+
+// Test overlapping merges and merges built on merged tokens
+void test_merge_order() {
+    printf("Testing BPE merge order...\n");
+
+    // "aa" first, then "aa"+"a"
+    BPEMerge merges[2] = { {'a', 'a'}, {256, 'a'} };
+    BPETokenizer* tokenizer = create_bpe_tokenizer(merges, 2);
+    assert(tokenizer != NULL);
+
+    uint32_t ids[8];
+    assert(bpe_encode_word(tokenizer, "aaa", 3, ids) == 1 && ids[0] == 257);
+    assert(bpe_encode_word(tokenizer, "aaaa", 4, ids) == 2 && ids[0] == 256 && ids[1] == 256);
+    assert(bpe_encode_word(tokenizer, "aaaaa", 5, ids) == 2 && ids[0] == 256 && ids[1] == 257);
+
+    size_t length;
+    assert(memcmp(bpe_token_bytes(tokenizer, 257, &length), "aaa", 3) == 0 && length == 3);
+    assert(bpe_token_bytes(tokenizer, 258, &length) == NULL);
+    free_bpe_tokenizer(tokenizer);
+
+    // A merge may only use tokens that already exist
+    BPEMerge bad[1] = { {256, 'a'} };
+    assert(create_bpe_tokenizer(bad, 1) == NULL);
+
+    printf("BPE merge order test passed\n");
+}
+
+// Test that merges survive a checkpoint round trip
+void test_checkpoint_round_trip() {
+    printf("Testing BPE checkpoint round trip...\n");
+
+    char** sentences = make_corpus();
+    BPETokenizer* tokenizer = bpe_train(sentences, BPE_BYTE_TOKENS + 50);
+
+    CheckpointTensor tensor;
+    assert(bpe_checkpoint_tensor(tokenizer, "bpe.merges", &tensor));
+    assert(checkpoint_save("test_bpe.ckpt", &tensor, 1));
+    Checkpoint* ckpt = checkpoint_map("test_bpe.ckpt", CHECKPOINT_MAP_VERIFY);
+    BPETokenizer* loaded = create_bpe_tokenizer_from_checkpoint(ckpt, "bpe.merges");
+    assert(loaded != NULL && loaded->num_merges == tokenizer->num_merges);
+
+    uint32_t a[512], b[512];
+    long count = bpe_encode(tokenizer, sentences[0], a, 512);
+    assert(bpe_encode(loaded, sentences[0], b, 512) == count);
+    assert(memcmp(a, b, count * sizeof(uint32_t)) == 0);
+
+    free_bpe_tokenizer(loaded);
+    free_checkpoint(ckpt);
+    free_bpe_tokenizer(tokenizer);
+    remove("test_bpe.ckpt");
+    for (int i = 0; i < NUM_SENTENCES; i++) free(sentences[i]);
+    free(sentences);
+    printf("BPE checkpoint round trip test passed\n");
+}
+
+int main() {
+    printf("Starting BPE tests...\n\n");
+
+    test_merge_order();
+    test_train_and_encode();
+    test_checkpoint_round_trip();
+
+    printf("\nAll BPE tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+#include "../include/checkpoint.h"
+#include "../include/feed_forward_layer.h"
+
+#define TEST_FILE "test_checkpoint.ckpt"
+
+static float matrix[3][5];
+static double vector[7];
+
+// Save two tensors and an empty one to TEST_FILE
+static void write_test_checkpoint(void) {
+    for(int i = 0; i < 3; i++) {
+        for(int j = 0; j < 5; j++) matrix[i][j] = i * 10.0f + j;
+    }
+    for(int i = 0; i < 7; i++) vector[i] = 0.5 * i - 1.0;
+
+    CheckpointTensor tensors[3];
+    long matrix_shape[2] = {3, 5};
+    long vector_shape[1] = {7};
+    long empty_shape[1] = {0};
+    assert(checkpoint_tensor_init(&tensors[0], "layer.matrix", CHECKPOINT_F32, 2, matrix_shape, matrix));
+    assert(checkpoint_tensor_init(&tensors[1], "layer.vector", CHECKPOINT_F64, 1, vector_shape, vector));
+    assert(checkpoint_tensor_init(&tensors[2], "empty", CHECKPOINT_F32, 1, empty_shape, NULL));
+    assert(checkpoint_save(TEST_FILE, tensors, 3));
+}
+
+// Overwrite one byte of TEST_FILE
+static void corrupt_byte(long offset, unsigned char value) {
+    FILE* file = fopen(TEST_FILE, "r+b");
+    assert(file != NULL);
+    fseek(file, offset, SEEK_SET);
+    fputc(value, file);
+    fclose(file);
+}
+
+// Overwrite one field of tensor entry i of TEST_FILE, then fix up the file
+// checksum so that only the structural checks can catch the change
+static void corrupt_entry(int i, size_t field_offset, uint64_t value) {
+    FILE* file = fopen(TEST_FILE, "r+b");
+    assert(file != NULL);
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    unsigned char* image = (unsigned char*)malloc(size);
+    fseek(file, 0, SEEK_SET);
+    assert(fread(image, 1, size, file) == (size_t)size);
+
+    CheckpointHeader header;
+    memcpy(&header, image, sizeof(header));
+    memcpy(image + header.table_offset + i * sizeof(CheckpointEntry) + field_offset, &value, sizeof(value));
+    header.checksum = checkpoint_hash(CHECKPOINT_FNV_SEED, image + header.table_offset, size - header.table_offset);
+    memcpy(image, &header, sizeof(header));
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(image, 1, size, file);
+    fclose(file);
+    free(image);
+}
+
+// Test that tensors survive a save / load round trip, aligned and with their shapes
+void test_round_trip() {
+    printf("Testing checkpoint round trip...\n");
+
+    write_test_checkpoint();
+    Checkpoint* ckpt = checkpoint_load(TEST_FILE);
+    assert(ckpt != NULL);
+    assert(ckpt->version == CHECKPOINT_VERSION && ckpt->num_tensors == 3);
+
+    const CheckpointTensor* m = checkpoint_find(ckpt, "layer.matrix");
+    assert(m != NULL && m->dtype == CHECKPOINT_F32 && m->ndim == 2);
+    assert(m->shape[0] == 3 && m->shape[1] == 5 && m->nbytes == sizeof(matrix));
+    assert(((uintptr_t)m->data % CHECKPOINT_ALIGNMENT) == 0);
+    assert(memcmp(m->data, matrix, sizeof(matrix)) == 0);
+
+    const CheckpointTensor* v = checkpoint_find(ckpt, "layer.vector");
+    assert(v != NULL && v->dtype == CHECKPOINT_F64 && v->shape[0] == 7);
+    assert(((uintptr_t)v->data % CHECKPOINT_ALIGNMENT) == 0);
+
+    assert(checkpoint_find(ckpt, "empty")->nbytes == 0);
+    assert(checkpoint_find(ckpt, "missing") == NULL);
+
+    // Typed reads convert between float and double
+    double as_double[15];
+    float as_float[7];
+    assert(checkpoint_read_f64(ckpt, "layer.matrix", as_double, 15) == 15);
+    assert(as_double[7] == 12.0);
+    assert(checkpoint_read_f32(ckpt, "layer.vector", as_float, 4) == 4);
+    assert(as_float[3] == 0.5f);
+    assert(checkpoint_read_f64(ckpt, "missing", as_double, 15) == -1);
+
+    free_checkpoint(ckpt);
+    printf("Checkpoint round trip test passed\n");
+}
+
+// Test that damaged or foreign files are rejected
+void test_rejects_bad_files() {
+    printf("Testing checkpoint validation...\n");
+
+    assert(checkpoint_load("does_not_exist.ckpt") == NULL);
+
+    // Flipped data byte: checksum mismatch
+    write_test_checkpoint();
+    corrupt_byte(CHECKPOINT_ALIGNMENT * 6 + 3, 0x7f);
+    assert(checkpoint_load(TEST_FILE) == NULL);
+
+    // Unknown version
+    write_test_checkpoint();
+    corrupt_byte(8, 99);
+    assert(checkpoint_load(TEST_FILE) == NULL);
+
+    // Bad magic
+    write_test_checkpoint();
+    corrupt_byte(0, 'X');
+    assert(checkpoint_load(TEST_FILE) == NULL);
+
+    // Shape that does not match the byte count (readers index by shape)
+    write_test_checkpoint();
+    corrupt_entry(0, offsetof(CheckpointEntry, shape), 4);
+    assert(checkpoint_load(TEST_FILE) == NULL);
+    assert(checkpoint_map(TEST_FILE, CHECKPOINT_MAP_DEFAULT) == NULL);
+
+    // Misaligned tensor data
+    write_test_checkpoint();
+    Checkpoint* ckpt = checkpoint_load(TEST_FILE);
+    uint64_t offset = (uint64_t)((const char*)checkpoint_find(ckpt, "layer.vector")->data - (const char*)ckpt->blob);
+    free_checkpoint(ckpt);
+    corrupt_entry(1, offsetof(CheckpointEntry, offset), offset + 4);
+    assert(checkpoint_map(TEST_FILE, CHECKPOINT_MAP_DEFAULT) == NULL);
+
+    // Wrong per-tensor checksum: only verification reads it
+    write_test_checkpoint();
+    corrupt_entry(1, offsetof(CheckpointEntry, checksum), 12345);
+    ckpt = checkpoint_map(TEST_FILE, CHECKPOINT_MAP_DEFAULT);
+    assert(ckpt != NULL);
+    free_checkpoint(ckpt);
+    assert(checkpoint_map(TEST_FILE, CHECKPOINT_MAP_VERIFY) == NULL);
+    assert(checkpoint_load(TEST_FILE) == NULL);
+
+    // Table or data offsets past the end of the file, including ones that wrap around
+    uint64_t bad_offsets[3][2] = {
+        { offsetof(CheckpointHeader, table_offset), 0xFFFFFFFFFFFFFF80ull },
+        { offsetof(CheckpointHeader, data_offset), 0xFFFFFFFFFFFFFF80ull },
+        { offsetof(CheckpointHeader, data_offset), sizeof(CheckpointHeader) },
+    };
+    for(int i = 0; i < 3; i++) {
+        write_test_checkpoint();
+        FILE* header_file = fopen(TEST_FILE, "r+b");
+        assert(header_file != NULL);
+        fseek(header_file, (long)bad_offsets[i][0], SEEK_SET);
+        fwrite(&bad_offsets[i][1], sizeof(uint64_t), 1, header_file);
+        fclose(header_file);
+        assert(checkpoint_map(TEST_FILE, CHECKPOINT_MAP_DEFAULT) == NULL);
+        assert(checkpoint_load(TEST_FILE) == NULL);
+    }
+
+    // Truncated file
+    FILE* file = fopen(TEST_FILE, "wb");
+    fwrite("TFSCKPT", 1, 8, file);
+    fclose(file);
+    assert(checkpoint_load(TEST_FILE) == NULL);
+
+    remove(TEST_FILE);
+    printf("Checkpoint validation test passed\n");
+}
+
+// Test that a mapped checkpoint hands out aligned views without copying
+void test_map() {
+    printf("Testing checkpoint mapping...\n");
+
+    write_test_checkpoint();
+    int flag_sets[3] = {
+        CHECKPOINT_MAP_DEFAULT,
+        CHECKPOINT_MAP_POPULATE | CHECKPOINT_MAP_WILLNEED | CHECKPOINT_MAP_HUGEPAGES | CHECKPOINT_MAP_VERIFY,
+        CHECKPOINT_MAP_SEQUENTIAL
+    };
+    for(int f = 0; f < 3; f++) {
+        Checkpoint* ckpt = checkpoint_map(TEST_FILE, flag_sets[f]);
+        assert(ckpt != NULL && ckpt->mapped && ckpt->num_tensors == 3);
+
+        const float* m = (const float*)checkpoint_view(ckpt, "layer.matrix", CHECKPOINT_F32, 15);
+        assert(m != NULL && ((uintptr_t)m % CHECKPOINT_ALIGNMENT) == 0);
+        assert(memcmp(m, matrix, sizeof(matrix)) == 0);
+        assert(m == checkpoint_find(ckpt, "layer.matrix")->data);
+
+        // Wrong dtype or element count is refused
+        assert(checkpoint_view(ckpt, "layer.matrix", CHECKPOINT_F64, 15) == NULL);
+        assert(checkpoint_view(ckpt, "layer.matrix", CHECKPOINT_F32, 14) == NULL);
+        assert(checkpoint_view(ckpt, "missing", CHECKPOINT_F32, 15) == NULL);
+
+        free_checkpoint(ckpt);
+    }
+
+    // Writable views are copy-on-write: the file keeps its contents
+    Checkpoint* ckpt = checkpoint_map(TEST_FILE, CHECKPOINT_MAP_WRITABLE);
+    assert(ckpt != NULL);
+    double* v = (double*)checkpoint_view(ckpt, "layer.vector", CHECKPOINT_F64, 7);
+    assert(v != NULL && v[2] == 0.0);
+    v[2] = 42.0;
+    free_checkpoint(ckpt);
+    ckpt = checkpoint_map(TEST_FILE, CHECKPOINT_MAP_VERIFY);
+    assert(ckpt != NULL);
+    assert(((const double*)checkpoint_view(ckpt, "layer.vector", CHECKPOINT_F64, 7))[2] == 0.0);
+    free_checkpoint(ckpt);
+
+    // The checksum is only read when asked for
+    ckpt = checkpoint_map(TEST_FILE, CHECKPOINT_MAP_DEFAULT);
+    long data_offset = (long)((const char*)checkpoint_find(ckpt, "layer.vector")->data - (const char*)ckpt->blob);
+    free_checkpoint(ckpt);
+    corrupt_byte(data_offset + 3, 0x7f);
+    ckpt = checkpoint_map(TEST_FILE, CHECKPOINT_MAP_DEFAULT);
+    assert(ckpt != NULL);
+    free_checkpoint(ckpt);
+    assert(checkpoint_map(TEST_FILE, CHECKPOINT_MAP_VERIFY) == NULL);
+    assert(checkpoint_map("does_not_exist.ckpt", CHECKPOINT_MAP_DEFAULT) == NULL);
+
+    remove(TEST_FILE);
+    printf("Checkpoint mapping test passed\n");
+}
+
+// Test that a feed forward layer built on mapped views matches the original
+void test_feed_forward_from_map() {
+    printf("Testing feed forward layer from a mapped checkpoint...\n");
+
+    srand(7);
+    FeedForwardLayer* layer = create_feed_forward_layer(6, 10, 4);
+    assert(layer != NULL);
+
+    CheckpointTensor tensors[4];
+    assert(feed_forward_layer_checkpoint_tensors(layer, "ffn", tensors) == 4);
+    assert(checkpoint_save(TEST_FILE, tensors, 4));
+
+    Checkpoint* ckpt = checkpoint_map(TEST_FILE, CHECKPOINT_MAP_POPULATE);
+    assert(ckpt != NULL);
+    assert(create_feed_forward_layer_from_checkpoint(ckpt, "ffn", 6, 9, 4) == NULL);
+    FeedForwardLayer* mapped = create_feed_forward_layer_from_checkpoint(ckpt, "ffn", 6, 10, 4);
+    assert(mapped != NULL && !mapped->owns_weights);
+    assert(mapped->weights1 == checkpoint_find(ckpt, "ffn.weights1")->data);
+
+    double input[6] = {0.3, -1.0, 0.25, 2.0, -0.5, 0.0};
+    double* expected = feed_forward_forward(layer, input);
+    double* got = feed_forward_forward(mapped, input);
+    assert(expected != NULL && got != NULL);
+    assert(memcmp(expected, got, 4 * sizeof(double)) == 0);
+
+    free(expected);
+    free(got);
+    free_feed_forward_layer(mapped);
+    free_checkpoint(ckpt);
+    free_feed_forward_layer(layer);
+    remove(TEST_FILE);
+    printf("Feed forward from mapped checkpoint test passed\n");
+}
+
+int main() {
+    printf("Starting checkpoint tests...\n\n");
+
+    test_round_trip();
+    test_rejects_bad_files();
+    test_map();
+    test_feed_forward_from_map();
+
+    printf("\nAll checkpoint tests passed successfully!\n");
+    return 0;
+}
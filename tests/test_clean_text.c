@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include "../include/Data_Loading_Cleaning.h"
+
+// The per-byte tolower/isalnum cleaner the table-driven one must match
+static size_t reference_clean(const char* text, size_t length, char* output) {
+    size_t j = 0;
+    int last_was_space = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = tolower((unsigned char)text[i]);
+        if (isalnum((unsigned char)c)) {
+            output[j++] = c;
+            last_was_space = 0;
+        } else if (c == ' ' && !last_was_space) {
+            output[j++] = ' ';
+            last_was_space = 1;
+        }
+    }
+    output[j] = '\0';
+    return j;
+}
+
+// Random text drawn from an alphabet, so blocks are sometimes clean and sometimes not
+static void random_text(char* text, size_t length, const char* alphabet, unsigned int seed) {
+    size_t n = strlen(alphabet);
+    srand(seed);
+    for (size_t i = 0; i < length; i++) text[i] = alphabet[rand() % n];
+    text[length] = '\0';
+}
+
+// Test that the ASCII mode matches the reference on every kind of input, in place or not
+void test_matches_reference() {
+    printf("Testing text cleaner against tolower/isalnum...\n");
+
+    const char* alphabets[] = {
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ",
+        "abcdefghijXYZ09      ",
+        "abcXYZ019 ,.;!?'\"\t\n-()[]@`{~\x7f",
+        "ab \x80\xc3\xa9\xff\x01",
+    };
+    size_t max_length = 3000;
+    char* text = malloc(max_length + 1);
+    char* expected = malloc(max_length + 1);
+    char* output = malloc(max_length + 1);
+
+    for (int a = 0; a < 4; a++) {
+        for (size_t length = 0; length < max_length; length += 1 + length / 8) {
+            random_text(text, length, alphabets[a], (unsigned int)(a * 10000 + length));
+            size_t expected_length = reference_clean(text, length, expected);
+
+            assert(cleanTextBuffer(text, length, output, CLEAN_TEXT_ASCII) == expected_length);
+            assert(memcmp(output, expected, expected_length + 1) == 0);
+            assert(cleanTextInPlace(text, CLEAN_TEXT_ASCII) == expected_length);
+            assert(strcmp(text, expected) == 0);
+        }
+    }
+
+    // Cleaned_Text is built on the same cleaner
+    char* cleaned = Cleaned_Text("  Hello,  WORLD!! 42  times ");
+    assert(strcmp(cleaned, " hello world 42 times ") == 0);
+    free(cleaned);
+
+    free(text);
+    free(expected);
+    free(output);
+    printf("Text cleaner reference test passed\n");
+}
+
+// Test that spaces are collapsed across the 16- and 32-byte block boundaries
+void test_block_boundaries() {
+    printf("Testing text cleaner block boundaries...\n");
+
+    char text[128], expected[128], output[128];
+    for (int split = 1; split < 70; split++) {
+        memset(text, 'A', 100);
+        text[split - 1] = ' ';
+        text[split] = ' ';
+        text[100] = '\0';
+        size_t expected_length = reference_clean(text, 100, expected);
+        assert(cleanTextBuffer(text, 100, output, CLEAN_TEXT_ASCII) == expected_length);
+        assert(strcmp(output, expected) == 0);
+    }
+    printf("Text cleaner block boundaries test passed\n");
+}
+
+// Test the UTF-8 mode: letters kept and lowercased, punctuation and bad bytes dropped
+void test_utf8_mode() {
+    printf("Testing text cleaner UTF-8 mode...\n");
+
+    char text[256];
+    strcpy(text, "Caf\xc3\x89 \xce\x91\xce\xb8\xce\x97NA \xd0\x9c\xd0\xb8\xd1\x80 \xe2\x80\x93 \xe2\x80\x9cQuoted\xe2\x80\x9d "
+                 "\xe6\x97\xa5\xe6\x9c\xac\xe3\x80\x82 \xf0\x9f\x98\x80 bad\xff\xc3(\xc0\xaf\xed\xa0\x80 end");
+    size_t length = cleanTextInPlace(text, CLEAN_TEXT_UTF8);
+
+    const char* expected = "caf\xc3\xa9 \xce\xb1\xce\xb8\xce\xb7na \xd0\xbc\xd0\xb8\xd1\x80 quoted "
+                           "\xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80 bad end";
+    assert(strcmp(text, expected) == 0);
+    assert(length == strlen(expected));
+
+    // The ASCII mode drops every byte >= 0x80
+    strcpy(text, "Caf\xc3\x89 \xe2\x80\x93 ok");
+    cleanTextInPlace(text, CLEAN_TEXT_ASCII);
+    assert(strcmp(text, "caf ok") == 0);
+
+    printf("Text cleaner UTF-8 mode test passed\n");
+}
+
+int main() {
+    printf("Starting text cleaner tests...\n\n");
+
+    test_matches_reference();
+    test_block_boundaries();
+    test_utf8_mode();
+
+    printf("\nAll text cleaner tests passed successfully!\n");
+    return 0;
+}
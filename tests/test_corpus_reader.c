@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../include/Data_Loading_Cleaning.h"
+
+#define TEST_FILE "test_corpus_reader.txt"
+
+static void write_file(const char* text) {
+    FILE* file = fopen(TEST_FILE, "wb");
+    assert(file != NULL);
+    fwrite(text, 1, strlen(text), file);
+    fclose(file);
+}
+
+// Stream the file and check every sentence against strtok on the whole text,
+// which is how SplitSentences splits (without its sentence limit)
+static void check_against_split(const char* text, size_t chunk_size) {
+    write_file(text);
+    char* copy = strdup(text);
+    char** expected = malloc((strlen(text) + 1) * sizeof(char*));
+    int num_expected = 0;
+    for (char* token = strtok(copy, ".!?"); token != NULL; token = strtok(NULL, ".!?")) {
+        expected[num_expected++] = token;
+    }
+    expected[num_expected] = NULL;
+
+    CorpusReader* reader = openCorpusReader(TEST_FILE, chunk_size);
+    assert(reader != NULL);
+
+    int count = 0;
+    size_t length = 0;
+    char* sentence;
+    while ((sentence = nextCorpusSentence(reader, &length)) != NULL) {
+        assert(expected[count] != NULL);
+        assert(strcmp(sentence, expected[count]) == 0);
+        assert(length == strlen(expected[count]));
+        count++;
+    }
+    assert(expected[count] == NULL);
+    assert(!reader->error && reader->bytes_read == strlen(text));
+    assert(nextCorpusSentence(reader, NULL) == NULL);
+
+    closeCorpusReader(reader);
+    free(expected);
+    free(copy);
+}
+
+// Test sentences that straddle chunk boundaries, with every small chunk size
+void test_chunk_boundaries() {
+    printf("Testing corpus reader chunk boundaries...\n");
+
+    const char* text = "The cat sat. A dog barked!! Did it? Yes... it did. no final delimiter";
+    for (size_t chunk = 1; chunk <= strlen(text) + 1; chunk++) {
+        check_against_split(text, chunk);
+    }
+    check_against_split(text, 0);
+    check_against_split("ends with a delimiter.", 4);
+    check_against_split("...!?", 2);
+    check_against_split("", 8);
+
+    printf("Corpus reader chunk boundaries test passed\n");
+}
+
+// Test a sentence many times longer than the chunk, and a long generated corpus
+void test_long_input() {
+    printf("Testing corpus reader on long input...\n");
+
+    size_t size = 200000;
+    char* text = malloc(size + 1);
+    srand(3);
+    for (size_t i = 0; i < size; i++) {
+        int r = rand() % 100;
+        text[i] = (r < 2) ? ".!?"[r % 3] : (r < 20) ? ' ' : (char)('a' + r % 26);
+    }
+    memset(text + 1000, 'x', 50000);  // One sentence of 50,000 bytes
+    text[size] = '\0';
+
+    check_against_split(text, 4096);
+    check_against_split(text, 0);
+
+    free(text);
+    printf("Corpus reader long input test passed\n");
+}
+
+void test_missing_file() {
+    printf("Testing corpus reader on a missing file...\n");
+    assert(openCorpusReader("no_such_corpus.txt", 0) == NULL);
+    assert(nextCorpusSentence(NULL, NULL) == NULL);
+    closeCorpusReader(NULL);
+    printf("Corpus reader missing file test passed\n");
+}
+
+int main() {
+    printf("Starting corpus reader tests...\n\n");
+
+    test_chunk_boundaries();
+    test_long_input();
+    test_missing_file();
+
+    remove(TEST_FILE);
+    printf("\nAll corpus reader tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../include/dataset.h"
+
+#define TEST_FILE "test_dataset.bin"
+
+// Build a corpus of num_sentences sentences whose ids are i * stride (mod limit)
+static TokenizedCorpus* make_corpus(size_t num_sentences, uint32_t stride, uint32_t limit) {
+    TokenizedCorpus* corpus = createTokenizedCorpus();
+    size_t next = 0;
+    corpus->num_ids = 0;
+    for (size_t s = 0; s < num_sentences; s++) {
+        size_t length = (s * 7) % 13;  // Some sentences are empty
+        while (corpus->num_ids + length > corpus->ids_capacity) {
+            corpus->ids_capacity *= 2;
+            corpus->ids = realloc(corpus->ids, corpus->ids_capacity * sizeof(uint32_t));
+        }
+        if (corpus->num_sentences == corpus->sentences_capacity) {
+            corpus->sentences_capacity *= 2;
+            corpus->sentence_starts = realloc(corpus->sentence_starts, (corpus->sentences_capacity + 1) * sizeof(size_t));
+        }
+        for (size_t i = 0; i < length; i++) corpus->ids[corpus->num_ids++] = (uint32_t)((next++ * stride) % limit);
+        corpus->sentence_starts[++corpus->num_sentences] = corpus->num_ids;
+    }
+    return corpus;
+}
+
+// Check every sentence of a mapped dataset against the corpus it was written from
+static void check_dataset(const TokenDataset* dataset, const TokenizedCorpus* corpus) {
+    int row[16];
+    assert(dataset->num_sentences == corpus->num_sentences && dataset->num_ids == corpus->num_ids);
+    for (size_t s = 0; s < corpus->num_sentences; s++) {
+        size_t length = corpus->sentence_starts[s + 1] - corpus->sentence_starts[s];
+        assert(token_dataset_sentence_length(dataset, s) == length);
+        assert(token_dataset_copy_sentence(dataset, s, row, 16) == length);
+        for (size_t i = 0; i < 16; i++) {
+            int expected = (i < length) ? (int)corpus->ids[corpus->sentence_starts[s] + i] : 0;
+            assert(row[i] == expected);
+        }
+    }
+}
+
+// Test narrow (U16) and wide (U32) ids, chosen by the vocabulary size
+void test_round_trip() {
+    printf("Testing dataset round trip...\n");
+
+    TokenizedCorpus* corpus = make_corpus(1000, 37, 5000);
+    assert(save_token_dataset(TEST_FILE, corpus, 5000));
+    TokenDataset* dataset = load_token_dataset(TEST_FILE, 5000);
+    assert(dataset != NULL && dataset->id_type == CHECKPOINT_U16 && dataset->vocab_size == 5000);
+    check_dataset(dataset, corpus);
+    free_token_dataset(dataset);
+    freeTokenizedCorpus(corpus);
+
+    corpus = make_corpus(500, 104729, 200000);
+    assert(save_token_dataset(TEST_FILE, corpus, 200000));
+    dataset = load_token_dataset(TEST_FILE, 0);
+    assert(dataset != NULL && dataset->id_type == CHECKPOINT_U32);
+    check_dataset(dataset, corpus);
+
+    // Rows shorter than a sentence are truncated
+    int row[2];
+    size_t longest = 0;
+    while (token_dataset_sentence_length(dataset, longest) < 3) longest++;
+    assert(token_dataset_copy_sentence(dataset, longest, row, 2) == 2);
+    assert(token_dataset_sentence_length(dataset, dataset->num_sentences) == 0);
+
+    free_token_dataset(dataset);
+    freeTokenizedCorpus(corpus);
+    printf("Dataset round trip test passed\n");
+}
+
+// Test that a corpus packed in memory reads back like the corpus and the file
+void test_packed_views() {
+    printf("Testing packed dataset views...\n");
+
+    TokenizedCorpus* corpus = make_corpus(300, 11, 70000);
+    TokenDataset* packed = token_dataset_from_corpus(corpus, 70000);
+    assert(packed != NULL && packed->checkpoint == NULL && packed->id_type == CHECKPOINT_U32);
+    check_dataset(packed, corpus);
+
+    for (size_t s = 0; s < corpus->num_sentences; s++) {
+        TokenSequence sequence = token_dataset_sequence(packed, s);
+        assert(sequence.length == corpus->sentence_starts[s + 1] - corpus->sentence_starts[s]);
+        for (size_t i = 0; i < sequence.length; i++) {
+            assert(token_sequence_id(&sequence, i) == corpus->ids[corpus->sentence_starts[s] + i]);
+        }
+    }
+    assert(token_dataset_sequence(packed, corpus->num_sentences).length == 0);
+
+    // A packed dataset writes the same file as the corpus it came from
+    assert(write_token_dataset(TEST_FILE, packed));
+    TokenDataset* mapped = load_token_dataset(TEST_FILE, 70000);
+    assert(mapped != NULL);
+    check_dataset(mapped, corpus);
+    free_token_dataset(mapped);
+    free_token_dataset(packed);
+    freeTokenizedCorpus(corpus);
+
+    // Gathering from a view matches gatherEmbeddings on the zero-padded row
+    const char* text = "the cat sat on the mat. a dog ran far away from the cat.";
+    corpus = createTokenizedCorpus();
+    assert(tokenizeText(corpus, text, strlen(text), TOKENIZE_ADD_WORDS));
+    packed = token_dataset_from_corpus(corpus, (uint32_t)global_token);
+    assert(packed != NULL && packed->id_type == CHECKPOINT_U16);
+
+    int row[8];
+    float expected[8 * TOKEN_EMBEDDING_DIM], actual[8 * TOKEN_EMBEDDING_DIM];
+    for (size_t s = 0; s < packed->num_sentences; s++) {
+        TokenSequence sequence = token_dataset_sequence(packed, s);
+        for (size_t count = 0; count <= sequence.length; count++) {
+            token_dataset_copy_sentence(packed, s, row, 8);
+            for (size_t i = count; i < 8; i++) row[i] = 0;
+            gatherEmbeddings(row, 8, expected);
+            memset(actual, 0xff, sizeof(actual));
+            token_sequence_gather_embeddings(&sequence, count, 8, actual);
+            assert(memcmp(expected, actual, sizeof(actual)) == 0);
+        }
+    }
+
+    free_token_dataset(packed);
+    freeTokenizedCorpus(corpus);
+    freeVocabulary();
+    freeEmbeddingTable();
+    printf("Packed dataset views test passed\n");
+}
+
+// Test that every epoch covers each sentence once, in batches of similar length
+void test_batch_sampler() {
+    printf("Testing length-bucketed batch sampler...\n");
+
+    TokenizedCorpus* corpus = make_corpus(1003, 5, 1000);
+    TokenDataset* dataset = token_dataset_from_corpus(corpus, 1000);
+    assert(dataset != NULL);
+    assert(create_token_batch_sampler(dataset, 0, 8, 1) == NULL);
+
+    TokenBatchSampler* sampler = create_token_batch_sampler(dataset, 16, 8, 1);
+    TokenBatchSampler* same_seed = create_token_batch_sampler(dataset, 16, 8, 1);
+    assert(sampler != NULL && same_seed != NULL && sampler->num_batches == 63);
+
+    unsigned char* seen = (unsigned char*)malloc(dataset->num_sentences);
+    size_t first_epoch[16];
+    for (int epoch = 0; epoch < 3; epoch++) {
+        memset(seen, 0, dataset->num_sentences);
+        size_t total = 0;
+        for (size_t b = 0; b < sampler->num_batches; b++) {
+            const size_t* sentences;
+            size_t longest;
+            size_t count = token_batch_sampler_batch(sampler, b, &sentences, &longest);
+            assert(count == 16 || count == 1003 % 16);
+            assert(sentences == sampler->order + sampler->batch_starts[b]);
+
+            // The batch is padded to its longest sentence, clamped to max_length
+            size_t max_seen = 0, min_seen = 8;
+            for (size_t i = 0; i < count; i++) {
+                size_t length = token_dataset_sentence_length(dataset, sentences[i]);
+                if (length > 8) length = 8;
+                if (length > max_seen) max_seen = length;
+                if (length < min_seen) min_seen = length;
+                assert(!seen[sentences[i]]);
+                seen[sentences[i]] = 1;
+            }
+            assert(longest == max_seen && max_seen - min_seen <= 1);
+            total += count;
+        }
+        assert(total == dataset->num_sentences);
+
+        // Batches are drawn again each epoch, the same way for the same seed
+        const size_t* sentences;
+        token_batch_sampler_batch(sampler, 0, &sentences, NULL);
+        if (epoch == 0) memcpy(first_epoch, sentences, sizeof(first_epoch));
+        const size_t* other;
+        token_batch_sampler_batch(same_seed, 0, &other, NULL);
+        assert(memcmp(sentences, other, 16 * sizeof(size_t)) == 0);
+        if (epoch > 0) assert(memcmp(sentences, first_epoch, sizeof(first_epoch)) != 0);
+
+        token_batch_sampler_next_epoch(sampler);
+        token_batch_sampler_next_epoch(same_seed);
+    }
+    const size_t* none;
+    assert(token_batch_sampler_batch(sampler, sampler->num_batches, &none, NULL) == 0);
+
+    free(seen);
+    free_token_batch_sampler(sampler);
+    free_token_batch_sampler(same_seed);
+    free_token_dataset(dataset);
+    freeTokenizedCorpus(corpus);
+    printf("Length-bucketed batch sampler test passed\n");
+}
+
+// Test that a dataset made with another vocabulary, or a file that is not one, is rejected
+void test_rejects_mismatch() {
+    printf("Testing dataset validation...\n");
+
+    TokenizedCorpus* corpus = make_corpus(10, 3, 100);
+    assert(save_token_dataset(TEST_FILE, corpus, 100));
+    assert(load_token_dataset(TEST_FILE, 101) == NULL);
+    assert(load_token_dataset("no_such_dataset.bin", 0) == NULL);
+
+    uint32_t values[3] = {1, 2, 3};
+    long shape[1] = {3};
+    CheckpointTensor tensor;
+    assert(checkpoint_tensor_init(&tensor, "dataset.ids", CHECKPOINT_U32, 1, shape, values));
+    assert(checkpoint_save(TEST_FILE, &tensor, 1));
+    assert(load_token_dataset(TEST_FILE, 0) == NULL);
+
+    freeTokenizedCorpus(corpus);
+    printf("Dataset validation test passed\n");
+}
+
+int main() {
+    printf("Starting dataset tests...\n\n");
+
+    test_round_trip();
+    test_packed_views();
+    test_batch_sampler();
+    test_rejects_mismatch();
+
+    remove(TEST_FILE);
+    printf("\nAll dataset tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "../include/attention.h"
+#include "../include/gemm.h"
+
+// Naive reference with the full score matrix
+static void reference_attention(int seq_q, int seq_k, int dim, float scale,
+                                const float *Q, int ldq, const float *K, int ldk,
+                                const float *V, int ldv, double *O, int causal) {
+    double* scores = malloc(seq_k * sizeof(double));
+    for(int i = 0; i < seq_q; i++) {
+        int limit = causal ? i + (seq_k - seq_q) + 1 : seq_k;
+        if(limit > seq_k) limit = seq_k;
+        double max_score = -1e300, total = 0.0;
+        for(int j = 0; j < limit; j++) {
+            double sum = 0.0;
+            for(int k = 0; k < dim; k++) sum += (double)Q[i * ldq + k] * K[j * ldk + k];
+            scores[j] = sum * scale;
+            if(scores[j] > max_score) max_score = scores[j];
+        }
+        for(int j = 0; j < limit; j++) {
+            scores[j] = exp(scores[j] - max_score);
+            total += scores[j];
+        }
+        for(int k = 0; k < dim; k++) {
+            double acc = 0.0;
+            for(int j = 0; j < limit; j++) acc += scores[j] / total * V[j * ldv + k];
+            O[i * dim + k] = acc;
+        }
+    }
+    free(scores);
+}
+
+static float* random_matrix(int count, float range) {
+    float* m = malloc(count * sizeof(float));
+    for(int i = 0; i < count; i++) {
+        m[i] = (((float)rand() / (float)RAND_MAX) - 0.5f) * range;
+    }
+    return m;
+}
+
+// Compare flash_attention_f32 against the reference for one shape
+static void check_attention(int seq_q, int seq_k, int dim, float range, int causal) {
+    int ld = dim + 3;  // Strided rows, as with slices of a fused QKV buffer
+    float* Q = random_matrix(seq_q * ld, range);
+    float* K = random_matrix(seq_k * ld, range);
+    float* V = random_matrix(seq_k * ld, 1.0f);
+    float* O = malloc(seq_q * (dim + 1) * sizeof(float));
+    double* expected = malloc(seq_q * dim * sizeof(double));
+    float scale = 1.0f / sqrtf((float)dim);
+
+    flash_attention_f32(seq_q, seq_k, dim, scale, Q, ld, K, ld, V, ld, O, dim + 1, causal);
+    reference_attention(seq_q, seq_k, dim, scale, Q, ld, K, ld, V, ld, expected, causal);
+
+    for(int i = 0; i < seq_q; i++) {
+        for(int k = 0; k < dim; k++) {
+            assert(!isnan(O[i * (dim + 1) + k]));
+            assert(fabs(O[i * (dim + 1) + k] - expected[i * dim + k]) < 1e-4);
+        }
+    }
+
+    free(Q);
+    free(K);
+    free(V);
+    free(O);
+    free(expected);
+}
+
+// Test shapes that are smaller than, equal to and span several tiles
+void test_flash_attention_shapes() {
+    printf("Testing flash_attention_f32 shapes...\n");
+
+    int shapes[][3] = {
+        {1, 1, 1}, {5, 7, 16}, {64, 128, 32}, {65, 129, 24},
+        {200, 300, 64}, {1, 517, 64}, {130, 130, 8}
+    };
+    int num_shapes = sizeof(shapes) / sizeof(shapes[0]);
+
+    for(int s = 0; s < num_shapes; s++) {
+        check_attention(shapes[s][0], shapes[s][1], shapes[s][2], 1.0f, 0);
+    }
+
+    printf("flash_attention_f32 shapes test passed\n");
+}
+
+// Test the causal mask, including queries aligned to the end of a longer key sequence
+void test_flash_attention_causal() {
+    printf("Testing flash_attention_f32 causal mask...\n");
+
+    check_attention(7, 7, 16, 1.0f, 1);
+    check_attention(300, 300, 32, 1.0f, 1);
+    check_attention(1, 400, 32, 1.0f, 1);
+    check_attention(70, 260, 16, 1.0f, 1);
+
+    printf("flash_attention_f32 causal test passed\n");
+}
+
+// Test that large logits, where the running max keeps moving, stay stable
+void test_flash_attention_large_scores() {
+    printf("Testing flash_attention_f32 with large scores...\n");
+
+    check_attention(90, 400, 32, 12.0f, 0);
+    check_attention(90, 400, 32, 12.0f, 1);
+
+    printf("flash_attention_f32 large scores test passed\n");
+}
+
+// Test that splitting query blocks across workers gives the same result
+void test_flash_attention_threads() {
+    printf("Testing flash_attention_f32 with a worker team...\n");
+
+    gemm_set_num_threads(3);
+    check_attention(333, 333, 32, 1.0f, 0);
+    check_attention(333, 333, 32, 1.0f, 1);
+    gemm_set_num_threads(0);
+
+    printf("flash_attention_f32 worker team test passed\n");
+}
+
+int main() {
+    printf("Starting flash attention tests...\n\n");
+
+    srand(42);
+
+    test_flash_attention_shapes();
+    test_flash_attention_causal();
+    test_flash_attention_large_scores();
+    test_flash_attention_threads();
+
+    printf("\nAll flash attention tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "../include/gemm.h"
+#include "../include/utils.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Naive reference: C = alpha * op(A) * op(B) + beta * C
+static void reference_gemm(int trans_a, int trans_b, int M, int N, int K,
+                           float alpha, const float *A, int lda, const float *B, int ldb,
+                           float beta, float *C, int ldc) {
+    for(int i = 0; i < M; i++) {
+        for(int j = 0; j < N; j++) {
+            double sum = 0.0;
+            for(int k = 0; k < K; k++) {
+                double a = trans_a ? A[k * lda + i] : A[i * lda + k];
+                double b = trans_b ? B[j * ldb + k] : B[k * ldb + j];
+                sum += a * b;
+            }
+            C[i * ldc + j] = (float)(alpha * sum + beta * C[i * ldc + j]);
+        }
+    }
+}
+
+static float* random_matrix(int count) {
+    float* m = (float*)malloc(count * sizeof(float));
+    for(int i = 0; i < count; i++) {
+        m[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    }
+    return m;
+}
+
+// Compare gemm_f32 against the reference for one shape / flag combination
+static void check_gemm(int trans_a, int trans_b, int M, int N, int K, float alpha, float beta) {
+    int lda = (trans_a ? M : K) + 3;
+    int ldb = (trans_b ? K : N) + 5;
+    int ldc = N + 2;
+    float* A = random_matrix((trans_a ? K : M) * lda);
+    float* B = random_matrix((trans_b ? N : K) * ldb);
+    float* C = random_matrix(M * ldc);
+    float* C_ref = (float*)malloc(M * ldc * sizeof(float));
+    for(int i = 0; i < M * ldc; i++) C_ref[i] = C[i];
+
+    gemm_f32(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    reference_gemm(trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C_ref, ldc);
+
+    for(int i = 0; i < M; i++) {
+        for(int j = 0; j < N; j++) {
+            assert(fabsf(C[i * ldc + j] - C_ref[i * ldc + j]) < 1e-3f * (1.0f + sqrtf((float)K)));
+        }
+        // Padding columns past N must be untouched
+        for(int j = N; j < ldc; j++) {
+            assert(C[i * ldc + j] == C_ref[i * ldc + j]);
+        }
+    }
+
+    free(A);
+    free(B);
+    free(C);
+    free(C_ref);
+}
+
+// Test all transpose combinations over shapes that hit every edge case of the blocking
+void test_gemm_shapes() {
+    printf("Testing gemm_f32 shapes and transposes...\n");
+
+    int shapes[][3] = {
+        {1, 1, 1}, {2, 2, 2}, {7, 17, 5}, {13, 33, 300},
+        {150, 40, 64}, {128, 512, 512}, {5, 4100, 9}, {300, 20, 530},
+        {1, 1536, 512}, {1, 70, 300}
+    };
+    int num_shapes = sizeof(shapes) / sizeof(shapes[0]);
+
+    for(int s = 0; s < num_shapes; s++) {
+        for(int ta = 0; ta < 2; ta++) {
+            for(int tb = 0; tb < 2; tb++) {
+                check_gemm(ta, tb, shapes[s][0], shapes[s][1], shapes[s][2], 1.0f, 0.0f);
+            }
+        }
+    }
+
+    printf("gemm_f32 shapes test passed\n");
+}
+
+// Test alpha / beta accumulation
+void test_gemm_alpha_beta() {
+    printf("Testing gemm_f32 alpha and beta...\n");
+
+    check_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 70, 90, 260, 0.5f, 1.0f);
+    check_gemm(GEMM_TRANS, GEMM_NO_TRANS, 70, 90, 260, -2.0f, 0.25f);
+    check_gemm(GEMM_NO_TRANS, GEMM_TRANS, 3, 3, 3, 1.5f, -1.0f);
+    check_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 20, 20, 20, 0.0f, 2.0f);
+
+    printf("gemm_f32 alpha/beta test passed\n");
+}
+
+// Test that splitting a product across several workers gives the same result
+void test_gemm_threads() {
+    printf("Testing gemm_f32 with a worker team...\n");
+
+    gemm_set_num_threads(3);
+    check_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 128, 2048, 512, 1.0f, 0.0f);
+    check_gemm(GEMM_NO_TRANS, GEMM_TRANS, 300, 70, 260, 1.0f, 1.0f);
+    check_gemm(GEMM_TRANS, GEMM_NO_TRANS, 7, 600, 90, -1.0f, 0.5f);
+    gemm_set_num_threads(0);
+
+    printf("gemm_f32 worker team test passed\n");
+}
+
+// Test that a team smaller than requested still computes every tile
+void test_gemm_smaller_team() {
+    printf("Testing gemm_f32 when OpenMP grants fewer workers...\n");
+
+#ifdef _OPENMP
+    // With dynamic adjustment on, OpenMP grants at most about one thread per
+    // available processor, far fewer than this request
+    int dynamic = omp_get_dynamic();
+    int requested = omp_get_num_procs() * 4 + 3;
+    omp_set_dynamic(1);
+    gemm_set_num_threads(requested);
+
+    int granted = 0;
+    #pragma omp parallel num_threads(requested)
+    {
+        #pragma omp single
+        granted = omp_get_num_threads();
+    }
+    printf("  OpenMP granted %d of %d workers\n", granted, requested);
+
+    check_gemm(GEMM_NO_TRANS, GEMM_NO_TRANS, 128, 2048, 512, 1.0f, 0.0f);
+    check_gemm(GEMM_NO_TRANS, GEMM_TRANS, 300, 70, 260, 1.0f, 1.0f);
+    check_gemm(GEMM_TRANS, GEMM_NO_TRANS, 7, 600, 90, -1.0f, 0.5f);
+    gemm_set_num_threads(0);
+    omp_set_dynamic(dynamic);
+#endif
+
+    printf("gemm_f32 smaller team test passed\n");
+}
+
+// Test that matrix_multiply_float still computes a plain product
+void test_matrix_multiply_float() {
+    printf("Testing matrix_multiply_float...\n");
+
+    float A[2 * 3] = {1, 2, 3, 4, 5, 6};
+    float B[3 * 2] = {7, 8, 9, 10, 11, 12};
+    float C[2 * 2] = {-1, -1, -1, -1};
+
+    matrix_multiply_float(A, B, C, 2, 3, 2);
+
+    assert(fabsf(C[0] - 58.0f) < 1e-5f);
+    assert(fabsf(C[1] - 64.0f) < 1e-5f);
+    assert(fabsf(C[2] - 139.0f) < 1e-5f);
+    assert(fabsf(C[3] - 154.0f) < 1e-5f);
+
+    printf("matrix_multiply_float test passed\n");
+}
+
+int main() {
+    printf("Starting GEMM tests...\n\n");
+
+    srand(42);
+
+    test_gemm_shapes();
+    test_gemm_alpha_beta();
+    test_gemm_threads();
+    test_gemm_smaller_team();
+    test_matrix_multiply_float();
+
+    printf("\nAll GEMM tests passed successfully!\n");
+    return 0;
+}
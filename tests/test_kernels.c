@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "../include/kernels.h"
+#include "../include/gemm.h"
+
+#define N_ELEMS 131  // Odd length so every vector tail path is exercised
+
+static float data_a[N_ELEMS];
+static float data_b[N_ELEMS];
+
+static int close_enough(float got, float expected, float tolerance) {
+    return fabsf(got - expected) <= tolerance * (1.0f + fabsf(expected));
+}
+
+// Test the vector primitives of the active table against plain loops
+void test_primitives(const KernelTable* kt) {
+    double dot = 0.0, sum = 0.0;
+    float max_val = data_a[0];
+    for(int i = 0; i < N_ELEMS; i++) {
+        dot += (double)data_a[i] * data_b[i];
+        sum += data_a[i];
+        if(data_a[i] > max_val) max_val = data_a[i];
+    }
+
+    for(int n = 1; n <= N_ELEMS; n += 13) {
+        double partial = 0.0;
+        for(int i = 0; i < n; i++) partial += (double)data_a[i] * data_b[i];
+        assert(close_enough(kt->dot(data_a, data_b, n), (float)partial, 1e-4f));
+    }
+    assert(close_enough(kt->dot(data_a, data_b, N_ELEMS), (float)dot, 1e-4f));
+    assert(close_enough(kt->row_sum(data_a, N_ELEMS), (float)sum, 1e-4f));
+    assert(kt->row_max(data_a, N_ELEMS) == max_val);
+
+    float y[N_ELEMS];
+    for(int i = 0; i < N_ELEMS; i++) y[i] = data_b[i];
+    kt->axpy(N_ELEMS, 0.5f, data_a, y);
+    for(int i = 0; i < N_ELEMS; i++) assert(close_enough(y[i], data_b[i] + 0.5f * data_a[i], 1e-6f));
+
+    kt->scale(N_ELEMS, -2.0f, y);
+    for(int i = 0; i < N_ELEMS; i++) assert(close_enough(y[i], -2.0f * (data_b[i] + 0.5f * data_a[i]), 1e-6f));
+
+    // exp over a wide range, including values that underflow to zero
+    float x[N_ELEMS];
+    for(int i = 0; i < N_ELEMS; i++) x[i] = -100.0f + i * 1.4f;
+    kt->vexp(x, 50.0f, y, N_ELEMS);
+    for(int i = 0; i < N_ELEMS; i++) {
+        float expected = expf(x[i] - 50.0f);
+        assert(close_enough(y[i], expected, 1e-5f) || (expected < 1e-37f && y[i] < 1e-37f));
+    }
+}
+
+// Test the micro-kernel through gemm_f32 against a naive product
+void test_gemm(void) {
+    int M = 37, N = 70, K = 300;
+    float* A = malloc(M * K * sizeof(float));
+    float* B = malloc(K * N * sizeof(float));
+    float* C = malloc(M * N * sizeof(float));
+    for(int i = 0; i < M * K; i++) A[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    for(int i = 0; i < K * N; i++) B[i] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+    for(int i = 0; i < M * N; i++) C[i] = 1.0f;
+
+    gemm_f32(GEMM_NO_TRANS, GEMM_NO_TRANS, M, N, K, 2.0f, A, K, B, N, 0.5f, C, N);
+
+    for(int i = 0; i < M; i++) {
+        for(int j = 0; j < N; j++) {
+            double expected = 0.0;
+            for(int k = 0; k < K; k++) expected += (double)A[i * K + k] * B[k * N + j];
+            expected = 2.0 * expected + 0.5;
+            assert(fabs(C[i * N + j] - expected) < 1e-3);
+        }
+    }
+
+    free(A);
+    free(B);
+    free(C);
+}
+
+int main() {
+    printf("Starting kernel dispatch tests...\n\n");
+
+    srand(42);
+    for(int i = 0; i < N_ELEMS; i++) {
+        data_a[i] = ((float)rand() / (float)RAND_MAX) * 4.0f - 2.0f;
+        data_b[i] = ((float)rand() / (float)RAND_MAX) * 4.0f - 2.0f;
+    }
+
+    printf("Auto-selected kernels: %s\n\n", kernels()->name);
+
+    assert(kernels_isa_from_name("avx2") == KERNEL_ISA_AVX2);
+    assert(kernels_isa_from_name("bogus") == KERNEL_ISA_COUNT);
+    assert(kernels_isa_supported(KERNEL_ISA_SCALAR));
+
+    for(int isa = 0; isa < KERNEL_ISA_COUNT; isa++) {
+        if(!kernels_force_isa((KernelIsa)isa)) {
+            continue;
+        }
+        const KernelTable* kt = kernels();
+        assert(kt->isa == (KernelIsa)isa);
+        printf("Testing %s kernels...\n", kt->name);
+        test_primitives(kt);
+        test_gemm();
+        printf("%s kernels test passed\n", kt->name);
+    }
+
+    printf("\nAll kernel dispatch tests passed successfully!\n");
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "../include/self_attention_layer.h"
+#include "../include/kv_cache.h"
+
+#define DIM 32
+#define NUM_TOKENS 12
+
+static float tokens[NUM_TOKENS][DIM];
+
+// Non-causal attention over tokens [first, last] of the sequence; its last row is
+// what a causal pass (or a decode step) must produce for token `last`
+static void reference_last_row(SelfAttentionLayer* layer, int first, int last, float* expected) {
+    int len = last - first + 1;
+    float* out = malloc(len * DIM * sizeof(float));
+    self_attention_forward(layer, &tokens[first][0], out, len);
+    for(int j = 0; j < DIM; j++) expected[j] = out[(len - 1) * DIM + j];
+    free(out);
+}
+
+static void assert_row_close(const float* got, const float* expected) {
+    for(int j = 0; j < DIM; j++) {
+        assert(!isnan(got[j]));
+        assert(fabsf(got[j] - expected[j]) < 1e-4f);
+    }
+}
+
+// Test ring bookkeeping and head-major storage
+void test_kv_cache_ring() {
+    printf("Testing kv_cache ring layout...\n");
+
+    assert(create_kv_cache(0, 4, 4) == NULL);
+
+    KVCache* cache = create_kv_cache(2, 3, 3);
+    assert(cache != NULL);
+
+    float key[6], value[6];
+    for(int t = 0; t < 5; t++) {
+        for(int i = 0; i < 6; i++) {
+            key[i] = t * 10 + i;
+            value[i] = -(t * 10 + i);
+        }
+        int slot = kv_cache_append(cache, key, value);
+        assert(slot == t % 3);
+    }
+    assert(cache->length == 3 && cache->next == 2 && cache->position == 5);
+
+    // Token 4 overwrote slot 1: head 1 holds its second half
+    assert(kv_cache_keys(cache, 1)[1 * 3 + 0] == 43.0f);
+    assert(kv_cache_values(cache, 0)[1 * 3 + 2] == -42.0f);
+    // Token 2 is still in slot 2
+    assert(kv_cache_keys(cache, 0)[2 * 3 + 1] == 21.0f);
+
+    kv_cache_reset(cache);
+    assert(cache->length == 0 && cache->next == 0 && cache->position == 0);
+    free_kv_cache(cache);
+
+    printf("kv_cache ring test passed\n");
+}
+
+// Test that decoding token by token matches recomputing attention over the prefix
+void test_decode_matches_recompute(int num_heads) {
+    printf("Testing decode steps with %d head(s)...\n", num_heads);
+
+    SelfAttentionLayer* layer = create_multi_head_attention_layer(DIM, num_heads, NUM_TOKENS);
+    KVCache* cache = create_kv_cache_for_layer(layer, NUM_TOKENS);
+    assert(layer != NULL && cache != NULL);
+
+    float got[DIM], expected[DIM];
+    for(int t = 0; t < NUM_TOKENS; t++) {
+        self_attention_decode_step(layer, cache, tokens[t], got);
+        reference_last_row(layer, 0, t, expected);
+        assert_row_close(got, expected);
+    }
+    assert(cache->length == NUM_TOKENS);
+
+    free_kv_cache(cache);
+    free_self_attention_layer(layer);
+
+    printf("Decode test with %d head(s) passed\n", num_heads);
+}
+
+// Test a causal prefill followed by decode steps
+void test_prefill_then_decode() {
+    printf("Testing prefill followed by decode...\n");
+
+    SelfAttentionLayer* layer = create_multi_head_attention_layer(DIM, 4, NUM_TOKENS);
+    KVCache* cache = create_kv_cache_for_layer(layer, NUM_TOKENS);
+    assert(layer != NULL && cache != NULL);
+
+    int prompt = 5;
+    float prefill_out[5][DIM], got[DIM], expected[DIM];
+    self_attention_prefill(layer, cache, &tokens[0][0], &prefill_out[0][0], prompt);
+    assert(cache->length == prompt);
+    for(int i = 0; i < prompt; i++) {
+        reference_last_row(layer, 0, i, expected);
+        assert_row_close(prefill_out[i], expected);
+    }
+
+    // A second chunk attends to the cached prompt as well
+    self_attention_prefill(layer, cache, &tokens[prompt][0], &prefill_out[0][0], 3);
+    for(int i = 0; i < 3; i++) {
+        reference_last_row(layer, 0, prompt + i, expected);
+        assert_row_close(prefill_out[i], expected);
+    }
+
+    for(int t = prompt + 3; t < NUM_TOKENS; t++) {
+        self_attention_decode_step(layer, cache, tokens[t], got);
+        reference_last_row(layer, 0, t, expected);
+        assert_row_close(got, expected);
+    }
+
+    free_kv_cache(cache);
+    free_self_attention_layer(layer);
+
+    printf("Prefill and decode test passed\n");
+}
+
+// Test that a full ring attends over a sliding window of the latest tokens
+void test_sliding_window() {
+    printf("Testing sliding window decode...\n");
+
+    int window = 4;
+    SelfAttentionLayer* layer = create_multi_head_attention_layer(DIM, 2, NUM_TOKENS);
+    KVCache* cache = create_kv_cache_for_layer(layer, window);
+    assert(layer != NULL && cache != NULL);
+
+    float got[DIM], expected[DIM];
+    for(int t = 0; t < NUM_TOKENS; t++) {
+        self_attention_decode_step(layer, cache, tokens[t], got);
+        reference_last_row(layer, t >= window ? t - window + 1 : 0, t, expected);
+        assert_row_close(got, expected);
+    }
+
+    // A prompt longer than the ring falls back to single steps
+    float prefill_out[6][DIM];
+    kv_cache_reset(cache);
+    self_attention_prefill(layer, cache, &tokens[0][0], &prefill_out[0][0], 6);
+    for(int i = 0; i < 6; i++) {
+        reference_last_row(layer, i >= window ? i - window + 1 : 0, i, expected);
+        assert_row_close(prefill_out[i], expected);
+    }
+
+    free_kv_cache(cache);
+    free_self_attention_layer(layer);
+
+    printf("Sliding window test passed\n");
+}
+
+int main() {
+    printf("Starting KV cache tests...\n\n");
+
+    srand(42);
+    for(int t = 0; t < NUM_TOKENS; t++) {
+        for(int j = 0; j < DIM; j++) {
+            tokens[t][j] = ((float)rand() / (float)RAND_MAX) - 0.5f;
+        }
+    }
+
+    test_kv_cache_ring();
+    test_decode_matches_recompute(1);
+    test_decode_matches_recompute(4);
+    test_prefill_then_decode();
+    test_sliding_window();
+
+    printf("\nAll KV cache tests passed successfully!\n");
+    return 0;
+}
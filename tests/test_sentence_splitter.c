@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../include/Data_Loading_Cleaning.h"
+
+// Random text of letters and spaces with sentence delimiters at about the given rate (in %)
+static char* random_text(size_t size, int delimiter_rate, unsigned int seed) {
+    char* text = malloc(size + 1);
+    srand(seed);
+    for (size_t i = 0; i < size; i++) {
+        int r = rand() % 100;
+        text[i] = (r < delimiter_rate) ? ".!?"[rand() % 3] : (r < 20) ? ' ' : (char)('a' + r % 26);
+    }
+    text[size] = '\0';
+    return text;
+}
+
+// Check spans against strtok on a copy of the text, for several thread counts
+static void check_spans(const char* text) {
+    size_t size = strlen(text);
+    char* copy = strdup(text);
+    char** expected = malloc((size + 1) * sizeof(char*));
+    size_t num_expected = 0;
+    for (char* token = strtok(copy, ".!?"); token != NULL; token = strtok(NULL, ".!?")) {
+        expected[num_expected++] = token;
+    }
+
+    int thread_counts[4] = {1, 2, 3, 8};
+    for (int t = 0; t < 4; t++) {
+        size_t count = 0;
+        SentenceSpan* spans = SplitSentenceSpans(text, size, &count, thread_counts[t]);
+        assert(spans != NULL && count == num_expected);
+        for (size_t i = 0; i < count; i++) {
+            assert(spans[i].offset == (size_t)(expected[i] - copy));
+            assert(spans[i].length == strlen(expected[i]));
+        }
+        free(spans);
+    }
+
+    free(expected);
+    free(copy);
+}
+
+// Test the iterator and range alignment on small inputs
+void test_iterator() {
+    printf("Testing sentence iterator...\n");
+
+    const char* text = "..Hi there! How are you?? Fine. end";
+    size_t size = strlen(text);
+    size_t cursor = 0;
+    SentenceSpan span;
+    const char* expected[] = {"Hi there", " How are you", " Fine", " end"};
+
+    for (int i = 0; i < 4; i++) {
+        assert(nextSentenceSpan(text, size, &cursor, &span));
+        assert(span.length == strlen(expected[i]) && memcmp(text + span.offset, expected[i], span.length) == 0);
+    }
+    assert(!nextSentenceSpan(text, size, &cursor, &span) && cursor == size);
+
+    // A position inside a sentence moves to the start of the next one
+    assert(alignSentenceStart(text, size, 0) == 0);
+    assert(alignSentenceStart(text, size, 4) == 11);
+    assert(alignSentenceStart(text, size, 11) == 11);
+    assert(alignSentenceStart(text, size, size - 1) == size);
+
+    size_t count = 1;
+    SentenceSpan* spans = SplitSentenceSpans("", 0, &count, 1);
+    assert(spans != NULL && count == 0);
+    free(spans);
+
+    printf("Sentence iterator test passed\n");
+}
+
+// Test that spans match strtok whatever the text and the number of ranges
+void test_spans_match_strtok() {
+    printf("Testing sentence spans against strtok...\n");
+
+    for (int rate = 0; rate <= 10; rate += 2) {
+        char* text = random_text(100000 + (size_t)rate * 77, rate, (unsigned int)rate + 1);
+        check_spans(text);
+        free(text);
+    }
+    check_spans("no delimiter at all");
+    check_spans("?!.");
+
+    printf("Sentence spans test passed\n");
+}
+
+// Test that SplitSentences keeps every sentence and leaves its input alone
+void test_split_sentences_unbounded() {
+    printf("Testing SplitSentences without a sentence limit...\n");
+
+    char* text = random_text(50000, 3, 9);
+    char* original = strdup(text);
+    size_t count = 0;
+    SentenceSpan* spans = SplitSentenceSpans(text, strlen(text), &count, 1);
+    assert(count > 1000);
+
+    char** sentences = SplitSentences(text);
+    assert(sentences != NULL);
+    size_t i = 0;
+    for (; sentences[i] != NULL; i++) {
+        assert(strlen(sentences[i]) == spans[i].length);
+        assert(memcmp(sentences[i], text + spans[i].offset, spans[i].length) == 0);
+        free(sentences[i]);
+    }
+    assert(i == count);
+    assert(strcmp(text, original) == 0);
+
+    free(sentences);
+    free(spans);
+    free(original);
+    free(text);
+    printf("SplitSentences unbounded test passed\n");
+}
+
+int main() {
+    printf("Starting sentence splitter tests...\n\n");
+
+    test_iterator();
+    test_spans_match_strtok();
+    test_split_sentences_unbounded();
+
+    printf("\nAll sentence splitter tests passed successfully!\n");
+    return 0;
+}
@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
 #include "../include/tokenizer.h"
+#include "../include/Data_Loading_Cleaning.h"
 
 void test_hash_function() {
     printf("Testing hash function...\n");
@@ -67,6 +69,326 @@ void test_sentence_processing() {
     printf("\n");
 }
 
+void test_single_probe_extraction() {
+    printf("Testing single-probe vocabulary extraction...\n");
+
+    char* sentences[] = { "alpha,beta;;alpha gamma-", "  beta delta!", "", NULL };
+    unsigned int before = vocabulary->count;
+
+    srand(3);
+    extractUniqueWords(sentences);
+    assert(vocabulary->count == before + 4);
+    assert(global_token == (int)vocabulary->count + 1);
+
+    // Ids follow first appearance and embeddings come from rand() in that order
+    const char* expected_order[4] = { "alpha", "beta", "gamma", "delta" };
+    srand(3);
+    for (int i = 0; i < 4; i++) {
+        unsigned int id = getTokenId(expected_order[i]);
+        assert(id == before + 1 + i);
+        float e0 = generate_random();
+        float e1 = generate_random();
+        assert(getEmbedding(id)[0] == e0 && getEmbedding(id)[1] == e1);
+    }
+
+    // lookupOrInsertWord takes words that are not NUL-terminated
+    int inserted = -1;
+    assert(lookupOrInsertWord("betamax", 4, &inserted) == getTokenId("beta") && inserted == 0);
+
+    printf("Single-probe vocabulary extraction test passed\n\n");
+}
+
+void test_embedding_table() {
+    printf("Testing dense embedding table...\n");
+
+    // Every word in the vocabulary has a row
+    for (unsigned int id = 1; id <= vocabulary->count; id++) {
+        assert(getEmbedding(id) != NULL);
+        assert(getTokenId(vocab_word(vocabulary, id)) == id);
+    }
+
+    // Row 0 is the padding token
+    assert(getEmbedding(0)[0] == 0.0f && getEmbedding(0)[1] == 0.0f);
+
+    float values[TOKEN_EMBEDDING_DIM] = {1.5f, -2.5f};
+    unsigned int id = getTokenId("transformer");
+    assert(id != 0 && setEmbedding(id, values));
+    assert(setEmbedding(0, values) == 0);
+
+    double single[TOKEN_EMBEDDING_DIM];
+    getEmbeddingByTokenId(id, single);
+    assert(single[0] == 1.5 && single[1] == -2.5);
+    getEmbeddingByTokenId(1u << 30, single);
+    assert(single[0] == 0.0 && single[1] == 0.0);
+
+    // Batched gather: padding and unknown IDs give zero rows
+    int ids[4] = {(int)id, 0, 1 << 30, (int)getTokenId("world")};
+    float matrix[4][TOKEN_EMBEDDING_DIM];
+    memset(matrix, 0x7f, sizeof(matrix));
+    gatherEmbeddings(ids, 4, &matrix[0][0]);
+    assert(matrix[0][0] == 1.5f && matrix[0][1] == -2.5f);
+    assert(matrix[1][0] == 0.0f && matrix[1][1] == 0.0f);
+    assert(matrix[2][0] == 0.0f && matrix[2][1] == 0.0f);
+    assert(memcmp(matrix[3], getEmbedding(ids[3]), sizeof(matrix[3])) == 0);
+
+    // Round trip through a mapped checkpoint
+    CheckpointTensor tensor;
+    assert(embeddingTableCheckpointTensor("embedding.table", &tensor));
+    assert(checkpoint_save("test_tokenizer.ckpt", &tensor, 1));
+    Checkpoint* ckpt = checkpoint_map("test_tokenizer.ckpt", CHECKPOINT_MAP_WRITABLE);
+    assert(ckpt != NULL);
+    assert(bindEmbeddingTableToCheckpoint(ckpt, "embedding.table"));
+    assert(embedding_table == checkpoint_find(ckpt, "embedding.table")->data);
+    assert(getEmbedding(id)[1] == -2.5f);
+
+    // Growing a bound table copies it out of the checkpoint
+    insertWord("unmapped");
+    assert(embedding_table != checkpoint_find(ckpt, "embedding.table")->data);
+    assert(getEmbedding(id)[0] == 1.5f);
+    assert(getEmbedding(getTokenId("unmapped")) != NULL);
+
+    free_checkpoint(ckpt);
+    remove("test_tokenizer.ckpt");
+    printf("Dense embedding table test passed\n\n");
+}
+
+// Snapshot of the vocabulary built from the generated corpus
+typedef struct {
+    unsigned int count;
+    char** words;
+    float* embeddings;
+    unsigned long* counts;
+} VocabularySnapshot;
+
+static VocabularySnapshot snapshot_vocabulary(void) {
+    VocabularySnapshot snap;
+    snap.count = vocabulary->count;
+    snap.words = malloc((snap.count + 1) * sizeof(char*));
+    snap.embeddings = malloc((snap.count + 1) * TOKEN_EMBEDDING_DIM * sizeof(float));
+    snap.counts = malloc((snap.count + 1) * sizeof(unsigned long));
+    for (unsigned int id = 1; id <= snap.count; id++) {
+        snap.words[id] = strdup(vocab_word(vocabulary, id));
+        memcpy(snap.embeddings + id * TOKEN_EMBEDDING_DIM, getEmbedding(id), TOKEN_EMBEDDING_DIM * sizeof(float));
+        snap.counts[id] = getTokenCount(id);
+    }
+    return snap;
+}
+
+void test_parallel_extraction() {
+    printf("Testing parallel vocabulary extraction...\n");
+
+    // Sentences of random short words, so shards share some words and not others
+    const int num_sentences = 3000;
+    char** sentences = malloc((num_sentences + 1) * sizeof(char*));
+    srand(5);
+    for (int i = 0; i < num_sentences; i++) {
+        sentences[i] = malloc(256);
+        int pos = 0;
+        int words = 1 + rand() % 20;
+        for (int w = 0; w < words; w++) {
+            int length = 1 + rand() % 3;
+            for (int c = 0; c < length; c++) sentences[i][pos++] = (char)('a' + rand() % 8);
+            sentences[i][pos++] = (w % 5 == 4) ? ',' : ' ';
+        }
+        sentences[i][pos] = '\0';
+    }
+    sentences[num_sentences] = NULL;
+
+    freeVocabulary();
+    freeEmbeddingTable();
+    srand(11);
+    extractUniqueWords(sentences);
+    VocabularySnapshot serial = snapshot_vocabulary();
+    assert(serial.count > 100);
+
+    int thread_counts[4] = {1, 2, 3, 8};
+    for (int t = 0; t < 4; t++) {
+        freeVocabulary();
+        freeEmbeddingTable();
+        srand(11);
+        assert(extractUniqueWordsParallel(sentences, thread_counts[t]));
+
+        // Same ids, words, embeddings and counts whatever the thread count
+        assert(vocabulary->count == serial.count);
+        for (unsigned int id = 1; id <= serial.count; id++) {
+            assert(strcmp(vocab_word(vocabulary, id), serial.words[id]) == 0);
+            assert(memcmp(getEmbedding(id), serial.embeddings + id * TOKEN_EMBEDDING_DIM,
+                          TOKEN_EMBEDDING_DIM * sizeof(float)) == 0);
+            assert(getTokenCount(id) == serial.counts[id]);
+        }
+    }
+
+    for (unsigned int id = 1; id <= serial.count; id++) free(serial.words[id]);
+    free(serial.words);
+    free(serial.embeddings);
+    free(serial.counts);
+    for (int i = 0; i < num_sentences; i++) free(sentences[i]);
+    free(sentences);
+    printf("Parallel vocabulary extraction test passed\n\n");
+}
+
+// Test that a tokenizer snapshot restores ids, embeddings and counts exactly
+void test_tokenizer_snapshot() {
+    printf("Testing tokenizer snapshot...\n");
+
+    char* sentences[] = {"the cat sat on the mat", "a dog, the cat; and a bird!", NULL};
+    freeVocabulary();
+    freeEmbeddingTable();
+    extractUniqueWords(sentences);
+    VocabularySnapshot saved = snapshot_vocabulary();
+    assert(saveTokenizerSnapshot("test_tokenizer.snapshot"));
+
+    // Different state in memory, then replaced by the snapshot
+    freeVocabulary();
+    freeEmbeddingTable();
+    insertWord("unrelated");
+    assert(loadTokenizerSnapshot("test_tokenizer.snapshot"));
+    assert(vocabulary->count == saved.count && global_token == (int)saved.count + 1);
+    assert(!vocabulary->owns_memory);
+    for (unsigned int id = 1; id <= saved.count; id++) {
+        assert(getTokenId(saved.words[id]) == id);
+        assert(memcmp(getEmbedding(id), saved.embeddings + id * TOKEN_EMBEDDING_DIM,
+                      TOKEN_EMBEDDING_DIM * sizeof(float)) == 0);
+        assert(getTokenCount(id) == saved.counts[id]);
+    }
+    assert(getTokenId("unrelated") == 0);
+
+    // Saving over the mapped snapshot is safe, and new words still get new ids
+    assert(saveTokenizerSnapshot("test_tokenizer.snapshot"));
+    assert(getTokenId("cat") == 2);
+    insertWord("zebra");
+    assert(getTokenId("zebra") == saved.count + 1 && getEmbedding(saved.count + 1) != NULL);
+    assert(getTokenId("mat") > 0 && getTokenCount(getTokenId("the")) == saved.counts[1]);
+
+    // A missing file keeps the current state
+    assert(!loadTokenizerSnapshot("missing.snapshot"));
+    assert(getTokenId("zebra") == saved.count + 1);
+
+    // So does a snapshot whose embedding table has the wrong dtype or width
+    Checkpoint* good = checkpoint_load("test_tokenizer.snapshot");
+    assert(good != NULL);
+    CheckpointTensor* tensors = (CheckpointTensor*)malloc(good->num_tensors * sizeof(CheckpointTensor));
+    memcpy(tensors, good->tensors, good->num_tensors * sizeof(CheckpointTensor));
+    CheckpointTensor* table = NULL;
+    for (int i = 0; i < good->num_tensors; i++) {
+        if (strcmp(tensors[i].name, "tokenizer.embeddings") == 0) table = &tensors[i];
+    }
+    assert(table != NULL);
+    double* wide = (double*)calloc(table->shape[0] * (TOKEN_EMBEDDING_DIM + 1), sizeof(double));
+    long f64_shape[2] = { table->shape[0], TOKEN_EMBEDDING_DIM };
+    long wide_shape[2] = { table->shape[0], TOKEN_EMBEDDING_DIM + 1 };
+    long ids_before = global_token;
+
+    assert(checkpoint_tensor_init(table, "tokenizer.embeddings", CHECKPOINT_F64, 2, f64_shape, wide));
+    assert(checkpoint_save("bad_tokenizer.snapshot", tensors, good->num_tensors));
+    assert(!loadTokenizerSnapshot("bad_tokenizer.snapshot"));
+    assert(global_token == ids_before && getTokenId("zebra") == saved.count + 1 && getEmbedding(1) != NULL);
+
+    assert(checkpoint_tensor_init(table, "tokenizer.embeddings", CHECKPOINT_F32, 2, wide_shape, wide));
+    assert(checkpoint_save("bad_tokenizer.snapshot", tensors, good->num_tensors));
+    assert(!loadTokenizerSnapshot("bad_tokenizer.snapshot"));
+    assert(global_token == ids_before && getTokenId("zebra") == saved.count + 1 && getEmbedding(1) != NULL);
+
+    free(wide);
+    free(tensors);
+    free_checkpoint(good);
+    remove("bad_tokenizer.snapshot");
+
+    for (unsigned int id = 1; id <= saved.count; id++) free(saved.words[id]);
+    free(saved.words);
+    free(saved.embeddings);
+    free(saved.counts);
+    freeVocabulary();
+    freeEmbeddingTable();
+    remove("test_tokenizer.snapshot");
+    printf("Tokenizer snapshot test passed\n\n");
+}
+
+// Test that the one-pass pipeline gives what split + clean + extract + lookup give
+void test_fused_pipeline() {
+    printf("Testing fused tokenization pipeline...\n");
+
+    // Random text with capitals, digits, punctuation, newlines and non-ASCII bytes
+    const char* alphabet = "abcdefgh ABCD 0189  ,;'-()\n\t.!?\xc3\xa9";
+    size_t size = 20000;
+    char* text = malloc(size + 1);
+    srand(17);
+    for (size_t i = 0; i < size; i++) text[i] = alphabet[rand() % strlen(alphabet)];
+    text[size] = '\0';
+
+    // Reference: SplitSentences, Cleaned_Text, extractUniqueWords, then getTokenId per word
+    freeVocabulary();
+    freeEmbeddingTable();
+    char** sentences = SplitSentences(text);
+    int num_sentences = 0;
+    for (; sentences[num_sentences] != NULL; num_sentences++) {
+        cleanTextInPlace(sentences[num_sentences], CLEAN_TEXT_ASCII);
+    }
+    srand(23);
+    extractUniqueWords(sentences);
+    VocabularySnapshot expected = snapshot_vocabulary();
+
+    // One pass over the raw text builds the same vocabulary
+    freeVocabulary();
+    freeEmbeddingTable();
+    srand(23);
+    TokenizedCorpus* corpus = createTokenizedCorpus();
+    assert(tokenizeText(corpus, text, size, TOKENIZE_ADD_WORDS));
+    assert(vocabulary->count == expected.count);
+    for (unsigned int id = 1; id <= expected.count; id++) {
+        assert(strcmp(vocab_word(vocabulary, id), expected.words[id]) == 0);
+        assert(memcmp(getEmbedding(id), expected.embeddings + id * TOKEN_EMBEDDING_DIM,
+                      TOKEN_EMBEDDING_DIM * sizeof(float)) == 0);
+        assert(getTokenCount(id) == expected.counts[id]);
+    }
+
+    // And the same ids, sentence by sentence
+    assert(corpus->num_sentences == (size_t)num_sentences);
+    for (int s = 0; s < num_sentences; s++) {
+        const char* p = sentences[s];
+        const char* word;
+        size_t length, position = corpus->sentence_starts[s];
+        while ((length = nextWord(&p, &word)) > 0) {
+            assert(position < corpus->sentence_starts[s + 1]);
+            assert(corpus->ids[position++] == vocab_find(vocabulary, word, length));
+        }
+        assert(position == corpus->sentence_starts[s + 1]);
+    }
+
+    // Tokenizing sentence spans one call at a time, without adding words, appends the same ids
+    size_t num_spans = 0;
+    SentenceSpan* spans = SplitSentenceSpans(text, size, &num_spans, 1);
+    TokenizedCorpus* streamed = createTokenizedCorpus();
+    for (size_t s = 0; s < num_spans; s++) {
+        assert(tokenizeText(streamed, text + spans[s].offset, spans[s].length, 0));
+    }
+    assert(streamed->num_sentences == corpus->num_sentences && streamed->num_ids == corpus->num_ids);
+    assert(memcmp(streamed->ids, corpus->ids, corpus->num_ids * sizeof(uint32_t)) == 0);
+    assert(memcmp(streamed->sentence_starts, corpus->sentence_starts,
+                  (corpus->num_sentences + 1) * sizeof(size_t)) == 0);
+
+    // Unknown words map to 0 without being added
+    TokenizedCorpus* unknown = createTokenizedCorpus();
+    assert(tokenizeText(unknown, "Zzz qqq", 7, 0));
+    assert(unknown->num_sentences == 1 && unknown->num_ids == 2 && unknown->ids[0] == 0 && unknown->ids[1] == 0);
+    assert(vocabulary->count == expected.count);
+
+    freeTokenizedCorpus(unknown);
+    freeTokenizedCorpus(streamed);
+    freeTokenizedCorpus(corpus);
+    free(spans);
+    for (unsigned int id = 1; id <= expected.count; id++) free(expected.words[id]);
+    free(expected.words);
+    free(expected.embeddings);
+    free(expected.counts);
+    for (int s = 0; s < num_sentences; s++) free(sentences[s]);
+    free(sentences);
+    free(text);
+    freeVocabulary();
+    freeEmbeddingTable();
+    printf("Fused tokenization pipeline test passed\n\n");
+}
+
 int main() {
     printf("Starting tokenizer tests...\n\n");
     
@@ -77,6 +399,11 @@ int main() {
     test_word_insertion();
     test_embedding_generation();
     test_sentence_processing();
+    test_single_probe_extraction();
+    test_embedding_table();
+    test_parallel_extraction();
+    test_tokenizer_snapshot();
+    test_fused_pipeline();
     
     printf("All tokenizer tests completed.\n");
     return 0;
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../include/vocab.h"
+
+#define NUM_WORDS 50000
+
+// Test ids, round trips and lookups of words that are not NUL-terminated
+void test_lookup_or_insert() {
+    printf("Testing vocab lookup-or-insert...\n");
+
+    Vocab* vocab = create_vocab(0);
+    assert(vocab != NULL);
+
+    int inserted = -1;
+    assert(vocab_lookup_or_insert(vocab, "hello", 5, &inserted) == 1 && inserted == 1);
+    assert(vocab_lookup_or_insert(vocab, "world", 5, &inserted) == 2 && inserted == 1);
+    assert(vocab_lookup_or_insert(vocab, "hello", 5, &inserted) == 1 && inserted == 0);
+    assert(vocab->count == 2);
+
+    // Case sensitive, and prefixes are different words
+    assert(vocab_find(vocab, "Hello", 5) == 0);
+    assert(vocab_find(vocab, "hell", 4) == 0);
+    assert(vocab_find(vocab, "hello world", 5) == 1);
+    assert(vocab_find(vocab, "world", 5) == 2);
+
+    assert(strcmp(vocab_word(vocab, 2), "world") == 0);
+    assert(vocab_word_length(vocab, 1) == 5);
+    assert(vocab_word(vocab, 0) == NULL && vocab_word(vocab, 3) == NULL);
+
+    free_vocab(vocab);
+    printf("Vocab lookup-or-insert test passed\n");
+}
+
+// Test that ids survive many resizes and every word is still found
+void test_growth() {
+    printf("Testing vocab growth...\n");
+
+    Vocab* vocab = create_vocab(4);
+    char word[32];
+    uint32_t first_capacity = vocab->capacity;
+
+    for (int i = 0; i < NUM_WORDS; i++) {
+        int length = snprintf(word, sizeof(word), "w%dx%d", i, i * 7);
+        assert(vocab_lookup_or_insert(vocab, word, length, NULL) == (uint32_t)i + 1);
+    }
+    assert(vocab->count == NUM_WORDS && vocab->capacity > first_capacity);
+    assert((uint64_t)vocab->count * VOCAB_MAX_LOAD_DEN <= (uint64_t)vocab->capacity * VOCAB_MAX_LOAD_NUM);
+
+    for (int i = NUM_WORDS - 1; i >= 0; i--) {
+        int length = snprintf(word, sizeof(word), "w%dx%d", i, i * 7);
+        assert(vocab_find(vocab, word, length) == (uint32_t)i + 1);
+        assert(strcmp(vocab_word(vocab, i + 1), word) == 0);
+        assert(vocab_word_length(vocab, i + 1) == (size_t)length);
+    }
+    assert(vocab_find(vocab, "w-1x0", 5) == 0);
+
+    free_vocab(vocab);
+    printf("Vocab growth test passed\n");
+}
+
+// Test that a vocabulary saved to a checkpoint is used in place and copied out on insert
+void test_checkpoint_round_trip() {
+    printf("Testing vocab checkpoint round trip...\n");
+
+    Vocab* vocab = create_vocab(0);
+    char word[32];
+    for (int i = 0; i < 1000; i++) {
+        int length = snprintf(word, sizeof(word), "tok%d", i * 13);
+        vocab_lookup_or_insert(vocab, word, length, NULL);
+    }
+
+    CheckpointTensor tensors[VOCAB_CHECKPOINT_TENSORS];
+    assert(vocab_checkpoint_tensors(vocab, "vocab", tensors) == VOCAB_CHECKPOINT_TENSORS);
+    assert(checkpoint_save("test_vocab.ckpt", tensors, VOCAB_CHECKPOINT_TENSORS));
+
+    Checkpoint* checkpoint = checkpoint_map("test_vocab.ckpt", CHECKPOINT_MAP_DEFAULT);
+    assert(checkpoint != NULL);
+    Vocab* loaded = create_vocab_from_checkpoint(checkpoint, "vocab");
+    assert(loaded != NULL && !loaded->owns_memory);
+    assert(loaded->count == vocab->count && loaded->capacity == vocab->capacity);
+    assert(loaded->slots == checkpoint_find(checkpoint, "vocab.slots")->data);
+
+    for (int i = 0; i < 1000; i++) {
+        int length = snprintf(word, sizeof(word), "tok%d", i * 13);
+        assert(vocab_find(loaded, word, length) == (uint32_t)i + 1);
+        assert(strcmp(vocab_word(loaded, i + 1), word) == 0);
+    }
+
+    // The first insertion copies the read-only mapping out before writing
+    assert(vocab_lookup_or_insert(loaded, "new", 3, NULL) == 1001);
+    assert(loaded->owns_memory);
+    assert(vocab_find(loaded, "tok13", 5) == 2 && vocab_find(loaded, "new", 3) == 1001);
+    free_vocab(loaded);
+
+    // A slot that points outside the arena, at the wrong word or at a bad id is rejected
+    CheckpointTensor* slots = (CheckpointTensor*)checkpoint_find(checkpoint, "vocab.slots");
+    const void* mapped_slots = slots->data;
+    VocabSlot* copy = (VocabSlot*)malloc(slots->nbytes);
+    uint32_t first = 0;
+    while (((const VocabSlot*)mapped_slots)[first].hash == 0) first++;
+    for (int c = 0; c < 6; c++) {
+        memcpy(copy, mapped_slots, slots->nbytes);
+        VocabSlot* s = &copy[first];
+        if (c == 0) s->offset = 0xfffffff0u;
+        if (c == 1) s->length = 0x7fffffffu;
+        if (c == 2) s->length += 1;
+        if (c == 3) s->token_id = vocab->count + 1;
+        if (c == 4) s->token_id = s->token_id == 1 ? 2 : 1;
+        if (c == 5) s->hash = 0;
+        slots->data = copy;
+        assert(create_vocab_from_checkpoint(checkpoint, "vocab") == NULL);
+    }
+    slots->data = (void*)mapped_slots;
+    free(copy);
+
+    // A snapshot written by a different hash function is rejected
+    uint32_t bad_meta[2] = { VOCAB_HASH_VERSION + 1, sizeof(VocabSlot) };
+    CheckpointTensor* meta = (CheckpointTensor*)checkpoint_find(checkpoint, "vocab.meta");
+    meta->data = bad_meta;
+    assert(create_vocab_from_checkpoint(checkpoint, "vocab") == NULL);
+
+    free_checkpoint(checkpoint);
+    free_vocab(vocab);
+    remove("test_vocab.ckpt");
+    printf("Vocab checkpoint round trip test passed\n");
+}
+
+int main() {
+    printf("Starting vocab tests...\n\n");
+
+    test_lookup_or_insert();
+    test_growth();
+    test_checkpoint_round_trip();
+
+    printf("\nAll vocab tests passed successfully!\n");
+    return 0;
+}
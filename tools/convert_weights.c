@@ -0,0 +1,155 @@
+// Converts the one-value-per-file text weight directories into a single
+// binary checkpoint (see include/checkpoint.h).
+//
+// Build and run from the repository root:
+//   gcc -O2 -o convert_weights tools/convert_weights.c src/checkpoint.c
+//   ./convert_weights                      # converts the default directories
+//   ./convert_weights -o model.ckpt name=dir/prefix[:rows] [...]
+//
+// A spec name=dir/prefix reads dir/prefix1.txt, dir/prefix2.txt, ... until the
+// next file is missing and stores the values as an F64 tensor called name,
+// value k at index k - 1 (the layout read_weights() fills). With :rows the
+// tensor is 2-D (rows x count / rows, row-major), otherwise 1-D.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/checkpoint.h"
+
+#define DEFAULT_OUTPUT "Model_Trained_Weights/model.ckpt"
+#define MAX_TENSORS 32
+
+// One tensor to convert
+typedef struct {
+    const char* name;
+    const char* dir;
+    const char* prefix;
+    long rows;          // 0 for a 1-D tensor
+} TensorSpec;
+
+// The weights the example program loads (see initialize_matrices_from_files and read_weights)
+static const TensorSpec default_specs[] = {
+    {"attention.key",      "Model Trained Weights/self-attention-block-weights", "key_weight_",   2},
+    {"attention.query",    "Model Trained Weights/self-attention-block-weights", "query_weight_", 2},
+    {"attention.value",    "Model Trained Weights/self-attention-block-weights", "value_weight_", 2},
+    {"semi_final.weights", "Model_Trained_Weights/Semi_Final_Weights",           "weight_",       0},
+    {"final.weights",      "Model_Trained_Weights/Final_Weights",                "weight_",       0},
+};
+
+// FUNCTION TO READ dir/prefix1.txt, dir/prefix2.txt, ... INTO A GROWING ARRAY
+static double* read_value_series(const char* dir, const char* prefix, long* count) {
+    size_t capacity = 1024;
+    double* values = (double*)malloc(capacity * sizeof(double));
+    char file_name[512];
+    *count = 0;
+
+    while (values != NULL) {
+        snprintf(file_name, sizeof(file_name), "%s/%s%ld.txt", dir, prefix, *count + 1);
+        FILE* file = fopen(file_name, "r");
+        if (file == NULL) break;
+
+        double value;
+        int ok = fscanf(file, "%lf", &value) == 1;
+        fclose(file);
+        if (!ok) {
+            fprintf(stderr, "Error reading weight from file %s\n", file_name);
+            free(values);
+            return NULL;
+        }
+
+        if ((size_t)*count == capacity) {
+            capacity *= 2;
+            double* grown = (double*)realloc(values, capacity * sizeof(double));
+            if (grown == NULL) {
+                free(values);
+                return NULL;
+            }
+            values = grown;
+        }
+        values[(*count)++] = value;
+    }
+    return values;
+}
+
+int main(int argc, char** argv) {
+    const char* output = DEFAULT_OUTPUT;
+    TensorSpec specs[MAX_TENSORS];
+    char spec_storage[MAX_TENSORS][512];
+    int num_specs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+            continue;
+        }
+        // name=dir/prefix[:rows]
+        char* s = spec_storage[num_specs];
+        char* eq = strchr(argv[i], '=');
+        if (eq == NULL || num_specs == MAX_TENSORS || strlen(argv[i]) >= sizeof(spec_storage[0])) {
+            fprintf(stderr, "usage: %s [-o output] [name=dir/prefix[:rows] ...]\n", argv[0]);
+            return 1;
+        }
+        strcpy(s, argv[i]);
+        char* path = s + (eq - argv[i]) + 1;
+        path[-1] = '\0';
+
+        TensorSpec* spec = &specs[num_specs++];
+        spec->name = s;
+        spec->rows = 0;
+        char* colon = strrchr(path, ':');
+        if (colon != NULL) {
+            *colon = '\0';
+            spec->rows = strtol(colon + 1, NULL, 10);
+        }
+        char* slash = strrchr(path, '/');
+        if (slash != NULL) {
+            *slash = '\0';
+            spec->dir = path;
+            spec->prefix = slash + 1;
+        } else {
+            spec->dir = ".";
+            spec->prefix = path;
+        }
+    }
+    if (num_specs == 0) {
+        num_specs = sizeof(default_specs) / sizeof(default_specs[0]);
+        memcpy(specs, default_specs, sizeof(default_specs));
+    }
+
+    CheckpointTensor tensors[MAX_TENSORS];
+    int num_tensors = 0;
+    for (int i = 0; i < num_specs; i++) {
+        long count = 0;
+        double* values = read_value_series(specs[i].dir, specs[i].prefix, &count);
+        if (values == NULL) return 1;
+        if (count == 0) {
+            printf("skipping %s: no %s/%s*.txt files\n", specs[i].name, specs[i].dir, specs[i].prefix);
+            free(values);
+            continue;
+        }
+
+        long shape[2] = { count, 1 };
+        int ndim = 1;
+        if (specs[i].rows > 0 && count % specs[i].rows == 0) {
+            shape[0] = specs[i].rows;
+            shape[1] = count / specs[i].rows;
+            ndim = 2;
+        }
+        if (!checkpoint_tensor_init(&tensors[num_tensors], specs[i].name, CHECKPOINT_F64, ndim, shape, values)) {
+            fprintf(stderr, "invalid tensor name %s\n", specs[i].name);
+            return 1;
+        }
+        printf("%-20s %8ld values from %s/%s*.txt\n", specs[i].name, count, specs[i].dir, specs[i].prefix);
+        num_tensors++;
+    }
+
+    int ok = checkpoint_save(output, tensors, num_tensors);
+    for (int i = 0; i < num_tensors; i++) {
+        free(tensors[i].data);
+    }
+    if (!ok) return 1;
+
+    printf("wrote %d tensors to %s\n", num_tensors, output);
+    return 0;
+}
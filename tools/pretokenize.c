@@ -0,0 +1,104 @@
+// Tokenizes text corpora once, offline, into a binary dataset (see
+// include/dataset.h) that training and evaluation jobs memory-map instead of
+// re-reading, re-cleaning and re-tokenizing the text on every run.
+//
+// Build and run from the repository root:
+//   gcc -O2 -o pretokenize tools/pretokenize.c src/*.c -lm -fopenmp
+//   ./pretokenize                                   # test_data.txt -> the default paths
+//   ./pretokenize -o train.dataset -v tokenizer.snapshot corpus1.txt [corpus2.txt ...]
+//
+// When the tokenizer snapshot (-v) exists its vocabulary is used as is and
+// unknown words become token 0; otherwise the vocabulary is built from the
+// corpora and saved there, so the dataset and the snapshot always match.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/Data_Loading_Cleaning.h"
+#include "../include/tokenizer.h"
+#include "../include/dataset.h"
+
+#define DEFAULT_CORPUS "test_data.txt"
+#define DEFAULT_OUTPUT "Model_Trained_Weights/train.dataset"
+#define DEFAULT_SNAPSHOT "Model_Trained_Weights/tokenizer.snapshot"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// FUNCTION TO STREAM ONE CORPUS FILE INTO THE TOKENIZED CORPUS
+static int tokenize_file(const char* path, TokenizedCorpus* corpus, int flags, unsigned long long* bytes) {
+    CorpusReader* reader = openCorpusReader(path, 0);
+    if (reader == NULL) return 0;
+
+    char* sentence;
+    size_t length;
+    int ok = 1;
+    while (ok && (sentence = nextCorpusSentence(reader, &length)) != NULL) {
+        ok = tokenizeText(corpus, sentence, length, flags);
+    }
+    ok = ok && !reader->error;
+    *bytes += reader->bytes_read;
+    closeCorpusReader(reader);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const char* output = DEFAULT_OUTPUT;
+    const char* snapshot = DEFAULT_SNAPSHOT;
+    const char* corpora[256];
+    int num_corpora = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
+            snapshot = argv[++i];
+        } else if (argv[i][0] == '-' || num_corpora == 256) {
+            fprintf(stderr, "Usage: %s [-o dataset] [-v tokenizer.snapshot] [corpus.txt ...]\n", argv[0]);
+            return 1;
+        } else {
+            corpora[num_corpora++] = argv[i];
+        }
+    }
+    if (num_corpora == 0) corpora[num_corpora++] = DEFAULT_CORPUS;
+
+    double start = now_seconds();
+    int snapshot_loaded = loadTokenizerSnapshot(snapshot);
+    TokenizedCorpus* corpus = createTokenizedCorpus();
+    if (corpus == NULL) return 1;
+
+    unsigned long long bytes = 0;
+    for (int c = 0; c < num_corpora; c++) {
+        if (!tokenize_file(corpora[c], corpus, snapshot_loaded ? 0 : TOKENIZE_ADD_WORDS, &bytes)) {
+            fprintf(stderr, "Error tokenizing %s\n", corpora[c]);
+            freeTokenizedCorpus(corpus);
+            return 1;
+        }
+    }
+
+    if (!snapshot_loaded && !saveTokenizerSnapshot(snapshot)) {
+        fprintf(stderr, "Error writing the tokenizer snapshot %s\n", snapshot);
+        freeTokenizedCorpus(corpus);
+        return 1;
+    }
+    if (!save_token_dataset(output, corpus, (uint32_t)global_token)) {
+        fprintf(stderr, "Error writing %s\n", output);
+        freeTokenizedCorpus(corpus);
+        return 1;
+    }
+
+    printf("%s %s (%d words)\n", snapshot_loaded ? "used" : "wrote", snapshot, global_token - 1);
+    printf("wrote %s: %zu sentences, %zu tokens as %s from %.1f MB of text in %.2f s\n",
+           output, corpus->num_sentences, corpus->num_ids, global_token <= 65536 ? "uint16" : "uint32",
+           bytes / 1e6, now_seconds() - start);
+
+    freeTokenizedCorpus(corpus);
+    freeVocabulary();
+    freeEmbeddingTable();
+    return 0;
+}